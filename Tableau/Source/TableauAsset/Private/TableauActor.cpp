@@ -1,6 +1,7 @@
 
 #include "TableauActor.h"
 #include "TableauAssetModule.h"
+#include "TableauFoliageSubsystem.h"
 
 
 // Sets default values
@@ -16,6 +17,29 @@ ATableauActor::ATableauActor(const FObjectInitializer& ObjectInitializer)
 
 }
 
+void ATableauActor::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	if (SharedFoliage.Num() > 0)
+	{
+		UpdateSharedFoliage();
+	}
+}
+
+void ATableauActor::PostUnregisterAllComponents()
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (UTableauFoliageSubsystem* FoliageSubsystem = World->GetSubsystem<UTableauFoliageSubsystem>())
+		{
+			FoliageSubsystem->UnregisterActor(this);
+		}
+	}
+
+	Super::PostUnregisterAllComponents();
+}
+
 #if WITH_EDITOR
 bool ATableauActor::GetReferencedContentObjects(TArray< UObject* >& Objects) const
 {
@@ -23,6 +47,29 @@ bool ATableauActor::GetReferencedContentObjects(TArray< UObject* >& Objects) con
 	Objects.Add(TableauComponent->GetTableau());
 	return true;
 }
+
+void ATableauActor::PostEditMove(bool bFinished)
+{
+	Super::PostEditMove(bFinished);
+
+	// Shared instances don't follow the Actor, so hand them over again once the move is complete.
+	if (bFinished && SharedFoliage.Num() > 0)
+	{
+		UpdateSharedFoliage();
+	}
+	else if (bFinished)
+	{
+		// The cached bounds were carried along with the Actor, which loosens them under rotation.
+		TableauComponent->InvalidateBounds();
+	}
+}
+
+void ATableauActor::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	UpdateSharedFoliage();
+}
 #endif
 
 UTableauComponent* ATableauActor::GetTableauComponent() const
@@ -30,10 +77,19 @@ UTableauComponent* ATableauActor::GetTableauComponent() const
 	return TableauComponent; 
 }
 
+void ATableauActor::UpdateSharedFoliage()
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (UTableauFoliageSubsystem* FoliageSubsystem = World->GetSubsystem<UTableauFoliageSubsystem>())
+		{
+			FoliageSubsystem->UpdateActor(this);
+		}
+	}
 
-
-
-
-
-
-
+	// The shared foliage was withdrawn until its cells are updated, which invalidates the bounds again.
+	if (TableauComponent)
+	{
+		TableauComponent->InvalidateBounds();
+	}
+}
@@ -1,6 +1,174 @@
 
 #include "TableauAsset.h"
 
+// Engine Includes
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "FoliageType_InstancedStaticMesh.h"
+#include "Misc/Compression.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/CustomVersion.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+
+// constants
+static const int64 MaxDecompressedConfigBytes = 64 * 1024 * 1024;
+
+namespace
+{
+	struct FTableauAssetCustomVersion
+	{
+		enum Type
+		{
+			BeforeCustomVersionWasAdded = 0,
+			// Config payloads moved from the ConfigTable into bulk data.
+			ConfigBulkData,
+			// Config bulk data stripped from cooked packages.
+			StripConfigBulkData,
+
+			VersionPlusOne,
+			LatestVersion = VersionPlusOne - 1
+		};
+
+		static const FGuid GUID;
+	};
+
+	const FGuid FTableauAssetCustomVersion::GUID(0x5A1C7E42, 0x93B04D2F, 0xA8E6163B, 0x0C7D94F1);
+	FCustomVersionRegistration GRegisterTableauAssetCustomVersion(FTableauAssetCustomVersion::GUID, FTableauAssetCustomVersion::LatestVersion, TEXT("TableauAssetVer"));
+}
+
+#if WITH_EDITOR
+namespace
+{
+	/*
+	* Metrics of one Tableau in the nested structure, along with the leaf sets that must be merged as
+	* they're gathered by the Tableaux referencing it.
+	*/
+	struct FTableauMetricsNode
+	{
+		int32 Depth = 1;
+		int32 TransitiveElementCount = 0;
+		float ExpectedInstanceCount = 0.0f;
+		FBox Bounds = FBox(ForceInit);
+		TSet<FSoftObjectPath> LeafAssets;
+		TSet<FSoftObjectPath> FoliageTypes;
+	};
+
+	/*
+	* Computes the metrics of a Tableau, visiting each nested Tableau once.
+	*/
+	class FTableauMetricsBuilder
+	{
+	public:
+		const FTableauMetricsNode* Build(const UTableauAsset* TableauAsset)
+		{
+			if (const FTableauMetricsNode* Node = Nodes.Find(TableauAsset))
+			{
+				return Node;
+			}
+
+			// A Tableau referencing itself, directly or not, is cut off by the evaluation. It contributes nothing.
+			if (InProgress.Contains(TableauAsset))
+			{
+				return nullptr;
+			}
+			InProgress.Add(TableauAsset);
+
+			FTableauMetricsNode Node;
+			Node.TransitiveElementCount = TableauAsset->TableauElement.Num();
+
+			float TotalWeight = TableauAsset->NothingWeight;
+			for (const FTableauAssetElement& Element : TableauAsset->TableauElement)
+			{
+				TotalWeight += Element.Weight;
+			}
+
+			for (const FTableauAssetElement& Element : TableauAsset->TableauElement)
+			{
+				UObject* Asset = Element.AssetReference.TryLoad();
+				if (Asset == nullptr)
+				{
+					continue;
+				}
+
+				float ElementInstanceCount = 0.0f;
+				FBox ElementBounds(ForceInit);
+
+				if (const UTableauAsset* NestedTableauAsset = Cast<UTableauAsset>(Asset))
+				{
+					const FTableauMetricsNode* NestedNode = Build(NestedTableauAsset);
+					if (NestedNode == nullptr)
+					{
+						continue;
+					}
+
+					Node.Depth = FMath::Max(Node.Depth, NestedNode->Depth + 1);
+					Node.TransitiveElementCount += NestedNode->TransitiveElementCount;
+					Node.LeafAssets.Append(NestedNode->LeafAssets);
+					Node.FoliageTypes.Append(NestedNode->FoliageTypes);
+					ElementInstanceCount = NestedNode->ExpectedInstanceCount;
+					ElementBounds = NestedNode->Bounds;
+				}
+				else
+				{
+					Node.LeafAssets.Add(Element.AssetReference);
+					ElementInstanceCount = 1.0f;
+
+					const UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset);
+					if (const UFoliageType* FoliageType = Cast<UFoliageType>(Asset))
+					{
+						Node.FoliageTypes.Add(Element.AssetReference);
+						if (const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh = Cast<UFoliageType_InstancedStaticMesh>(FoliageType))
+						{
+							StaticMesh = FoliageType_InstancedStaticMesh->GetStaticMesh();
+						}
+					}
+
+					ElementBounds = StaticMesh ? StaticMesh->GetBoundingBox() : FBox(FVector::ZeroVector, FVector::ZeroVector);
+				}
+
+				// Composition elements manifest with the probability of their weight, while Superposition
+				// selects one element in proportion to the weights.
+				const float Probability = (TableauAsset->EvaluationMode == ETableauEvaluationMode::Superposition)
+					? (TotalWeight > 0.0f ? Element.Weight / TotalWeight : 0.0f)
+					: FMath::Clamp(Element.Weight, 0.0f, 1.0f);
+				Node.ExpectedInstanceCount += Probability * ElementInstanceCount;
+
+				if (ElementBounds.IsValid)
+				{
+					Node.Bounds += TransformElementBounds(Element, ElementBounds);
+				}
+			}
+
+			InProgress.Remove(TableauAsset);
+			return &Nodes.Add(TableauAsset, MoveTemp(Node));
+		}
+
+	private:
+		static FBox TransformElementBounds(const FTableauAssetElement& Element, const FBox& Bounds)
+		{
+			FBox JitteredBounds = Bounds;
+
+			// Cover the largest scale jitter and any spin about Z.
+			const float MaxScale = FMath::Max3(Element.MinScaleJitter, Element.MaxScaleJitter, 1.0f);
+			JitteredBounds = FBox(JitteredBounds.Min * MaxScale, JitteredBounds.Max * MaxScale);
+			if (Element.bSpinZAxis)
+			{
+				const float Radius = FMath::Max(FVector2D(JitteredBounds.Min).Size(), FVector2D(JitteredBounds.Max).Size());
+				JitteredBounds = FBox(FVector(-Radius, -Radius, JitteredBounds.Min.Z), FVector(Radius, Radius, JitteredBounds.Max.Z));
+			}
+
+			return JitteredBounds.TransformBy(Element.LocalTransform);
+		}
+
+	private:
+		TMap<const UTableauAsset*, FTableauMetricsNode> Nodes;
+		TSet<const UTableauAsset*> InProgress;
+	};
+}
+#endif
+
 
 FTableauAssetElement::FTableauAssetElement()
 	: bSnapToFloor(true)
@@ -29,6 +197,10 @@ FTableauAssetElement::FTableauAssetElement(const FName InName, const FSoftObject
 }
 
 
+#if WITH_EDITOR
+UTableauAsset::FOnTableauElementsChangingDelegate UTableauAsset::OnTableauElementsChanging;
+#endif
+
 UTableauAsset::UTableauAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, NothingWeight(0.f)
@@ -39,21 +211,271 @@ UTableauAsset::UTableauAsset(const FObjectInitializer& ObjectInitializer)
 void UTableauAsset::AddElement(const FName Name, const FSoftObjectPath& AssetReference, const FString& AssetConfig, const FTransform& LocalTransform, uint32 Seed)
 {
 	FTableauAssetElement NewElement(Name, AssetReference, AssetConfig, LocalTransform, Seed);
+	NotifyElementsChanging();
 	TableauElement.Add(NewElement);
 }
 
 void UTableauAsset::AddElement(const FTableauAssetElement& NewElement)
 {
+	NotifyElementsChanging();
 	TableauElement.Add(NewElement);
+	InternElementConfigs(TableauElement.Num() - 1);
+}
+
+void UTableauAsset::AddElements(TArray<FTableauAssetElement>&& NewElements)
+{
+	const int32 FirstElement = TableauElement.Num();
+
+	NotifyElementsChanging();
+	if (TableauElement.Num() == 0)
+	{
+		TableauElement = MoveTemp(NewElements);
+	}
+	else
+	{
+		TableauElement.Append(MoveTemp(NewElements));
+	}
+
+	InternElementConfigs(FirstElement);
 }
 
 void UTableauAsset::ClearElements()
 {
+	NotifyElementsChanging();
 	TableauElement.Empty();
+	ConfigTable.Empty();
+	ConfigLookup.Empty();
+	DecompressedConfigs.Empty();
+	DecompressedConfigOrder.Empty();
+	DecompressedConfigBytes = 0;
+	ConfigBulkData.RemoveBulkData();
+	PendingConfigPayloads.Empty();
+	++ConfigBulkDataGeneration;
+}
+
+void UTableauAsset::SetElements(TArray<FTableauAssetElement>&& NewElements)
+{
+	NotifyElementsChanging();
+	TableauElement = MoveTemp(NewElements);
+
+	InternElementConfigs(0);
+}
+
+int32 UTableauAsset::AddConfig(const TArray<uint8>& Config, ETableauConfigFormat::Type Format)
+{
+	if (Config.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	// The format is hashed along with the contents, so a text and binary config can't be confused.
+	FSHA1 Sha;
+	const uint8 FormatByte = (uint8)Format;
+	Sha.Update(&FormatByte, 1);
+	Sha.Update(Config.GetData(), Config.Num());
+	Sha.Final();
+	FSHAHash Hash;
+	Sha.GetHash(Hash.Hash);
+	const FString ContentHash = Hash.ToString();
+
+	ValidateConfigLookup(ContentHash);
+	if (const int32* ExistingIndex = ConfigLookup.Find(ContentHash))
+	{
+		return *ExistingIndex;
+	}
+
+	FTableauAssetConfig& Entry = ConfigTable.AddDefaulted_GetRef();
+	Entry.ContentHash = ContentHash;
+	Entry.Format = Format;
+	Entry.UncompressedSize = Config.Num();
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Config.Num());
+	TArray<uint8> CompressedConfig;
+	CompressedConfig.SetNumUninitialized(CompressedSize);
+	if (FCompression::CompressMemory(NAME_Zlib, CompressedConfig.GetData(), CompressedSize, Config.GetData(), Config.Num()) && CompressedSize < Config.Num())
+	{
+		AppendConfigPayload(Entry, CompressedConfig.GetData(), CompressedSize);
+	}
+	else
+	{
+		AppendConfigPayload(Entry, Config.GetData(), Config.Num());
+	}
+
+	const int32 ConfigIndex = ConfigTable.Num() - 1;
+	ConfigLookup.Add(ContentHash, ConfigIndex);
+	return ConfigIndex;
+}
+
+int32 UTableauAsset::FindConfigIndex(const FString& ContentHash) const
+{
+	check(IsInGameThread());
+
+	ValidateConfigLookup(ContentHash);
+	const int32* ConfigIndex = ConfigLookup.Find(ContentHash);
+	return ConfigIndex ? *ConfigIndex : INDEX_NONE;
+}
+
+void UTableauAsset::ValidateConfigLookup(const FString& ContentHash) const
+{
+	const int32* ExistingIndex = ConfigLookup.Find(ContentHash);
+	if (ConfigLookup.Num() == ConfigTable.Num() && (ExistingIndex == nullptr || ConfigTable[*ExistingIndex].ContentHash == ContentHash))
+	{
+		return;
+	}
+
+	ConfigLookup.Empty(ConfigTable.Num());
+	for (int32 Index = 0; Index < ConfigTable.Num(); ++Index)
+	{
+		ConfigLookup.Add(ConfigTable[Index].ContentHash, Index);
+	}
+}
+
+const TArray<uint8>* UTableauAsset::FindConfig(int32 ConfigIndex, ETableauConfigFormat::Type& OutFormat) const
+{
+	check(IsInGameThread());
+
+	if (!ConfigTable.IsValidIndex(ConfigIndex))
+	{
+		return nullptr;
+	}
+
+	const FTableauAssetConfig& Entry = ConfigTable[ConfigIndex];
+	OutFormat = Entry.Format;
+
+	if (const TArray<uint8>* Decompressed = DecompressedConfigs.Find(Entry.ContentHash))
+	{
+		return Decompressed;
+	}
+
+	TArray<uint8> Payload;
+	if (!ReadConfigPayload(Entry, Payload))
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to read captured config %d of %s."), ConfigIndex, *GetName());
+		return nullptr;
+	}
+
+	TArray<uint8> Config;
+	if (Payload.Num() == Entry.UncompressedSize)
+	{
+		Config = MoveTemp(Payload);
+	}
+	else
+	{
+		Config.SetNumUninitialized(Entry.UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, Config.GetData(), Config.Num(), Payload.GetData(), Payload.Num()))
+		{
+			UE_LOG(LogTableau, Error, TEXT("Unable to decompress captured config %d of %s."), ConfigIndex, *GetName());
+			return nullptr;
+		}
+	}
+
+	// Evict the oldest configs once over budget, always keeping the one about to be returned.
+	while (DecompressedConfigOrder.Num() > 0 && DecompressedConfigBytes + Config.Num() > MaxDecompressedConfigBytes)
+	{
+		if (const TArray<uint8>* Evicted = DecompressedConfigs.Find(DecompressedConfigOrder[0]))
+		{
+			DecompressedConfigBytes -= Evicted->Num();
+		}
+		DecompressedConfigs.Remove(DecompressedConfigOrder[0]);
+		DecompressedConfigOrder.RemoveAt(0);
+	}
+
+	DecompressedConfigBytes += Config.Num();
+	DecompressedConfigOrder.Add(Entry.ContentHash);
+	return &DecompressedConfigs.Add(Entry.ContentHash, MoveTemp(Config));
+}
+
+void UTableauAsset::AppendConfigPayload(FTableauAssetConfig& Entry, const uint8* Payload, int32 PayloadSize)
+{
+	Entry.PayloadOffset = ConfigBulkData.GetBulkDataSize() + PendingConfigPayloads.Num();
+	Entry.PayloadSize = PayloadSize;
+
+	PendingConfigPayloads.Append(Payload, PayloadSize);
+}
+
+void UTableauAsset::FlushPendingConfigPayloads()
+{
+	if (PendingConfigPayloads.Num() == 0)
+	{
+		return;
+	}
+
+	// Locking for write loads any payloads still on disk, so that they're kept.
+	const int64 BulkDataSize = ConfigBulkData.GetBulkDataSize();
+	ConfigBulkData.Lock(LOCK_READ_WRITE);
+	uint8* Data = (uint8*)ConfigBulkData.Realloc(BulkDataSize + PendingConfigPayloads.Num());
+	FMemory::Memcpy(Data + BulkDataSize, PendingConfigPayloads.GetData(), PendingConfigPayloads.Num());
+	ConfigBulkData.Unlock();
+
+	PendingConfigPayloads.Empty();
+}
+
+bool UTableauAsset::ReadConfigPayload(const FTableauAssetConfig& Entry, TArray<uint8>& OutPayload) const
+{
+	const int64 BulkDataSize = ConfigBulkData.GetBulkDataSize();
+	if (Entry.PayloadSize <= 0 || Entry.PayloadOffset < 0 || Entry.PayloadOffset + Entry.PayloadSize > BulkDataSize + PendingConfigPayloads.Num())
+	{
+		return false;
+	}
+
+	OutPayload.SetNumUninitialized(Entry.PayloadSize);
+
+	// Payloads added since the last save follow on from the bulk data.
+	if (Entry.PayloadOffset >= BulkDataSize)
+	{
+		FMemory::Memcpy(OutPayload.GetData(), PendingConfigPayloads.GetData() + (Entry.PayloadOffset - BulkDataSize), Entry.PayloadSize);
+		return true;
+	}
+
+	if (ConfigBulkData.IsBulkDataLoaded())
+	{
+		const uint8* Data = (const uint8*)ConfigBulkData.LockReadOnly();
+		FMemory::Memcpy(OutPayload.GetData(), Data + Entry.PayloadOffset, Entry.PayloadSize);
+		ConfigBulkData.Unlock();
+		return true;
+	}
+
+	if (!ConfigBulkData.CanLoadFromDisk())
+	{
+		return false;
+	}
+
+	TUniquePtr<IBulkDataIORequest> Request(ConfigBulkData.CreateStreamingRequest(Entry.PayloadOffset, Entry.PayloadSize, AIOP_Normal, nullptr, OutPayload.GetData()));
+	if (!Request.IsValid())
+	{
+		return false;
+	}
+
+	Request->WaitCompletion();
+	return Request->GetReadResults() != nullptr;
+}
+
+void UTableauAsset::InternElementConfigs(int32 FirstElement)
+{
+	for (int32 Index = FirstElement; Index < TableauElement.Num(); ++Index)
+	{
+		FTableauAssetElement& Element = TableauElement[Index];
+
+		if (Element.AssetConfigData.Num() > 0)
+		{
+			Element.ConfigIndex = AddConfig(Element.AssetConfigData, ETableauConfigFormat::Binary);
+		}
+		else if (!Element.AssetConfig.IsEmpty())
+		{
+			FTCHARToUTF8 Utf8Config(*Element.AssetConfig);
+			TArray<uint8> Config((const uint8*)Utf8Config.Get(), Utf8Config.Length());
+			Element.ConfigIndex = AddConfig(Config, ETableauConfigFormat::Text);
+		}
+
+		Element.AssetConfig.Empty();
+		Element.AssetConfigData.Empty();
+	}
 }
 
 void UTableauAsset::ReplaceTableauReferences(const FSoftObjectPath& ReferenceToReplace, const FSoftObjectPath& ReferenceReplacement)
 {
+	NotifyElementsChanging();
+
 	// Iterate the Tableau elements. If the Asset Reference matches the ReferenceToReplace,
 	// change it to the ReferenceReplacement path.
 	for (FTableauAssetElement& Element : TableauElement)
@@ -65,16 +487,297 @@ void UTableauAsset::ReplaceTableauReferences(const FSoftObjectPath& ReferenceToR
 	}
 }
 
+void UTableauAsset::NotifyElementsChanging()
+{
+#if WITH_EDITOR
+	OnTableauElementsChanging.Broadcast(this);
+	bMetricsDirty = true;
+#endif
+}
+
 void UTableauAsset::GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const
 {
-	if (EvaluationMode == ETableauEvaluationMode::Type::Composition)
+	switch (EvaluationMode)
 	{
-		OutTags.Add(FAssetRegistryTag("Mode", "Composition", FAssetRegistryTag::TT_Alphabetical));
+		case ETableauEvaluationMode::Superposition:
+			OutTags.Add(FAssetRegistryTag("Mode", "Superposition", FAssetRegistryTag::TT_Alphabetical));
+			break;
+
+		case ETableauEvaluationMode::HierarchicalComposition:
+			OutTags.Add(FAssetRegistryTag("Mode", "HierarchicalComposition", FAssetRegistryTag::TT_Alphabetical));
+			break;
+
+		default:
+			OutTags.Add(FAssetRegistryTag("Mode", "Composition", FAssetRegistryTag::TT_Alphabetical));
+			break;
 	}
-	else
+
+	OutTags.Add(FAssetRegistryTag("Notes", Notes, FAssetRegistryTag::TT_Alphabetical));
+
+#if WITH_EDITORONLY_DATA
+	// Assets saved before the metrics existed report none until they're next saved.
+	if (Metrics.MaxDepth > 0)
 	{
-		OutTags.Add(FAssetRegistryTag("Mode", "Superposition", FAssetRegistryTag::TT_Alphabetical));
+		OutTags.Add(FAssetRegistryTag("MaxDepth", FString::FromInt(Metrics.MaxDepth), FAssetRegistryTag::TT_Numerical));
+		OutTags.Add(FAssetRegistryTag("DirectElements", FString::FromInt(Metrics.DirectElementCount), FAssetRegistryTag::TT_Numerical));
+		OutTags.Add(FAssetRegistryTag("TransitiveElements", FString::FromInt(Metrics.TransitiveElementCount), FAssetRegistryTag::TT_Numerical));
+		OutTags.Add(FAssetRegistryTag("LeafAssets", FString::FromInt(Metrics.LeafAssetCount), FAssetRegistryTag::TT_Numerical));
+		OutTags.Add(FAssetRegistryTag("FoliageTypes", FString::FromInt(Metrics.FoliageTypeCount), FAssetRegistryTag::TT_Numerical));
+		OutTags.Add(FAssetRegistryTag("ExpectedInstances", FString::SanitizeFloat(Metrics.ExpectedInstanceCount), FAssetRegistryTag::TT_Numerical));
+
+		const FVector Size = Metrics.LocalBounds.IsValid ? Metrics.LocalBounds.GetSize() : FVector::ZeroVector;
+		OutTags.Add(FAssetRegistryTag("ApproxSize", FString::Printf(TEXT("%dx%dx%d"), FMath::RoundToInt(Size.X), FMath::RoundToInt(Size.Y), FMath::RoundToInt(Size.Z)), FAssetRegistryTag::TT_Dimensional));
 	}
+#endif
+}
 
-	OutTags.Add(FAssetRegistryTag("Notes", Notes, FAssetRegistryTag::TT_Alphabetical));
+void UTableauAsset::Serialize(FArchive& Ar)
+{
+	// An undo or redo restores the ConfigTable, whose payloads may since have moved.
+	TArray<FTableauAssetConfig> PreviousConfigTable;
+	if (Ar.IsTransacting() && Ar.IsLoading())
+	{
+		PreviousConfigTable = ConfigTable;
+	}
+
+	Super::Serialize(Ar);
+
+	// The bulk data is left out of the transaction buffer, which only records the payloads added since it was
+	// last written.
+	if (Ar.IsTransacting())
+	{
+		SerializeTransactedConfigPayloads(Ar, PreviousConfigTable);
+		return;
+	}
+
+	Ar.UsingCustomVersion(FTableauAssetCustomVersion::GUID);
+	if (Ar.IsLoading() && Ar.CustomVer(FTableauAssetCustomVersion::GUID) < FTableauAssetCustomVersion::ConfigBulkData)
+	{
+		return;
+	}
+
+	// Configs are only spawned in the editor, so the payloads are stripped from cooked packages.
+	if (!Ar.IsLoading() || Ar.CustomVer(FTableauAssetCustomVersion::GUID) >= FTableauAssetCustomVersion::StripConfigBulkData)
+	{
+		FStripDataFlags StripFlags(Ar);
+		if (StripFlags.IsEditorDataStripped())
+		{
+			return;
+		}
+	}
+
+	if (Ar.IsSaving() && !Ar.IsObjectReferenceCollector() && !Ar.IsCountingMemory())
+	{
+		FlushPendingConfigPayloads();
+	}
+
+	// The payloads are saved apart from the export, at the end of the package, so that they're only read
+	// when a config is spawned.
+	ConfigBulkData.SetBulkDataFlags(BULKDATA_Force_NOT_InlinePayload);
+	ConfigBulkData.Serialize(Ar, this);
+}
+
+void UTableauAsset::SerializeTransactedConfigPayloads(FArchive& Ar, const TArray<FTableauAssetConfig>& PreviousConfigTable)
+{
+	int32 Generation = ConfigBulkDataGeneration;
+	int64 BulkDataSize = ConfigBulkData.GetBulkDataSize();
+	Ar << Generation;
+	Ar << BulkDataSize;
+
+	if (!Ar.IsLoading())
+	{
+		Ar << PendingConfigPayloads;
+		return;
+	}
+
+	TArray<uint8> RecordedPayloads;
+	Ar << RecordedPayloads;
+
+	TMap<FString, const FTableauAssetConfig*> PreviousEntries;
+	for (const FTableauAssetConfig& Entry : PreviousConfigTable)
+	{
+		PreviousEntries.Add(Entry.ContentHash, &Entry);
+	}
+
+	const int64 CurrentBulkDataSize = ConfigBulkData.GetBulkDataSize();
+	TArray<uint8> Payloads;
+
+	for (FTableauAssetConfig& Entry : ConfigTable)
+	{
+		if (Entry.PayloadSize <= 0)
+		{
+			continue;
+		}
+
+		// The bulk data is only appended to until it is rewritten, so ranges it held when recorded are unchanged.
+		if (Generation == ConfigBulkDataGeneration && Entry.PayloadOffset + Entry.PayloadSize <= BulkDataSize)
+		{
+			continue;
+		}
+
+		// Otherwise the payload is found where the table held it before the undo, or among those recorded.
+		const FTableauAssetConfig* const* PreviousEntry = PreviousEntries.Find(Entry.ContentHash);
+		if (PreviousEntry && (*PreviousEntry)->PayloadOffset + (*PreviousEntry)->PayloadSize <= CurrentBulkDataSize)
+		{
+			Entry.PayloadOffset = (*PreviousEntry)->PayloadOffset;
+			Entry.PayloadSize = (*PreviousEntry)->PayloadSize;
+			continue;
+		}
+
+		TArray<uint8> Payload;
+		const int64 RecordedOffset = Entry.PayloadOffset - BulkDataSize;
+		if (RecordedOffset >= 0 && RecordedOffset + Entry.PayloadSize <= RecordedPayloads.Num())
+		{
+			Payload.Append(RecordedPayloads.GetData() + RecordedOffset, Entry.PayloadSize);
+		}
+		else if (PreviousEntry)
+		{
+			ReadConfigPayload(**PreviousEntry, Payload);
+		}
+
+		if (Payload.Num() == 0)
+		{
+			UE_LOG(LogTableau, Warning, TEXT("%s: The config %s restored by undo is no longer available."), *GetName(), *Entry.ContentHash);
+			Entry.PayloadSize = 0;
+			continue;
+		}
+
+		Entry.PayloadOffset = CurrentBulkDataSize + Payloads.Num();
+		Entry.PayloadSize = Payload.Num();
+		Payloads.Append(Payload);
+	}
+
+	PendingConfigPayloads = MoveTemp(Payloads);
+}
+
+void UTableauAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	// Configs saved before the bulk data existed hold their payload in the ConfigTable.
+	for (FTableauAssetConfig& Entry : ConfigTable)
+	{
+		if (Entry.CompressedData.Num() > 0)
+		{
+			AppendConfigPayload(Entry, Entry.CompressedData.GetData(), Entry.CompressedData.Num());
+			Entry.CompressedData.Empty();
+		}
+	}
+
+	// Assets saved before the ConfigTable existed hold a config on each element.
+	InternElementConfigs(0);
+}
+
+#if WITH_EDITOR
+void UTableauAsset::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	CompactConfigTable();
+
+	// The metrics are computed here, rather than when the tags are gathered, so that reading the tags
+	// never loads the assets the Tableau references. They are only computed again once the Tableau has
+	// changed, since computing them loads every nested Tableau and leaf asset.
+	if (bMetricsDirty || Metrics.MaxDepth == 0)
+	{
+		UpdateMetrics();
+	}
+}
+
+void UTableauAsset::PreEditChange(FProperty* PropertyAboutToChange)
+{
+	Super::PreEditChange(PropertyAboutToChange);
+
+	NotifyElementsChanging();
+}
+
+void UTableauAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	bMetricsDirty = true;
+}
+
+void UTableauAsset::UpdateMetrics()
+{
+	FTableauMetricsBuilder MetricsBuilder;
+	const FTableauMetricsNode* Node = MetricsBuilder.Build(this);
+	check(Node);
+
+	Metrics.MaxDepth = Node->Depth;
+	Metrics.DirectElementCount = TableauElement.Num();
+	Metrics.TransitiveElementCount = Node->TransitiveElementCount;
+	Metrics.LeafAssetCount = Node->LeafAssets.Num();
+	Metrics.FoliageTypeCount = Node->FoliageTypes.Num();
+	Metrics.ExpectedInstanceCount = Node->ExpectedInstanceCount;
+	Metrics.LocalBounds = Node->Bounds;
+
+	bMetricsDirty = false;
+}
+
+void UTableauAsset::CompactConfigTable()
+{
+	TArray<int32> Remap;
+	Remap.Init(INDEX_NONE, ConfigTable.Num());
+
+	int32 Referenced = 0;
+	for (const FTableauAssetElement& Element : TableauElement)
+	{
+		if (Remap.IsValidIndex(Element.ConfigIndex) && Remap[Element.ConfigIndex] == INDEX_NONE)
+		{
+			Remap[Element.ConfigIndex] = 0;
+			++Referenced;
+		}
+	}
+
+	if (Referenced == ConfigTable.Num())
+	{
+		return;
+	}
+
+	// The elements are renumbered below. Recipes refer to configs by ContentHash, so they're unaffected.
+	OnTableauElementsChanging.Broadcast(this);
+
+	// Repack the payloads of the configs kept.
+	FlushPendingConfigPayloads();
+	TArray<uint8> Payloads;
+	const uint8* Data = (const uint8*)ConfigBulkData.Lock(LOCK_READ_ONLY);
+
+	int32 Kept = 0;
+	for (int32 Index = 0; Index < ConfigTable.Num(); ++Index)
+	{
+		if (Remap[Index] != INDEX_NONE)
+		{
+			Remap[Index] = Kept;
+
+			FTableauAssetConfig& Entry = ConfigTable[Index];
+			const int64 PayloadOffset = Payloads.Num();
+			Payloads.Append(Data + Entry.PayloadOffset, Entry.PayloadSize);
+			Entry.PayloadOffset = PayloadOffset;
+
+			if (Kept != Index)
+			{
+				ConfigTable[Kept] = MoveTemp(Entry);
+			}
+			++Kept;
+		}
+	}
+
+	ConfigBulkData.Unlock();
+
+	ConfigBulkData.Lock(LOCK_READ_WRITE);
+	uint8* NewData = (uint8*)ConfigBulkData.Realloc(Payloads.Num());
+	FMemory::Memcpy(NewData, Payloads.GetData(), Payloads.Num());
+	ConfigBulkData.Unlock();
+
+	++ConfigBulkDataGeneration;
+
+	ConfigTable.SetNum(Kept);
+	for (FTableauAssetElement& Element : TableauElement)
+	{
+		Element.ConfigIndex = Remap.IsValidIndex(Element.ConfigIndex) ? Remap[Element.ConfigIndex] : INDEX_NONE;
+	}
+
+	ConfigLookup.Empty();
 }
+#endif
@@ -0,0 +1,328 @@
+#include "TableauBakedRecipe.h"
+
+// Engine Includes
+#include "Engine/StaticMesh.h"
+#include "FoliageType.h"
+#include "Math/Float16.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+
+// constants
+static const uint32 BakedRecipeMagic = 0x43524254;
+static const uint32 BakedRecipeVersion = 2;
+static const uint32 BakedRecipeVersionQuantizedLocations = 1;
+static const float LocationQuantization = 65535.0f;
+static const float RotationQuantization = 32767.0f;
+static const int32 MaxBakedSources = MAX_uint16 + 1;
+
+namespace
+{
+	struct FBakedRecipeHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 InstanceCount;
+		FVector BoundsMin;
+		FVector BoundsSize;
+	};
+
+	struct FBakedInstance
+	{
+		FVector Location;
+		int16 Rotation[3];
+		FFloat16 Scale[3];
+		uint16 Source;
+		int32 Parent;
+	};
+
+	// Version 1 records, whose locations were quantized within the recipe bounds. Over a large Tableau, that
+	// misplaced instances by centimetres or more.
+	struct FBakedInstanceQuantizedLocation
+	{
+		uint16 Location[3];
+		int16 Rotation[3];
+		FFloat16 Scale[3];
+		uint16 Source;
+		int32 Parent;
+	};
+
+	int32 GetRecordSize(uint32 Version)
+	{
+		switch (Version)
+		{
+			case BakedRecipeVersionQuantizedLocations:
+				return sizeof(FBakedInstanceQuantizedLocation);
+
+			case BakedRecipeVersion:
+				return sizeof(FBakedInstance);
+
+			default:
+				return 0;
+		}
+	}
+
+	template<typename RecordType>
+	void DecodeRecordRotationAndScale(const RecordType& Record, FQuat& OutRotation, FVector& OutScale)
+	{
+		const float X = Record.Rotation[0] / RotationQuantization;
+		const float Y = Record.Rotation[1] / RotationQuantization;
+		const float Z = Record.Rotation[2] / RotationQuantization;
+		const float W = FMath::Sqrt(FMath::Max(1.0f - X * X - Y * Y - Z * Z, 0.0f));
+
+		OutRotation = FQuat(X, Y, Z, W).GetNormalized();
+		OutScale = FVector(Record.Scale[0].GetFloat(), Record.Scale[1].GetFloat(), Record.Scale[2].GetFloat());
+	}
+
+	float DequantizeLocation(uint16 Value, float Min, float Size)
+	{
+		return Min + (Value / LocationQuantization) * Size;
+	}
+}
+
+
+//////////////////////////////////////////////////
+// UTableauBakedRecipe
+
+void UTableauBakedRecipe::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	RecipeBlob.BulkSerialize(Ar);
+
+	// A blob of a version this build doesn't know can't be decoded, so it is dropped rather than misread.
+	if (Ar.IsLoading() && RecipeBlob.Num() >= sizeof(FBakedRecipeHeader))
+	{
+		FBakedRecipeHeader Header;
+		FMemory::Memcpy(&Header, RecipeBlob.GetData(), sizeof(FBakedRecipeHeader));
+
+		if (Header.Magic != BakedRecipeMagic || GetRecordSize(Header.Version) == 0)
+		{
+			UE_LOG(LogTableau, Error, TEXT("Baked Tableau Recipe %s has unknown version %u and must be baked again."), *GetName(), Header.Version);
+			RecipeBlob.Empty();
+			InstanceCount = 0;
+		}
+	}
+}
+
+bool UTableauBakedRecipe::Bake(const TArray<FTableauBakeInstance>& Instances)
+{
+	// Build the source tables and find each instance's source index. Foliage Types follow the meshes.
+	TArray<UStaticMesh*> NewMeshes;
+	TArray<UFoliageType*> NewFoliageTypes;
+	TMap<UStaticMesh*, int32> MeshLookup;
+	TMap<UFoliageType*, int32> FoliageLookup;
+
+	TArray<int32> MeshIndices;
+	TArray<int32> FoliageIndices;
+	MeshIndices.Init(INDEX_NONE, Instances.Num());
+	FoliageIndices.Init(INDEX_NONE, Instances.Num());
+
+	for (int32 Index = 0; Index < Instances.Num(); ++Index)
+	{
+		if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Instances[Index].Source))
+		{
+			if (const int32* Existing = MeshLookup.Find(StaticMesh))
+			{
+				MeshIndices[Index] = *Existing;
+			}
+			else
+			{
+				MeshIndices[Index] = MeshLookup.Add(StaticMesh, NewMeshes.Add(StaticMesh));
+			}
+		}
+		else if (UFoliageType* FoliageType = Cast<UFoliageType>(Instances[Index].Source))
+		{
+			if (const int32* Existing = FoliageLookup.Find(FoliageType))
+			{
+				FoliageIndices[Index] = *Existing;
+			}
+			else
+			{
+				FoliageIndices[Index] = FoliageLookup.Add(FoliageType, NewFoliageTypes.Add(FoliageType));
+			}
+		}
+	}
+
+	// Records hold the source index in 16 bits.
+	if (NewMeshes.Num() + NewFoliageTypes.Num() > MaxBakedSources)
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Unable to bake %s: %d Static Meshes and Foliage Types exceed the limit of %d."), *GetName(), NewMeshes.Num() + NewFoliageTypes.Num(), MaxBakedSources);
+		return false;
+	}
+
+	Meshes = MoveTemp(NewMeshes);
+	FoliageTypes = MoveTemp(NewFoliageTypes);
+	Bounds = FBox(ForceInit);
+
+	TArray<int32> SourceIndices;
+	TArray<int32> Order;
+	SourceIndices.Init(INDEX_NONE, Instances.Num());
+	for (int32 Index = 0; Index < Instances.Num(); ++Index)
+	{
+		if (MeshIndices[Index] != INDEX_NONE)
+		{
+			SourceIndices[Index] = MeshIndices[Index];
+		}
+		else if (FoliageIndices[Index] != INDEX_NONE)
+		{
+			SourceIndices[Index] = Meshes.Num() + FoliageIndices[Index];
+		}
+		else
+		{
+			continue;
+		}
+
+		Order.Add(Index);
+		Bounds += Instances[Index].Transform.GetLocation();
+	}
+
+	// Order the records by source, keeping the original order within a source.
+	Order.StableSort([&SourceIndices](int32 A, int32 B)
+		{
+			return SourceIndices[A] < SourceIndices[B];
+		});
+
+	TArray<int32> RecordIndices;
+	RecordIndices.Init(INDEX_NONE, Instances.Num());
+	for (int32 Record = 0; Record < Order.Num(); ++Record)
+	{
+		RecordIndices[Order[Record]] = Record;
+	}
+
+	InstanceCount = Order.Num();
+
+	FBakedRecipeHeader Header;
+	Header.Magic = BakedRecipeMagic;
+	Header.Version = BakedRecipeVersion;
+	Header.InstanceCount = InstanceCount;
+	// The bounds are kept in the header for version 1 records, which were quantized within them.
+	Header.BoundsMin = Bounds.IsValid ? Bounds.Min : FVector::ZeroVector;
+	Header.BoundsSize = Bounds.IsValid ? Bounds.GetSize() : FVector::ZeroVector;
+
+	RecipeBlob.SetNumUninitialized(sizeof(FBakedRecipeHeader) + InstanceCount * sizeof(FBakedInstance));
+	FMemory::Memcpy(RecipeBlob.GetData(), &Header, sizeof(FBakedRecipeHeader));
+	FBakedInstance* Records = reinterpret_cast<FBakedInstance*>(RecipeBlob.GetData() + sizeof(FBakedRecipeHeader));
+
+	for (int32 Record = 0; Record < Order.Num(); ++Record)
+	{
+		const FTableauBakeInstance& Instance = Instances[Order[Record]];
+		FBakedInstance& BakedInstance = Records[Record];
+
+		BakedInstance.Location = Instance.Transform.GetLocation();
+
+		// Store the unit quaternion with a positive W, which is recovered on decode.
+		FQuat Rotation = Instance.Transform.GetRotation().GetNormalized();
+		if (Rotation.W < 0.0f)
+		{
+			Rotation = FQuat(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+		}
+		BakedInstance.Rotation[0] = (int16)FMath::RoundToInt(Rotation.X * RotationQuantization);
+		BakedInstance.Rotation[1] = (int16)FMath::RoundToInt(Rotation.Y * RotationQuantization);
+		BakedInstance.Rotation[2] = (int16)FMath::RoundToInt(Rotation.Z * RotationQuantization);
+
+		const FVector Scale = Instance.Transform.GetScale3D();
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			BakedInstance.Scale[Axis] = FFloat16(Scale[Axis]);
+		}
+
+		BakedInstance.Source = (uint16)SourceIndices[Order[Record]];
+		BakedInstance.Parent = Instances.IsValidIndex(Instance.Parent) ? RecordIndices[Instance.Parent] : INDEX_NONE;
+	}
+
+	MarkPackageDirty();
+
+	return true;
+}
+
+bool UTableauBakedRecipe::Decode(TArray<FTransform>& OutTransforms, TArray<FTableauBakedRange>& OutRanges, TArray<int32>* OutParents) const
+{
+	OutTransforms.Reset();
+	OutRanges.Reset();
+
+	if (RecipeBlob.Num() < sizeof(FBakedRecipeHeader))
+	{
+		return RecipeBlob.Num() == 0;
+	}
+
+	FBakedRecipeHeader Header;
+	FMemory::Memcpy(&Header, RecipeBlob.GetData(), sizeof(FBakedRecipeHeader));
+
+	const int32 RecordSize = GetRecordSize(Header.Version);
+	if (Header.Magic != BakedRecipeMagic || RecordSize == 0 || Header.InstanceCount < 0
+		|| (int64)RecipeBlob.Num() != (int64)sizeof(FBakedRecipeHeader) + (int64)Header.InstanceCount * RecordSize)
+	{
+		UE_LOG(LogTableau, Error, TEXT("Baked Tableau Recipe %s is malformed."), *GetName());
+		return false;
+	}
+
+	const uint8* Records = RecipeBlob.GetData() + sizeof(FBakedRecipeHeader);
+	const int32 SourceCount = Meshes.Num() + FoliageTypes.Num();
+
+	OutTransforms.SetNumUninitialized(Header.InstanceCount);
+	if (OutParents)
+	{
+		OutParents->SetNumUninitialized(Header.InstanceCount);
+	}
+
+	int32 CurrentSource = INDEX_NONE;
+	for (int32 Record = 0; Record < Header.InstanceCount; ++Record)
+	{
+		FVector Location;
+		FQuat Rotation;
+		FVector Scale;
+		int32 Source;
+		int32 Parent;
+
+		if (Header.Version == BakedRecipeVersionQuantizedLocations)
+		{
+			FBakedInstanceQuantizedLocation BakedInstance;
+			FMemory::Memcpy(&BakedInstance, Records + Record * RecordSize, RecordSize);
+
+			Location = FVector(
+				DequantizeLocation(BakedInstance.Location[0], Header.BoundsMin.X, Header.BoundsSize.X),
+				DequantizeLocation(BakedInstance.Location[1], Header.BoundsMin.Y, Header.BoundsSize.Y),
+				DequantizeLocation(BakedInstance.Location[2], Header.BoundsMin.Z, Header.BoundsSize.Z));
+			DecodeRecordRotationAndScale(BakedInstance, Rotation, Scale);
+			Source = BakedInstance.Source;
+			Parent = BakedInstance.Parent;
+		}
+		else
+		{
+			FBakedInstance BakedInstance;
+			FMemory::Memcpy(&BakedInstance, Records + Record * RecordSize, RecordSize);
+
+			Location = BakedInstance.Location;
+			DecodeRecordRotationAndScale(BakedInstance, Rotation, Scale);
+			Source = BakedInstance.Source;
+			Parent = BakedInstance.Parent;
+		}
+
+		if (Source >= SourceCount)
+		{
+			UE_LOG(LogTableau, Error, TEXT("Baked Tableau Recipe %s references a missing source."), *GetName());
+			return false;
+		}
+
+		OutTransforms[Record] = FTransform(Rotation, Location, Scale);
+		if (OutParents)
+		{
+			(*OutParents)[Record] = Parent;
+		}
+
+		// Records are ordered by source, so each source is one contiguous range.
+		if (Source != CurrentSource)
+		{
+			CurrentSource = Source;
+
+			FTableauBakedRange& Range = OutRanges.AddDefaulted_GetRef();
+			Range.StaticMesh = CurrentSource < Meshes.Num() ? Meshes[CurrentSource] : nullptr;
+			Range.FoliageType = CurrentSource < Meshes.Num() ? nullptr : FoliageTypes[CurrentSource - Meshes.Num()];
+			Range.FirstInstance = Record;
+		}
+		++OutRanges.Last().InstanceCount;
+	}
+
+	return true;
+}
@@ -0,0 +1,96 @@
+#include "TableauBakedRecipeComponent.h"
+
+// Engine Includes
+#include "FoliageType_InstancedStaticMesh.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+#include "TableauBakedRecipe.h"
+#include "TableauHISMComponent.h"
+
+
+//////////////////////////////////////////////////
+// UTableauBakedRecipeComponent
+
+void UTableauBakedRecipeComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	RebuildInstances();
+}
+
+void UTableauBakedRecipeComponent::OnUnregister()
+{
+	DestroyInstances();
+
+	Super::OnUnregister();
+}
+
+#if WITH_EDITOR
+void UTableauBakedRecipeComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UTableauBakedRecipeComponent, BakedRecipe))
+	{
+		RebuildInstances();
+	}
+}
+#endif
+
+void UTableauBakedRecipeComponent::RebuildInstances()
+{
+	DestroyInstances();
+
+	AActor* Owner = GetOwner();
+	if (BakedRecipe == nullptr || Owner == nullptr || !IsRegistered())
+	{
+		return;
+	}
+
+	TArray<FTransform> Transforms;
+	TArray<FTableauBakedRange> Ranges;
+	if (!BakedRecipe->Decode(Transforms, Ranges))
+	{
+		return;
+	}
+
+	TArray<FTransform> RangeTransforms;
+	for (const FTableauBakedRange& Range : Ranges)
+	{
+		UTableauHISMComponent* Component = NewObject<UTableauHISMComponent>(Owner, NAME_None, RF_Transient | RF_TextExportTransient);
+
+		if (const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh = Cast<UFoliageType_InstancedStaticMesh>(Range.FoliageType))
+		{
+			Component->FoliageType = FSoftObjectPath(FoliageType_InstancedStaticMesh);
+			Component->ConfigureFromFoliageType(FoliageType_InstancedStaticMesh);
+		}
+		else
+		{
+			Component->SetStaticMesh(Range.StaticMesh);
+		}
+
+		Component->SetupAttachment(this);
+		Component->RegisterComponent();
+
+		// Instances are relative to the baked Tableau, ie. to this component.
+		RangeTransforms.Reset(Range.InstanceCount);
+		RangeTransforms.Append(Transforms.GetData() + Range.FirstInstance, Range.InstanceCount);
+		Component->AddInstancesInBulk(RangeTransforms);
+		Component->RebuildClusterTree();
+
+		InstanceComponents.Add(Component);
+	}
+}
+
+void UTableauBakedRecipeComponent::DestroyInstances()
+{
+	for (UTableauHISMComponent* Component : InstanceComponents)
+	{
+		if (Component && !Component->IsPendingKill())
+		{
+			Component->DestroyComponent(false);
+		}
+	}
+	InstanceComponents.Empty();
+}
@@ -4,12 +4,45 @@
 // Local includes
 #include "TableauAssetModule.h"
 #include "TableauActor.h"
+#include "TableauFoliageSubsystem.h"
+#include "TableauRuntimeSubsystem.h"
+#include "TableauStreamingSubsystem.h"
 
 
 //////////////////////////////////////////////
 //UTableauComponent
 
 UTableauComponent::FOnTableauDuplicateDelegate  UTableauComponent::OnTableauDuplicate;
+UTableauComponent::FOnTableauRecipeRestoredDelegate  UTableauComponent::OnTableauRecipeRestored;
+uint32 UTableauComponent::InstanceTrackingGeneration = 1;
+
+namespace
+{
+	uint32 HashTransform(const FTransform& Transform, uint32 Hash)
+	{
+		const FVector Translation = Transform.GetTranslation();
+		const FQuat Rotation = Transform.GetRotation();
+		const FVector Scale = Transform.GetScale3D();
+
+		Hash = FCrc::MemCrc32(&Translation, sizeof(FVector), Hash);
+		Hash = FCrc::MemCrc32(&Rotation, sizeof(FQuat), Hash);
+		return FCrc::MemCrc32(&Scale, sizeof(FVector), Hash);
+	}
+
+	uint32 HashInstances(const TArray<FTableauInstanceTracker>& Instances, const FTransform& ComponentTransform, uint32 Hash)
+	{
+		for (const FTableauInstanceTracker& Instance : Instances)
+		{
+			if (const AActor* Actor = Instance.TableauInstance.Get())
+			{
+				Hash = HashCombine(Hash, GetTypeHash(Actor->GetClass()->GetFName()));
+				Hash = HashTransform(Actor->GetActorTransform().GetRelativeTransform(ComponentTransform), Hash);
+			}
+		}
+
+		return Hash;
+	}
+}
 
 UTableauComponent::UTableauComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -44,37 +77,69 @@ void UTableauComponent::SetSeed(int32 InSeed)
 
 FLinearColor UTableauComponent::GetColor() const
 {
-	FSoftObjectPath AssetReference = FSoftObjectPath(GetTableau());
-	UObject* Object = SafelyResolveSoftPath(AssetReference);
-	if (UTableauAsset* TableauAsset = Cast<UTableauAsset>(Object))
+	// The color is drawn every frame, so it is only looked up again when the Tableau or its mode changes.
+	// The Tableau is a hard reference and so is already loaded.
+	const UTableauAsset* TableauAsset = GetTableau();
+	const int32 EvaluationMode = TableauAsset ? (int32)TableauAsset->EvaluationMode : INDEX_NONE;
+
+	if (TableauAsset != CachedColorTableau || EvaluationMode != CachedColorEvaluationMode)
 	{
-		switch (TableauAsset->EvaluationMode)
+		CachedColorTableau = TableauAsset;
+		CachedColorEvaluationMode = EvaluationMode;
+
+		switch (EvaluationMode)
 		{
 			case ETableauEvaluationMode::Composition:
-				return TableauColors::CompositionColor.ReinterpretAsLinear();
+				CachedColor = TableauColors::CompositionColor.ReinterpretAsLinear();
+				break;
 
 			case ETableauEvaluationMode::Superposition:
-				return TableauColors::SuperpositionColor.ReinterpretAsLinear();
+				CachedColor = TableauColors::SuperpositionColor.ReinterpretAsLinear();
+				break;
 
 			case ETableauEvaluationMode::HierarchicalComposition:
-				return TableauColors::HierarchicalCompositionColor.ReinterpretAsLinear();
+				CachedColor = TableauColors::HierarchicalCompositionColor.ReinterpretAsLinear();
+				break;
 
 			default:
-				return TableauColors::ErrorColor.ReinterpretAsLinear();
+				// For some reason this isn't pointing to a Tableau.
+				CachedColor = TableauColors::ErrorColor.ReinterpretAsLinear();
+				break;
 		}
 	}
-	else
-	{
-		// For some reason this isn't pointing to a Tableau.
-		return TableauColors::ErrorColor.ReinterpretAsLinear();
-	}
+
+	return CachedColor;
 }
 
 FBox UTableauComponent::GetBoundingBox() const
 {
+	if (!bBoundingBoxDirty)
+	{
+		// The Instances and generated components follow the Component, so the cached bounds are moved with it
+		// rather than gathered again. Bounds are updated as the Component moves, before its children have.
+		const FTransform& ComponentTransform = GetComponentTransform();
+		if (ComponentTransform.Equals(CachedBoundingBoxTransform) || !CachedBoundingBox.IsValid)
+		{
+			return CachedBoundingBox;
+		}
+		return CachedBoundingBox.TransformBy(CachedBoundingBoxTransform.Inverse() * ComponentTransform);
+	}
+
 	// Iterate the actors owned by the Tableau and append to the box.
 	FBox Box(ForceInit);
-	Box += GetBoundingBox(GetInstances());
+	for (const FTableauInstanceTracker& Instance : TableauInstances)
+	{
+		if (const AActor* Actor = Instance.TableauInstance.Get())
+		{
+			for (const UActorComponent* ActorComponent : Actor->GetComponents())
+			{
+				if (const UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(ActorComponent))
+				{
+					Box += PrimitiveComponent->Bounds.GetBox();
+				}
+			}
+		}
+	}
 
 	// And append with the bounds of attached HISMs, StaticMeshComponents, ChildActorComponents
 	if (ATableauActor* TableauActor = Cast<ATableauActor>(GetOwner()))
@@ -93,53 +158,81 @@ FBox UTableauComponent::GetBoundingBox() const
 		{
 			Box += ChildActor->Bounds.GetBox();
 		}
+
+		// Foliage drawn by shared HISMs
+		if (TableauActor->SharedFoliage.Num() > 0 && GetWorld())
+		{
+			if (const UTableauFoliageSubsystem* FoliageSubsystem = GetWorld()->GetSubsystem<UTableauFoliageSubsystem>())
+			{
+				Box += FoliageSubsystem->GetActorFoliageBounds(TableauActor);
+			}
+		}
 	}
 
+	CachedBoundingBox = Box;
+	CachedBoundingBoxTransform = GetComponentTransform();
+	bBoundingBoxDirty = false;
+
 	return Box;
 }
 
-FBox UTableauComponent::GetBoundingBox(const TArray<FTableauInstanceTracker>& SubInstances) const
+void UTableauComponent::InvalidateBounds()
 {
-	// Recurse the Instances registry and return the bounds of the local strata.
-	
-	FBox Box(ForceInit);
+	bBoundingBoxDirty = true;
+	UpdateBounds();
+}
 
-	for (const FTableauInstanceTracker& Instance: SubInstances)
+void UTableauComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+	for (const FTableauInstanceTracker& Instance : TableauInstances)
 	{
-		if (Instance.TableauInstance!=nullptr)
+		AActor* InActor = Instance.TableauInstance.Get();
+		if (InActor && !InActor->IsPendingKillPending())
 		{
-			for (const UActorComponent* ActorComponent : Instance.TableauInstance->GetComponents())
-			{
-				if (const UPrimitiveComponent * PrimitiveComponent = Cast<UPrimitiveComponent>(ActorComponent))
-				{
-					Box += PrimitiveComponent->Bounds.GetBox();
-				}
-			}
+			InActor->GetWorld()->DestroyActor(InActor, true);
 		}
-
-		// Recurse
-		Box += GetBoundingBox(Instance.SubInstances);
 	}
 
-	return Box;
-
+	ClearInstances();
 }
 
-void UTableauComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
+void UTableauComponent::BeginPlay()
 {
-	for (FTableauInstanceTracker& Instance : TableauInstances)
+	Super::BeginPlay();
+
+	UWorld* World = GetWorld();
+	if (bEvaluateAtRuntime && World && World->IsGameWorld())
 	{
-		Instance.Apply([](AActor* InActor)
+		if (bStreamAtRuntime)
+		{
+			if (UTableauStreamingSubsystem* StreamingSubsystem = World->GetSubsystem<UTableauStreamingSubsystem>())
 			{
-				if (InActor && !InActor->IsPendingKillPending())
-				{
-					InActor->GetWorld()->DestroyActor(InActor, true);
-				}
-			});
+				StreamingSubsystem->RegisterTableau(this);
+			}
+		}
+		else if (UTableauRuntimeSubsystem* RuntimeSubsystem = World->GetSubsystem<UTableauRuntimeSubsystem>())
+		{
+			RuntimeSubsystem->RequestEvaluation(this);
+		}
+	}
+}
+
+void UTableauComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (UTableauStreamingSubsystem* StreamingSubsystem = World->GetSubsystem<UTableauStreamingSubsystem>())
+		{
+			StreamingSubsystem->UnregisterTableau(this);
+		}
 
+		if (UTableauRuntimeSubsystem* RuntimeSubsystem = World->GetSubsystem<UTableauRuntimeSubsystem>())
+		{
+			RuntimeSubsystem->ReleaseEvaluation(this);
+		}
 	}
 
-	ClearInstances();
+	Super::EndPlay(EndPlayReason);
 }
 
 void UTableauComponent::PostEditImport()
@@ -148,30 +241,143 @@ void UTableauComponent::PostEditImport()
 	OnTableauDuplicate.ExecuteIfBound(Owner);
 }
 
-UObject* UTableauComponent::SafelyResolveSoftPath(const FSoftObjectPath& path) const
+void UTableauComponent::PostLoad()
 {
-	// Trying to resolve an unloaded object will crash Editor (v4.24).
-	// It's sort of slow and not ideal but we need to be certain that the requested Object is
-	// loaded first.
-	path.TryLoad();
-	return path.ResolveObject();
+	Super::PostLoad();
+
+	LiveRecipeHash = RecipeHash;
+	bLiveInstancesTransacted = bInstancesTransacted;
+	bBoundingBoxDirty = true;
+	ValidatedGeneration = 0;
 }
 
-void UTableauComponent::ClearInstances()
+#if WITH_EDITOR
+void UTableauComponent::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// The registry was restored from the transaction buffer and must be validated again.
+	ValidatedGeneration = 0;
+	InvalidateBounds();
+
+	// A regeneration recorded without its Instances leaves the Instances untransacted on both sides of the
+	// transaction. Any other transaction restored the Instances along with the Component.
+	const bool bRecipeChanged = (RecipeHash != LiveRecipeHash);
+	const bool bTransacted = (bInstancesTransacted || bLiveInstancesTransacted);
+
+	LiveRecipeHash = RecipeHash;
+	bLiveInstancesTransacted = bInstancesTransacted;
+
+	if (bRecipeChanged && !bTransacted)
+	{
+		OnTableauRecipeRestored.ExecuteIfBound(this);
+	}
+}
+#endif
+
+uint32 UTableauComponent::ComputeRecipeHash() const
 {
-	// Recursively clear the Instances registry starting with the deepest arrays first.
-	ClearInstances(TableauInstances);
+	uint32 Hash = GetTypeHash(FSoftObjectPath(GetTableau()));
+	Hash = HashCombine(Hash, GetTypeHash(Seed));
+	Hash = HashCombine(Hash, GetTypeHash(bAutoSnap));
+	Hash = HashCombine(Hash, GetTypeHash(bIgnoreExclusion));
+	Hash = HashCombine(Hash, GetTypeHash(bExcludeHISMsFromHLOD));
+	Hash = HashCombine(Hash, GetTypeHash(bShareFoliage));
+
+	for (const FFilterActor& FilterActor : FilterActors)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(FilterActor.Actor.ToSoftObjectPath()));
+		Hash = HashCombine(Hash, GetTypeHash(FilterActor.ExpandVolume));
+	}
+
+	for (const FFilterWeightmap& FilterWeightmap : FilterWeightmaps)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(FilterWeightmap.LayerName));
+		Hash = HashCombine(Hash, GetTypeHash(FilterWeightmap.WeightThreshold));
+	}
+
+	for (const FFilterTag& FilterTag : FilterTags)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(FilterTag.Tag));
+		Hash = HashCombine(Hash, GetTypeHash(FilterTag.Tolerance));
+	}
+
+	return Hash;
 }
 
-void UTableauComponent::ClearInstances(TArray<FTableauInstanceTracker>& SubInstances)
+uint32 UTableauComponent::ComputeInstanceSnapshotHash() const
 {
-	// Recurse
-	for (FTableauInstanceTracker& Instance : SubInstances)
+	const FTransform ComponentTransform = GetComponentTransform();
+	uint32 Hash = HashInstances(TableauInstances, ComponentTransform, 0);
+
+	if (ATableauActor* TableauActor = Cast<ATableauActor>(GetOwner()))
 	{
-		ClearInstances(Instance.SubInstances);
+		for (const UTableauHISMComponent* Component : TableauActor->FoliageComponents)
+		{
+			if (Component)
+			{
+				for (int32 Index = 0; Index < Component->GetInstanceCount(); ++Index)
+				{
+					FTransform InstanceTransform;
+					Component->GetInstanceTransform(Index, InstanceTransform, false);
+					Hash = HashTransform(InstanceTransform, Hash);
+				}
+			}
+		}
+
+		for (const UStaticMeshComponent* StaticMesh : TableauActor->StaticMeshComponents)
+		{
+			if (StaticMesh)
+			{
+				Hash = HashTransform(StaticMesh->GetRelativeTransform(), Hash);
+			}
+		}
+
+		for (const UChildActorComponent* ChildActor : TableauActor->ChildActorComponents)
+		{
+			if (ChildActor)
+			{
+				Hash = HashTransform(ChildActor->GetRelativeTransform(), Hash);
+			}
+		}
+
+		for (const FTableauSharedFoliage& SharedFoliage : TableauActor->SharedFoliage)
+		{
+			for (const FTransform& InstanceTransform : SharedFoliage.Instances)
+			{
+				Hash = HashTransform(InstanceTransform, Hash);
+			}
+		}
 	}
 
-	SubInstances.Empty();
+	return Hash;
+}
+
+bool UTableauComponent::CanRegenerateWithoutTransaction() const
+{
+	return !bInstancesTransacted && ComputeInstanceSnapshotHash() == InstanceSnapshotHash;
+}
+
+bool UTableauComponent::HasEditedInstances() const
+{
+	return RecipeHash != 0 && ComputeInstanceSnapshotHash() != InstanceSnapshotHash;
+}
+
+void UTableauComponent::RecordRegeneration(bool bTransacted)
+{
+	RecipeHash = ComputeRecipeHash();
+	InstanceSnapshotHash = ComputeInstanceSnapshotHash();
+	bInstancesTransacted = bTransacted;
+
+	LiveRecipeHash = RecipeHash;
+	bLiveInstancesTransacted = bInstancesTransacted;
+}
+
+void UTableauComponent::ClearInstances()
+{
+	TableauInstances.Empty();
+	ValidatedGeneration = InstanceTrackingGeneration;
+	bBoundingBoxDirty = true;
 }
 
 void UTableauComponent::RestoreInstances()
@@ -193,11 +399,15 @@ void UTableauComponent::RestoreInstances()
 
 bool UTableauComponent::IsValid() const
 {
-	// Check all of the Instance Trackers. If they're all still pointing
-	// to valid actors, return true. A false return indicates that the 
-	// Component is no longer maintaining a valid tracking system and 
-	// should rebuild it.
-	for (const auto& InstanceTracker : TableauInstances)
+	// Trackers only go stale when an Actor is lost, so the registry need only be walked if one has been
+	// lost since it was last validated. A false return indicates that the Component is no longer
+	// maintaining a valid tracking system and should rebuild it.
+	if (ValidatedGeneration == InstanceTrackingGeneration)
+	{
+		return true;
+	}
+
+	for (const FTableauInstanceTracker& InstanceTracker : TableauInstances)
 	{
 		if (!InstanceTracker.TableauInstance.IsValid())
 		{
@@ -205,44 +415,24 @@ bool UTableauComponent::IsValid() const
 		}
 	}
 
+	ValidatedGeneration = InstanceTrackingGeneration;
 	return true;
 }
 
-void UTableauComponent::RegisterInstance(TWeakObjectPtr<AActor> InInstance, FTableauInstanceTracker* Parent)
+int32 UTableauComponent::RegisterInstance(TWeakObjectPtr<AActor> InInstance, int32 Parent)
 {
-	TArray<FTableauInstanceTracker>* InstanceContainer = nullptr;
-	if (Parent == nullptr)
-	{
-		// No parent indicates root level registration
-		InstanceContainer = &TableauInstances;
-	}
-	else
-	{
-		InstanceContainer = &(Parent->SubInstances);
-	}
+	check(Parent == INDEX_NONE || TableauInstances.IsValidIndex(Parent));
 
-	FTableauInstanceTracker InstanceTracker;
+	FTableauInstanceTracker& InstanceTracker = TableauInstances.AddDefaulted_GetRef();
 	InstanceTracker.TableauInstance = InInstance;
-	InstanceContainer->Add(InstanceTracker);	
+	InstanceTracker.Parent = Parent;
+
+	bBoundingBoxDirty = true;
+
+	return TableauInstances.Num() - 1;
 }
 
-FTableauInstanceTracker* UTableauComponent::GetLastInstanceTracker()
+void UTableauComponent::InvalidateInstanceTracking()
 {
-	// The most recent Instance registered will be the last element of
-	// the last element of the last elements &c.
-	if (TableauInstances.Num() == 0)
-	{
-		return nullptr;
-	}
-	else
-	{
-		if (TableauInstances.Last().SubInstances.Num() > 0)
-		{
-			return &TableauInstances.Last().SubInstances.Last();
-		}
-		else
-		{
-			return &TableauInstances.Last();
-		}
-	}
+	++InstanceTrackingGeneration;
 }
@@ -0,0 +1,132 @@
+#include "TableauEvaluationContext.h"
+
+// Engine Includes
+#include "EngineUtils.h"
+#include "Engine/World.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+#include "TableauExclusionVolume.h"
+
+
+//////////////////////////////////////////////////
+// FTableauEvaluationContext
+
+FTableauEvaluationContext::FTableauEvaluationContext(UWorld* InWorld)
+	: World(InWorld)
+{
+}
+
+FTableauEvaluationContext::~FTableauEvaluationContext()
+{
+	ResolvedAssets.Empty();
+	CompiledAssets.Empty();
+	LandscapeLayerCaches.Empty();
+}
+
+void FTableauEvaluationContext::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	// Keep everything we've loaded alive for the lifetime of the context.
+	for (TPair<FSoftObjectPath, UObject*>& ResolvedAsset : ResolvedAssets)
+	{
+		Collector.AddReferencedObject(ResolvedAsset.Value);
+	}
+}
+
+FString FTableauEvaluationContext::GetReferencerName() const
+{
+	return TEXT("FTableauEvaluationContext");
+}
+
+void FTableauEvaluationContext::AddTableau(const UTableauAsset* TableauAsset)
+{
+	check(IsInGameThread());
+
+	if (TableauAsset == nullptr || CompiledAssets.Contains(TableauAsset))
+	{
+		return;
+	}
+
+	// Register the Tableau before descending so that self referencing Tableaux terminate.
+	CompiledAssets.Add(TableauAsset);
+	ResolvedAssets.Add(FSoftObjectPath(TableauAsset), const_cast<UTableauAsset*>(TableauAsset));
+
+	float TotalWeight = TableauAsset->NothingWeight;
+
+	for (const FTableauAssetElement& Element : TableauAsset->TableauElement)
+	{
+		TotalWeight += Element.Weight;
+
+		LoadAsset(Element.AssetReference);
+
+		// Nested Tableaux are compiled in turn.
+		if (const UTableauAsset* NestedTableauAsset = Cast<UTableauAsset>(ResolveAsset(Element.AssetReference)))
+		{
+			AddTableau(NestedTableauAsset);
+		}
+	}
+
+	// The map may have been reallocated by the recursion, so find the entry again.
+	CompiledAssets.FindChecked(TableauAsset).TotalWeight = TotalWeight;
+}
+
+void FTableauEvaluationContext::LoadAsset(const FSoftObjectPath& AssetReference)
+{
+	if (!AssetReference.IsValid() || ResolvedAssets.Contains(AssetReference))
+	{
+		return;
+	}
+
+	FSoftObjectPtr SoftObjectPtr(AssetReference);
+	UObject* Asset = SoftObjectPtr.IsValid() ? SoftObjectPtr.Get() : SoftObjectPtr.LoadSynchronous();
+	ResolvedAssets.Add(AssetReference, Asset);
+}
+
+UObject* FTableauEvaluationContext::ResolveAsset(const FSoftObjectPath& AssetReference) const
+{
+	if (UObject* const* Asset = ResolvedAssets.Find(AssetReference))
+	{
+		return *Asset;
+	}
+	return nullptr;
+}
+
+const FTableauCompiledAsset* FTableauEvaluationContext::FindCompiledAsset(const UTableauAsset* TableauAsset) const
+{
+	return CompiledAssets.Find(TableauAsset);
+}
+
+TSharedPtr<FTableauFilter> FTableauEvaluationContext::GetExclusionFilter()
+{
+	check(IsInGameThread());
+
+	// Search the World for all TableauExclusionVolumes once, however many Tableaux share the context.
+	if (!ExclusionFilter.IsValid())
+	{
+		TArray<TWeakObjectPtr<ATableauExclusionVolume>> ExclusionVolumes;
+		if (World)
+		{
+			for (TActorIterator<ATableauExclusionVolume> ActorItr(World); ActorItr; ++ActorItr)
+			{
+				ExclusionVolumes.Add(*ActorItr);
+			}
+		}
+		ExclusionFilter = MakeShareable(new FTableauExclusionVolumeIndexFilter(ExclusionVolumes));
+	}
+
+	return ExclusionFilter;
+}
+
+TSharedPtr<FTableauLandscapeLayerCache> FTableauEvaluationContext::GetLandscapeLayerCache(const FName& LayerName)
+{
+	check(IsInGameThread());
+
+	if (TSharedPtr<FTableauLandscapeLayerCache>* LayerCache = LandscapeLayerCaches.Find(LayerName))
+	{
+		return *LayerCache;
+	}
+
+	TSharedPtr<FTableauLandscapeLayerCache> NewLayerCache = MakeShareable(new FTableauLandscapeLayerCache);
+	LandscapeLayerCaches.Add(LayerName, NewLayerCache);
+	return NewLayerCache;
+}
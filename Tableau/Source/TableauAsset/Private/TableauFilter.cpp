@@ -7,9 +7,13 @@
 #include "LandscapeInfo.h"
 #include "Components/SplineComponent.h"
 #include "EngineUtils.h"
+#include "Engine/World.h"
 
 // Local Includes
+#include "TableauAssetModule.h"
+#include "TableauComponent.h"
 #include "TableauExclusionVolume.h"
+#include "TableauEvaluationContext.h"
 
 
 FTableauCylinderVolumeFilter::FTableauCylinderVolumeFilter(const FVector& InCenter, float InRadius)
@@ -25,26 +29,35 @@ bool FTableauCylinderVolumeFilter::Sample(const FVector& Location) const
 }
 
 
-FTableauLandscapeWeightmapFilter::FTableauLandscapeWeightmapFilter(const FName InLayerName, float WeightThreshold)
-	: LandscapeLayerName(InLayerName)
+FTableauLandscapeWeightmapFilter::FTableauLandscapeWeightmapFilter(const UWorld* InWorld, const FName InLayerName, float WeightThreshold, TSharedPtr<FTableauLandscapeLayerCache> InLayerCache)
+	: World(InWorld)
+	, LandscapeLayerName(InLayerName)
 	, Threshold(WeightThreshold)
+	, LandscapeLayerCache(InLayerCache)
 {
-	LandscapeLayerCacheData.Reset(new TMap<ULandscapeComponent*, TArray<uint8>>);
-	LandscapeLayerCacheData->Empty();
+	if (!LandscapeLayerCache.IsValid())
+	{
+		LandscapeLayerCache = MakeShareable(new FTableauLandscapeLayerCache);
+	}
 }
 
 FTableauLandscapeWeightmapFilter::~FTableauLandscapeWeightmapFilter()
 {
-	LandscapeLayerCacheData->Empty();
+	LandscapeLayerCache.Reset();
 }
 
 bool FTableauLandscapeWeightmapFilter::Sample(const FVector& Location) const
 {
+#if WITH_EDITOR
 	// Line trace the world and find the landscape component beneath this location.
 	const static float SampleHeightOffset = 1000.0f;
 	const static float SampleDepth = 5000.0f;
 
-	UWorld* World = GEditor->GetEditorWorldContext().World();
+	if (!World.IsValid())
+	{
+		return false;
+	}
+
 	TArray <struct FHitResult> OutHits;
 	const FVector Start = Location + FVector(0.0f, 0.0f, SampleHeightOffset);
 	const FVector End = Location - FVector(0.0f, 0.0f, SampleDepth);
@@ -59,7 +72,8 @@ bool FTableauLandscapeWeightmapFilter::Sample(const FVector& Location) const
 				if (ULandscapeComponent* HitLandscape = HitLandscapeCollision->RenderComponent.Get())
 				{
 					// Cache store mapping between component and weight data
-					TArray<uint8>* LayerCache = &LandscapeLayerCacheData->FindOrAdd(HitLandscape);
+					FScopeLock Lock(&LandscapeLayerCache->CriticalSection);
+					TArray<uint8>* LayerCache = &LandscapeLayerCache->LayerCacheData.FindOrAdd(HitLandscape);
 					
 					const float HitWeight = HitLandscape->GetLayerWeightAtLocation(Location, HitLandscape->GetLandscapeInfo()->GetLayerInfoByName(LandscapeLayerName), LayerCache);
 
@@ -73,6 +87,9 @@ bool FTableauLandscapeWeightmapFilter::Sample(const FVector& Location) const
 	}
 
 	return false;
+#else
+	return true;
+#endif
 }
 
 
@@ -84,14 +101,20 @@ FTableauSplineFilter::FTableauSplineFilter(TWeakObjectPtr<USplineComponent> InSp
 
 bool FTableauSplineFilter::Sample(const FVector& Location) const
 {
+	if (!SplineComponent.IsValid())
+	{
+		return true;
+	}
+
 	const FVector ClosestLocation = SplineComponent->FindLocationClosestToWorldLocation(Location, ESplineCoordinateSpace::Type::World);
 	const float Distance = FVector::Dist2D(Location, ClosestLocation);
 	return (Distance > Radius);
 }
 
 
-FTableauTagFilter::FTableauTagFilter(const FName InTag, float InTolerance)
-	: Tag(InTag)
+FTableauTagFilter::FTableauTagFilter(const UWorld* InWorld, const FName InTag, float InTolerance)
+	: World(InWorld)
+	, Tag(InTag)
 	, Tolerance(InTolerance)
 {
 }
@@ -107,7 +130,7 @@ bool FTableauTagFilter::Sample(const FVector& Location) const
 	FCollisionQueryParams CollisionQueryParams;
 	FCollisionResponseParams CollisionResponseParams;
 
-	if (GEditor->GetEditorWorldContext().World()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECollisionChannel::ECC_WorldStatic, CollisionQueryParams, CollisionResponseParams))
+	if (World.IsValid() && World->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECollisionChannel::ECC_WorldStatic, CollisionQueryParams, CollisionResponseParams))
 	{
 		if (AActor* HitActor = HitResult.GetActor())
 		{
@@ -130,13 +153,45 @@ FTableauExclusionVolumeFilter::FTableauExclusionVolumeFilter(const TWeakObjectPt
 
 bool FTableauExclusionVolumeFilter::Sample(const FVector& Location) const
 {
-	return !ExclusionVolume->EncompassesPoint(Location, 0.0f, nullptr);
+	return !ExclusionVolume.IsValid() || !ExclusionVolume->EncompassesPoint(Location, 0.0f, nullptr);
 }
 
 
+FTableauExclusionVolumeIndexFilter::FTableauExclusionVolumeIndexFilter(const TArray<TWeakObjectPtr<ATableauExclusionVolume>>& InVolumes)
+{
+	ExclusionVolumes.Reserve(InVolumes.Num());
+	ExclusionBounds.Reserve(InVolumes.Num());
+	for (const TWeakObjectPtr<ATableauExclusionVolume>& Volume : InVolumes)
+	{
+		if (Volume.IsValid())
+		{
+			ExclusionVolumes.Add(Volume);
+			ExclusionBounds.Add(Volume->GetComponentsBoundingBox(true));
+		}
+	}
+}
 
-FTableauFilterSampler::FTableauFilterSampler(const FTransform& InToWorldTransform)
+bool FTableauExclusionVolumeIndexFilter::Sample(const FVector& Location) const
+{
+	for (int32 Index = 0; Index < ExclusionVolumes.Num(); ++Index)
+	{
+		// Only consult the brush if the sample is inside the volume's bounds.
+		if (ExclusionBounds[Index].IsInsideOrOn(Location) && ExclusionVolumes[Index].IsValid())
+		{
+			if (ExclusionVolumes[Index]->EncompassesPoint(Location, 0.0f, nullptr))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+
+FTableauFilterSampler::FTableauFilterSampler(const FTransform& InToWorldTransform, const UWorld* InWorld)
 	: ToWorldTransform(InToWorldTransform)
+	, World(InWorld)
 {
 	Filters.Empty();
 }
@@ -146,15 +201,72 @@ FTableauFilterSampler::~FTableauFilterSampler()
 	Filters.Empty();
 }
 
+TSharedPtr<FTableauFilterSampler> FTableauFilterSampler::GatherFilters(const UTableauComponent* TableauComponent, UWorld* World, FTableauEvaluationContext* Context)
+{
+	TSharedPtr<FTableauFilterSampler> Filter(new FTableauFilterSampler(TableauComponent->GetOwner()->ActorToWorld(), World));
+
+	// Actors in the component's FilterActors list create cylinder filter volumes
+	// corresponding to the bounds of the actor.
+	// All locations are in the TableauComponent local space
+	for (const FFilterActor& FilterActor : TableauComponent->FilterActors)
+	{
+		if (FilterActor.Actor.IsValid())
+		{
+			// If the actor contains a spline component, it is handled differently.
+			if (USplineComponent* SplineComponent = Cast<USplineComponent>(FilterActor.Actor->GetRootComponent()))
+			{
+				TWeakObjectPtr<USplineComponent> SplineComponentPtr(SplineComponent);
+				Filter->AddSplineFilter(SplineComponentPtr, FilterActor.ExpandVolume);
+			}
+			else
+			{
+				// This is treated as a general actor.
+				float Radius, Height;
+				FilterActor.Actor->GetComponentsBoundingCylinder(Radius, Height, false);
+
+				Filter->AddCylinderVolumeFilter(FilterActor.Actor->GetActorLocation(), Radius + FilterActor.ExpandVolume);
+			}
+		}
+	}
+
+	// Add a filter for each specified landscape layer
+	for (const FFilterWeightmap& FilterWeightmap : TableauComponent->FilterWeightmaps)
+	{
+		TSharedPtr<FTableauLandscapeLayerCache> LayerCache = Context ? Context->GetLandscapeLayerCache(FilterWeightmap.LayerName) : nullptr;
+		Filter->AddLandscapeLayerFilter(FilterWeightmap.LayerName, FilterWeightmap.WeightThreshold, LayerCache);
+	}
+
+	// Add a filter for each specified tag.
+	for (const FFilterTag& FilterTag : TableauComponent->FilterTags)
+	{
+		Filter->AddTagFilter(FilterTag.Tag, FilterTag.Tolerance);
+	}
+
+	if (!TableauComponent->bIgnoreExclusion)
+	{
+		// Add any TableauExclusionVolumes in the currently loaded World.
+		if (Context)
+		{
+			Filter->AddFilter(Context->GetExclusionFilter());
+		}
+		else
+		{
+			Filter->AddAllLoadedExclusionVolumes(World);
+		}
+	}
+
+	return Filter;
+}
+
 void FTableauFilterSampler::AddCylinderVolumeFilter(const FVector& Origin, float Radius)
 {
 	TSharedPtr<FTableauFilter> NewFilter(new FTableauCylinderVolumeFilter(Origin, Radius));
 	Filters.Add(NewFilter);
 }
 
-void FTableauFilterSampler::AddLandscapeLayerFilter(const FName& LayerName, float WeightThreshold)
+void FTableauFilterSampler::AddLandscapeLayerFilter(const FName& LayerName, float WeightThreshold, TSharedPtr<FTableauLandscapeLayerCache> LayerCache)
 {
-	TSharedPtr<FTableauFilter> NewFilter(new FTableauLandscapeWeightmapFilter(LayerName, WeightThreshold));
+	TSharedPtr<FTableauFilter> NewFilter(new FTableauLandscapeWeightmapFilter(World.Get(), LayerName, WeightThreshold, LayerCache));
 	Filters.Add(NewFilter);
 }
 
@@ -166,7 +278,7 @@ void FTableauFilterSampler::AddSplineFilter(TWeakObjectPtr<USplineComponent> Spl
 
 void FTableauFilterSampler::AddTagFilter(const FName FilterTag, float Tolerance)
 {
-	TSharedPtr<FTableauFilter> NewFilter(new FTableauTagFilter(FilterTag, Tolerance));
+	TSharedPtr<FTableauFilter> NewFilter(new FTableauTagFilter(World.Get(), FilterTag, Tolerance));
 	Filters.Add(NewFilter);
 }
 
@@ -183,6 +295,14 @@ void FTableauFilterSampler::AddAllLoadedExclusionVolumes(UWorld* World)
 	}
 }
 
+void FTableauFilterSampler::AddFilter(TSharedPtr<FTableauFilter> Filter)
+{
+	if (Filter.IsValid())
+	{
+		Filters.Add(Filter);
+	}
+}
+
 bool FTableauFilterSampler::Sample(const FVector& TestLocation) const
 {
 	for (const TSharedPtr<FTableauFilter> Filter : Filters)
@@ -195,6 +315,18 @@ bool FTableauFilterSampler::Sample(const FVector& TestLocation) const
 	return true;
 }
 
+bool FTableauFilterSampler::IsThreadSafe() const
+{
+	for (const TSharedPtr<FTableauFilter>& Filter : Filters)
+	{
+		if (!Filter->IsThreadSafe())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 void FTableauFilterSampler::Reset()
 {
 	Filters.Empty();
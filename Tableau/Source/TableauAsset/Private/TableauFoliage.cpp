@@ -0,0 +1,109 @@
+
+#include "TableauFoliage.h"
+
+// Engine Includes
+#include "FoliageType.h"
+#include "FoliageType_InstancedStaticMesh.h"
+
+// Local Includes
+#include "TableauComponent.h"
+
+FTableauFoliage::FTableauFoliage(UFoliageType* InFoliageType, const FTransform& Xform, const FName& InName, bool bIsSnappable = true)
+	: Name(InName)
+	, bSnappable(bIsSnappable)
+	, bAlignToSurfaceNormal(false)
+{ 
+	FoliageType = TWeakObjectPtr<UFoliageType>(InFoliageType);
+	Instances.Empty();
+	Instances.Add(Xform);
+}
+
+FTableauFoliage::~FTableauFoliage()
+{
+	Instances.Empty();
+}
+
+void FTableauFoliage::AddInstance(const FTransform& Transform)
+{
+	Instances.Add(Transform);
+}
+
+UFoliageType* FTableauFoliage::GetFoliageType() const
+{
+	return FoliageType.Get();
+}
+
+const TArray<FTransform>& FTableauFoliage::GetInstances() const
+{
+	return Instances;
+}
+
+void FTableauFoliage::ConfigureAndAttachHISM(ATableauActor* Actor)
+{
+	check(Actor);
+	UTableauHISMComponent* HISMComponent = NewObject<UTableauHISMComponent>(Actor, UTableauHISMComponent::StaticClass(), NAME_None, RF_Transactional);
+
+	check(HISMComponent);
+
+	if (FoliageType.IsValid())
+	{
+		HISMComponent->FoliageType = FSoftObjectPath(FoliageType.Get());
+		UpdateComponentSettings(HISMComponent);
+	}
+
+	HISMComponent->SetupAttachment(Actor->GetRootComponent());
+
+	if (Actor->GetRootComponent()->IsRegistered())
+	{
+		HISMComponent->RegisterComponent();
+		Actor->AddInstanceComponent(HISMComponent);
+		Actor->FoliageComponents.Add(HISMComponent);
+	}
+
+	// Use only instance translation as a component transform
+	HISMComponent->SetWorldTransform(Actor->GetRootComponent()->GetComponentTransform());
+
+	HISMComponent->bSnappable = bSnappable;
+
+	// Exclude from HLOD Generation?
+	if (Actor->GetTableauComponent()->bExcludeHISMsFromHLOD)
+	{
+		HISMComponent->ExcludeFromHLOD();
+	}
+
+	// Add the new component to the transaction buffer so it will get destroyed on undo
+	HISMComponent->Modify();
+	// We don't want to track changes to instances later so we mark it as non-transactional
+	HISMComponent->ClearFlags(RF_Transactional);
+
+	// The instances were added without building the cluster tree. Build it once, off the game thread.
+	HISMComponent->RebuildClusterTree();
+}
+
+void FTableauFoliage::AddToSharedFoliage(ATableauActor* Actor)
+{
+	check(Actor);
+
+	const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh = Cast<UFoliageType_InstancedStaticMesh>(FoliageType.Get());
+	if (FoliageType_InstancedStaticMesh == nullptr)
+	{
+		return;
+	}
+
+	// Instances are already relative to the Actor.
+	FTableauSharedFoliage& SharedFoliage = Actor->SharedFoliage.AddDefaulted_GetRef();
+	SharedFoliage.FoliageType = FSoftObjectPath(FoliageType_InstancedStaticMesh);
+	SharedFoliage.bSnappable = bSnappable;
+	SharedFoliage.bAlignToNormal = FoliageType_InstancedStaticMesh->AlignToNormal;
+	SharedFoliage.GroundSlopeAngle = FoliageType_InstancedStaticMesh->GroundSlopeAngle;
+	SharedFoliage.Instances = Instances;
+}
+
+void FTableauFoliage::UpdateComponentSettings(UTableauHISMComponent* HISMComponent)
+{
+	// Configure the HISM to the FoliageType
+	HISMComponent->ConfigureFromFoliageType(Cast<UFoliageType_InstancedStaticMesh>(FoliageType.Get()));
+
+	// Add the instances
+	HISMComponent->AddInstancesInBulk(Instances);
+}
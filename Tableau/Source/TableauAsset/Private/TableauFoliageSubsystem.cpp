@@ -0,0 +1,352 @@
+#include "TableauFoliageSubsystem.h"
+
+// Engine Includes
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "FoliageType_InstancedStaticMesh.h"
+#include "HAL/IConsoleManager.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+#include "TableauActor.h"
+#include "TableauComponent.h"
+#include "TableauHISMComponent.h"
+
+static TAutoConsoleVariable<float> CVarTableauSharedFoliageCellSize(
+	TEXT("Tableau.SharedFoliageCellSize"),
+	12800.0f,
+	TEXT("Size of the spatial cells used to aggregate shared Tableau foliage into HISMs."),
+	ECVF_Default);
+
+
+//////////////////////////////////////////////////
+// UTableauFoliageSubsystem
+
+void UTableauFoliageSubsystem::Deinitialize()
+{
+	if (FlushTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(FlushTickerHandle);
+		FlushTickerHandle.Reset();
+	}
+
+	Cells.Empty();
+	ActorCells.Empty();
+	CellComponents.Empty();
+
+	if (HostActor && !HostActor->IsPendingKillPending())
+	{
+		HostActor->Destroy();
+	}
+	HostActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UTableauFoliageSubsystem::UpdateActor(ATableauActor* TableauActor)
+{
+	UnregisterActor(TableauActor);
+
+	if (TableauActor == nullptr || TableauActor->IsPendingKillPending() || TableauActor->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	if (TableauActor->SharedFoliage.Num() == 0)
+	{
+		return;
+	}
+
+	// All of an Actor's instances go to the cell containing the Actor.
+	const float CellSize = FMath::Max(CVarTableauSharedFoliageCellSize.GetValueOnGameThread(), 100.0f);
+	const FVector ActorLocation = TableauActor->GetActorLocation();
+	const FIntPoint Cell(FMath::FloorToInt(ActorLocation.X / CellSize), FMath::FloorToInt(ActorLocation.Y / CellSize));
+
+	TArray<FCellKey>& RegisteredCells = ActorCells.Add(TableauActor);
+
+	for (int32 SharedFoliageIndex = 0; SharedFoliageIndex < TableauActor->SharedFoliage.Num(); ++SharedFoliageIndex)
+	{
+		FCellKey Key;
+		Key.FoliageType = TableauActor->SharedFoliage[SharedFoliageIndex].FoliageType;
+		Key.Cell = Cell;
+
+		FInstanceRange Range;
+		Range.Owner = TableauActor;
+		Range.SharedFoliageIndex = SharedFoliageIndex;
+		Range.FirstInstance = 0;
+		Range.InstanceCount = 0;
+		Range.Bounds = FBox(ForceInit);
+		Range.bAdded = true;
+
+		FCell& CellData = Cells.FindOrAdd(Key);
+		CellData.Ranges.Add(Range);
+		CellData.bDirty = true;
+
+		RegisteredCells.AddUnique(Key);
+	}
+
+	ScheduleFlush();
+}
+
+void UTableauFoliageSubsystem::UnregisterActor(ATableauActor* TableauActor)
+{
+	TArray<FCellKey> RegisteredCells;
+	if (!ActorCells.RemoveAndCopyValue(TableauActor, RegisteredCells))
+	{
+		return;
+	}
+
+	for (const FCellKey& Key : RegisteredCells)
+	{
+		if (FCell* Cell = Cells.Find(Key))
+		{
+			// The instances stay in place until the cell is updated.
+			for (FInstanceRange& Range : Cell->Ranges)
+			{
+				if (Range.Owner.Get() == TableauActor || !Range.Owner.IsValid())
+				{
+					Range.bRemoved = true;
+				}
+			}
+			Cell->bDirty = true;
+		}
+	}
+
+	ScheduleFlush();
+}
+
+bool UTableauFoliageSubsystem::FindInstanceRange(const ATableauActor* TableauActor, int32 SharedFoliageIndex, UTableauHISMComponent*& OutComponent, int32& OutFirstInstance, int32& OutInstanceCount) const
+{
+	if (const TArray<FCellKey>* RegisteredCells = ActorCells.Find(const_cast<ATableauActor*>(TableauActor)))
+	{
+		for (const FCellKey& Key : *RegisteredCells)
+		{
+			const FCell& Cell = Cells.FindChecked(Key);
+			for (const FInstanceRange& Range : Cell.Ranges)
+			{
+				if (Range.Owner.Get() == TableauActor && Range.SharedFoliageIndex == SharedFoliageIndex && !Range.bRemoved)
+				{
+					OutComponent = Cell.Component;
+					OutFirstInstance = Range.FirstInstance;
+					OutInstanceCount = Range.InstanceCount;
+					return !Cell.bDirty && Cell.Component != nullptr;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+FBox UTableauFoliageSubsystem::GetActorFoliageBounds(const ATableauActor* TableauActor) const
+{
+	FBox Bounds(ForceInit);
+
+	if (const TArray<FCellKey>* RegisteredCells = ActorCells.Find(const_cast<ATableauActor*>(TableauActor)))
+	{
+		for (const FCellKey& Key : *RegisteredCells)
+		{
+			for (const FInstanceRange& Range : Cells.FindChecked(Key).Ranges)
+			{
+				if (Range.Owner.Get() == TableauActor && !Range.bRemoved)
+				{
+					Bounds += Range.Bounds;
+				}
+			}
+		}
+	}
+
+	return Bounds;
+}
+
+void UTableauFoliageSubsystem::FlushDirtyCells()
+{
+	if (FlushTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(FlushTickerHandle);
+		FlushTickerHandle.Reset();
+	}
+
+	TSet<ATableauActor*> UpdatedOwners;
+	for (auto It = Cells.CreateIterator(); It; ++It)
+	{
+		FCell& Cell = It.Value();
+		if (!Cell.bDirty)
+		{
+			continue;
+		}
+
+		const bool bCellInUse = Cell.Ranges.ContainsByPredicate([](const FInstanceRange& Range)
+			{
+				return !Range.bRemoved;
+			});
+
+		if (!bCellInUse)
+		{
+			// Nothing left in the cell, so the shared HISM goes too.
+			if (Cell.Component)
+			{
+				CellComponents.Remove(Cell.Component);
+				Cell.Component->DestroyComponent();
+			}
+			It.RemoveCurrent();
+			continue;
+		}
+
+		UpdateCell(It.Key(), Cell, UpdatedOwners);
+	}
+
+	// Shared foliage contributes to the Tableau bounds.
+	for (ATableauActor* Owner : UpdatedOwners)
+	{
+		if (UTableauComponent* TableauComponent = Owner->GetTableauComponent())
+		{
+			TableauComponent->InvalidateBounds();
+		}
+	}
+}
+
+void UTableauFoliageSubsystem::UpdateCell(const FCellKey& Key, FCell& Cell, TSet<ATableauActor*>& OutUpdatedOwners)
+{
+	Cell.bDirty = false;
+
+	if (Cell.Component == nullptr)
+	{
+		Cell.Component = CreateCellComponent(Key.FoliageType);
+		if (Cell.Component == nullptr)
+		{
+			return;
+		}
+	}
+
+	const UStaticMesh* StaticMesh = Cell.Component->GetStaticMesh();
+	const FBox MeshBounds = StaticMesh ? StaticMesh->GetBoundingBox() : FBox(FVector::ZeroVector, FVector::ZeroVector);
+
+	// Ranges already in the HISM are in instance order, ahead of the added ones. Everything from the first
+	// removed range onward is moved down, and the added ranges follow.
+	int32 FirstChanged = Cell.Component->GetInstanceCount();
+	for (const FInstanceRange& Range : Cell.Ranges)
+	{
+		if (Range.bRemoved && !Range.bAdded)
+		{
+			FirstChanged = Range.FirstInstance;
+			break;
+		}
+	}
+
+	TArray<FTransform> WorldTransforms;
+	TArray<FInstanceRange> Ranges;
+	Ranges.Reserve(Cell.Ranges.Num());
+
+	for (FInstanceRange& Range : Cell.Ranges)
+	{
+		ATableauActor* Owner = Range.Owner.Get();
+		if (Range.bRemoved)
+		{
+			if (Owner)
+			{
+				OutUpdatedOwners.Add(Owner);
+			}
+			continue;
+		}
+
+		if (!Range.bAdded)
+		{
+			// Instances ahead of the first removed range stay where they are.
+			if (Range.FirstInstance >= FirstChanged)
+			{
+				const int32 FirstInstance = FirstChanged + WorldTransforms.Num();
+				for (int32 Index = 0; Index < Range.InstanceCount; ++Index)
+				{
+					Cell.Component->GetInstanceTransform(Range.FirstInstance + Index, WorldTransforms.AddDefaulted_GetRef(), true);
+				}
+				Range.FirstInstance = FirstInstance;
+			}
+
+			Ranges.Add(Range);
+			continue;
+		}
+
+		if (Owner == nullptr || !Owner->SharedFoliage.IsValidIndex(Range.SharedFoliageIndex))
+		{
+			continue;
+		}
+		OutUpdatedOwners.Add(Owner);
+
+		Range.FirstInstance = FirstChanged + WorldTransforms.Num();
+		Range.Bounds = FBox(ForceInit);
+		Range.bAdded = false;
+
+		const FTransform ActorTransform = Owner->GetActorTransform();
+		const TArray<FTransform>& Instances = Owner->SharedFoliage[Range.SharedFoliageIndex].Instances;
+		WorldTransforms.Reserve(WorldTransforms.Num() + Instances.Num());
+
+		for (const FTransform& Instance : Instances)
+		{
+			const FTransform& WorldTransform = WorldTransforms.Add_GetRef(Instance * ActorTransform);
+			Range.Bounds += MeshBounds.TransformBy(WorldTransform);
+		}
+
+		Range.InstanceCount = Instances.Num();
+		Ranges.Add(Range);
+	}
+
+	Cell.Ranges = MoveTemp(Ranges);
+
+	Cell.Component->ReplaceInstancesFrom(FirstChanged, WorldTransforms, true);
+	Cell.Component->RebuildClusterTree();
+}
+
+UTableauHISMComponent* UTableauFoliageSubsystem::CreateCellComponent(const FSoftObjectPath& FoliageType)
+{
+	const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh = Cast<UFoliageType_InstancedStaticMesh>(FoliageType.TryLoad());
+	if (FoliageType_InstancedStaticMesh == nullptr)
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Unable to load Foliage Type %s for shared Tableau foliage."), *FoliageType.ToString());
+		return nullptr;
+	}
+
+	if (HostActor == nullptr || HostActor->IsPendingKillPending())
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+#if WITH_EDITOR
+		SpawnParameters.bHideFromSceneOutliner = true;
+#endif
+		HostActor = GetWorld()->SpawnActor<AActor>(SpawnParameters);
+
+		USceneComponent* RootComponent = NewObject<USceneComponent>(HostActor, TEXT("Root"), RF_Transient);
+		RootComponent->SetMobility(EComponentMobility::Static);
+		HostActor->SetRootComponent(RootComponent);
+		RootComponent->RegisterComponent();
+	}
+
+	UTableauHISMComponent* Component = NewObject<UTableauHISMComponent>(HostActor, NAME_None, RF_Transient);
+	Component->FoliageType = FoliageType;
+	Component->ConfigureFromFoliageType(FoliageType_InstancedStaticMesh);
+	Component->SetupAttachment(HostActor->GetRootComponent());
+	Component->RegisterComponent();
+
+	CellComponents.Add(Component);
+	return Component;
+}
+
+void UTableauFoliageSubsystem::ScheduleFlush()
+{
+	if (FlushTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UTableauFoliageSubsystem> WeakThis(this);
+	FlushTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+		{
+			if (UTableauFoliageSubsystem* FoliageSubsystem = WeakThis.Get())
+			{
+				FoliageSubsystem->FlushTickerHandle.Reset();
+				FoliageSubsystem->FlushDirtyCells();
+			}
+			return false;
+		}));
+}
@@ -1,5 +1,8 @@
 #include "TableauHISMComponent.h"
 
+// Engine Includes
+#include "FoliageType_InstancedStaticMesh.h"
+
 UTableauHISMComponent::UTableauHISMComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bSnappable(true)
@@ -17,4 +20,252 @@ void UTableauHISMComponent::ExcludeFromHLOD()
 		ExcludeForSpecificHLODLevels.Add(HLODLevel);
 	}
 #endif
-}
\ No newline at end of file
+}
+
+void UTableauHISMComponent::AddInstancesInBulk(const TArray<FTransform>& InstanceTransforms, bool bWorldSpace)
+{
+	if (InstanceTransforms.Num() == 0)
+	{
+		return;
+	}
+
+	// Suppress the per change tree rebuild while the instances are added.
+	TGuardValue<bool> AutoRebuildGuard(bAutoRebuildTreeOnInstanceChanges, false);
+
+	if (bWorldSpace)
+	{
+		const FTransform ComponentTransform = GetComponentTransform();
+
+		TArray<FTransform> LocalTransforms;
+		LocalTransforms.Reserve(InstanceTransforms.Num());
+		for (const FTransform& InstanceTransform : InstanceTransforms)
+		{
+			LocalTransforms.Add(InstanceTransform.GetRelativeTransform(ComponentTransform));
+		}
+
+		AddInstances(LocalTransforms, false);
+	}
+	else
+	{
+		AddInstances(InstanceTransforms, false);
+	}
+}
+
+void UTableauHISMComponent::SetInstancesInBulk(const TArray<FTransform>& InstanceTransforms)
+{
+	if (InstanceTransforms.Num() > 0 && InstanceTransforms.Num() == GetInstanceCount())
+	{
+		TGuardValue<bool> AutoRebuildGuard(bAutoRebuildTreeOnInstanceChanges, false);
+		BatchUpdateInstancesTransforms(0, InstanceTransforms, false, true, true);
+	}
+	else
+	{
+		ClearInstances();
+		AddInstancesInBulk(InstanceTransforms);
+	}
+}
+
+void UTableauHISMComponent::ReplaceInstancesFrom(int32 StartInstance, const TArray<FTransform>& InstanceTransforms, bool bWorldSpace)
+{
+	TGuardValue<bool> AutoRebuildGuard(bAutoRebuildTreeOnInstanceChanges, false);
+
+	const int32 OldCount = GetInstanceCount();
+	const int32 NewCount = StartInstance + InstanceTransforms.Num();
+	const int32 UpdateCount = FMath::Clamp(OldCount - StartInstance, 0, InstanceTransforms.Num());
+
+	if (UpdateCount > 0)
+	{
+		const TArray<FTransform> UpdatedTransforms(InstanceTransforms.GetData(), UpdateCount);
+		BatchUpdateInstancesTransforms(StartInstance, UpdatedTransforms, bWorldSpace, true, true);
+	}
+
+	if (OldCount > NewCount)
+	{
+		// Removed last first, so that no instance is swapped into a removed slot.
+		TArray<int32> SurplusInstances;
+		SurplusInstances.Reserve(OldCount - NewCount);
+		for (int32 Index = OldCount - 1; Index >= NewCount; --Index)
+		{
+			SurplusInstances.Add(Index);
+		}
+		RemoveInstances(SurplusInstances);
+	}
+	else if (NewCount > OldCount)
+	{
+		const TArray<FTransform> AddedTransforms(InstanceTransforms.GetData() + UpdateCount, InstanceTransforms.Num() - UpdateCount);
+		AddInstancesInBulk(AddedTransforms, bWorldSpace);
+	}
+}
+
+void UTableauHISMComponent::RebuildClusterTree()
+{
+	BuildTreeIfOutdated(/*Async*/true, /*ForceUpdate*/true);
+}
+
+void UTableauHISMComponent::ConfigureFromFoliageType(const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh)
+{
+	if (FoliageType_InstancedStaticMesh)
+	{
+		bool bNeedsMarkRenderStateDirty = false;
+		bool bNeedsInvalidateLightingCache = false;
+
+		if (GetStaticMesh() != FoliageType_InstancedStaticMesh->GetStaticMesh())
+		{
+			SetStaticMesh(FoliageType_InstancedStaticMesh->GetStaticMesh());
+
+			bNeedsInvalidateLightingCache = true;
+			bNeedsMarkRenderStateDirty = true;
+		}
+
+		if (Mobility != FoliageType_InstancedStaticMesh->Mobility)
+		{
+			SetMobility(FoliageType_InstancedStaticMesh->Mobility);
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (InstanceStartCullDistance != FoliageType_InstancedStaticMesh->CullDistance.Min)
+		{
+			InstanceStartCullDistance = FoliageType_InstancedStaticMesh->CullDistance.Min;
+			bNeedsMarkRenderStateDirty = true;
+		}
+		if (InstanceEndCullDistance != FoliageType_InstancedStaticMesh->CullDistance.Max)
+		{
+			InstanceEndCullDistance = FoliageType_InstancedStaticMesh->CullDistance.Max;
+			bNeedsMarkRenderStateDirty = true;
+		}
+		if (CastShadow != FoliageType_InstancedStaticMesh->CastShadow)
+		{
+			CastShadow = FoliageType_InstancedStaticMesh->CastShadow;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bCastDynamicShadow != FoliageType_InstancedStaticMesh->bCastDynamicShadow)
+		{
+			bCastDynamicShadow = FoliageType_InstancedStaticMesh->bCastDynamicShadow;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bCastStaticShadow != FoliageType_InstancedStaticMesh->bCastStaticShadow)
+		{
+			bCastStaticShadow = FoliageType_InstancedStaticMesh->bCastStaticShadow;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (RuntimeVirtualTextures != FoliageType_InstancedStaticMesh->RuntimeVirtualTextures)
+		{
+			RuntimeVirtualTextures = FoliageType_InstancedStaticMesh->RuntimeVirtualTextures;
+			bNeedsMarkRenderStateDirty = true;
+		}
+		if (VirtualTextureRenderPassType != FoliageType_InstancedStaticMesh->VirtualTextureRenderPassType)
+		{
+			VirtualTextureRenderPassType = FoliageType_InstancedStaticMesh->VirtualTextureRenderPassType;
+			bNeedsMarkRenderStateDirty = true;
+		}
+		if (VirtualTextureCullMips != FoliageType_InstancedStaticMesh->VirtualTextureCullMips)
+		{
+			VirtualTextureCullMips = FoliageType_InstancedStaticMesh->VirtualTextureCullMips;
+			bNeedsMarkRenderStateDirty = true;
+		}
+		if (TranslucencySortPriority != FoliageType_InstancedStaticMesh->TranslucencySortPriority)
+		{
+			TranslucencySortPriority = FoliageType_InstancedStaticMesh->TranslucencySortPriority;
+			bNeedsMarkRenderStateDirty = true;
+		}
+		if (bAffectDynamicIndirectLighting != FoliageType_InstancedStaticMesh->bAffectDynamicIndirectLighting)
+		{
+			bAffectDynamicIndirectLighting = FoliageType_InstancedStaticMesh->bAffectDynamicIndirectLighting;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bAffectDistanceFieldLighting != FoliageType_InstancedStaticMesh->bAffectDistanceFieldLighting)
+		{
+			bAffectDistanceFieldLighting = FoliageType_InstancedStaticMesh->bAffectDistanceFieldLighting;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bCastShadowAsTwoSided != FoliageType_InstancedStaticMesh->bCastShadowAsTwoSided)
+		{
+			bCastShadowAsTwoSided = FoliageType_InstancedStaticMesh->bCastShadowAsTwoSided;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bReceivesDecals != FoliageType_InstancedStaticMesh->bReceivesDecals)
+		{
+			bReceivesDecals = FoliageType_InstancedStaticMesh->bReceivesDecals;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bOverrideLightMapRes != FoliageType_InstancedStaticMesh->bOverrideLightMapRes)
+		{
+			bOverrideLightMapRes = FoliageType_InstancedStaticMesh->bOverrideLightMapRes;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (OverriddenLightMapRes != FoliageType_InstancedStaticMesh->OverriddenLightMapRes)
+		{
+			OverriddenLightMapRes = FoliageType_InstancedStaticMesh->OverriddenLightMapRes;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (LightmapType != FoliageType_InstancedStaticMesh->LightmapType)
+		{
+			LightmapType = FoliageType_InstancedStaticMesh->LightmapType;
+			bNeedsMarkRenderStateDirty = true;
+			bNeedsInvalidateLightingCache = true;
+		}
+		if (bUseAsOccluder != FoliageType_InstancedStaticMesh->bUseAsOccluder)
+		{
+			bUseAsOccluder = FoliageType_InstancedStaticMesh->bUseAsOccluder;
+			bNeedsMarkRenderStateDirty = true;
+		}
+
+		if (bEnableDensityScaling != FoliageType_InstancedStaticMesh->bEnableDensityScaling)
+		{
+			bEnableDensityScaling = FoliageType_InstancedStaticMesh->bEnableDensityScaling;
+
+			UpdateDensityScaling();
+
+			bNeedsMarkRenderStateDirty = true;
+		}
+
+		if (GetLightingChannelMaskForStruct(LightingChannels) != GetLightingChannelMaskForStruct(FoliageType_InstancedStaticMesh->LightingChannels))
+		{
+			LightingChannels = FoliageType_InstancedStaticMesh->LightingChannels;
+			bNeedsMarkRenderStateDirty = true;
+		}
+
+		if (bRenderCustomDepth != FoliageType_InstancedStaticMesh->bRenderCustomDepth)
+		{
+			bRenderCustomDepth = FoliageType_InstancedStaticMesh->bRenderCustomDepth;
+			bNeedsMarkRenderStateDirty = true;
+		}
+
+		if (CustomDepthStencilValue != FoliageType_InstancedStaticMesh->CustomDepthStencilValue)
+		{
+			CustomDepthStencilValue = FoliageType_InstancedStaticMesh->CustomDepthStencilValue;
+			bNeedsMarkRenderStateDirty = true;
+		}
+
+		if (FoliageType_InstancedStaticMesh->AlignToNormal)
+		{
+			bAlignToNormal = true;
+		}
+
+		GroundSlopeAngle = FoliageType_InstancedStaticMesh->GroundSlopeAngle;
+
+		BodyInstance.CopyBodyInstancePropertiesFrom(&FoliageType_InstancedStaticMesh->BodyInstance);
+
+		SetCustomNavigableGeometry(FoliageType_InstancedStaticMesh->CustomNavigableGeometry);
+
+		if (bNeedsInvalidateLightingCache)
+		{
+			InvalidateLightingCache();
+		}
+
+		if (bNeedsMarkRenderStateDirty)
+		{
+			MarkRenderStateDirty();
+		}
+	}
+
+}
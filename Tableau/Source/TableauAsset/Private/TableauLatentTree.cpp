@@ -1,16 +1,69 @@
 #include "TableauLatentTree.h"
 
+// Engine Includes
+#include "FoliageType_InstancedStaticMesh.h"
+
 // Local Includes
-#include "TableauUtils.h"
+#include "TableauAssetModule.h"
+#include "TableauEvaluationContext.h"
+
+
+//////////////////////////////////////////////////
+// FTableauEvaluationUtils
+
+void FTableauEvaluationUtils::JitterTransform(uint32 Seed, float MinScale, float MaxScale, bool bSpinZAxis, FTransform& Transform)
+{
+	
+	// Set the transform to origin for application of jitter.
+	const FVector Location = Transform.GetLocation();
+	Transform.SetLocation(FVector::ZeroVector);
+
+	// Apply scale jitter
+	if (FMath::IsNearlyZero(abs(MinScale-MaxScale)))
+	{
+		Transform.MultiplyScale3D(FVector(MinScale,MinScale,MinScale));
+	}
+	else
+	{
+		static const int32 SeedOffsetForScale = FTableauEvaluationUtils::NextSeed(Seed);
+		FRandomStream Stream(Seed+ SeedOffsetForScale);
+
+		const float Scale = Stream.FRand()*(MaxScale-MinScale) + MinScale;
+		Transform.MultiplyScale3D(FVector(Scale, Scale, Scale));
+	}
 
+	// Rotation may be assigned a random spin about Z axis
+	if (bSpinZAxis)
+	{
+		static const int32 SeedOffsetForRotation = FTableauEvaluationUtils::NextSeed(FTableauEvaluationUtils::NextSeed(Seed));
+		FRandomStream Stream(Seed + SeedOffsetForRotation);
+
+		const FQuat Rotate(FVector::UpVector, Stream.FRand() * 2.0 * PI);
+		Transform *= Rotate;
+	}
+
+	// Bring transform back to position.
+	Transform.AddToTranslation(Location);
+}
+
+int32 FTableauEvaluationUtils::NextSeed(int32 Seed)
+{
+	FRandomStream Stream(Seed);
+
+	// Advance the seed
+	Stream.GetUnsignedInt();
+
+	return Stream.GetCurrentSeed();
+}
 
 
 //////////////////////////////////////////////////
 // FTableauLatentTree
 
-FTableauLatentTree::FTableauLatentTree(const UTableauAsset* InTableauAsset, TSharedPtr<FTableauFilterSampler> InFilter, bool bUseAssetEditorMode)
+FTableauLatentTree::FTableauLatentTree(const UTableauAsset* InTableauAsset, TSharedPtr<FTableauFilterSampler> InFilter, bool bUseAssetEditorMode, TSharedPtr<const FTableauEvaluationContext> InContext)
 	: TableauAsset(InTableauAsset)
 	, Filter(InFilter)
+	, Context(InContext)
 	, bAssetEditorMode(bUseAssetEditorMode)
 {
 }
@@ -46,10 +99,13 @@ TMap<UFoliageType*, TUniquePtr<FTableauFoliage>>& FTableauLatentTree::GetFoliage
 FTableauRecipeNode* FTableauLatentTree::EvaluateTableau(const FTableauAssetElement& TableauElement, const FTransform& CurrXform, int32 LocalSeed, TArray<FTableauRecipeNode>& CurrRecipe, TArray<UTableauAsset*> EvaluationHistory)
 {
 
+	// The element belongs to the Tableau most recently entered, which holds its captured config.
+	const UTableauAsset* OwningAsset = (EvaluationHistory.Num() > 0) ? EvaluationHistory.Last() : nullptr;
+
 	FSoftObjectPath Ref = TableauElement.AssetReference;
 	if (!Ref.IsAsset())
 	{
-		return EvaluateLeafElement(TableauElement, CurrXform, CurrRecipe);
+		return EvaluateLeafElement(TableauElement, OwningAsset, CurrXform, CurrRecipe);
 	}
 	else
 	{
@@ -100,8 +156,8 @@ FTableauRecipeNode* FTableauLatentTree::EvaluateTableau(const FTableauAssetEleme
 								LocalSeed = Element->Seed - 1;
 							}
 							FTransform LocalTransform(Element->LocalTransform * CurrXform);
-							FTableauUtils::JitterTransform(LocalSeed, Element->MinScaleJitter, Element->MaxScaleJitter, Element->bSpinZAxis, LocalTransform);
-							return EvaluateTableau(*Element, LocalTransform, FTableauUtils::NextSeed(LocalSeed), CurrRecipe, EvaluationHistory);
+							FTableauEvaluationUtils::JitterTransform(LocalSeed, Element->MinScaleJitter, Element->MaxScaleJitter, Element->bSpinZAxis, LocalTransform);
+							return EvaluateTableau(*Element, LocalTransform, FTableauEvaluationUtils::NextSeed(LocalSeed), CurrRecipe, EvaluationHistory);
 						}
 						else
 						{
@@ -158,19 +214,26 @@ FTableauRecipeNode* FTableauLatentTree::EvaluateTableau(const FTableauAssetEleme
 				
 				// convert to static mesh
 				const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh = Cast<UFoliageType_InstancedStaticMesh>(FoliageType);
-				Object = FoliageType_InstancedStaticMesh->GetStaticMesh();
+				if (FoliageType_InstancedStaticMesh == nullptr)
+				{
+					return nullptr;
+				}
+
+				FTableauRecipeNode* RecipeNode = EvaluateLeafElement(TableauElement, OwningAsset, CurrXform, CurrRecipe, FoliageType_InstancedStaticMesh->GetStaticMesh());
+				RecipeNode->FoliageType = FoliageType;
+				return RecipeNode;
 			}
 
 			// Produce a recipe node.
-			return EvaluateLeafElement(TableauElement, CurrXform, CurrRecipe, Object);
+			return EvaluateLeafElement(TableauElement, OwningAsset, CurrXform, CurrRecipe, Object);
 			
 		}
 	}
 }
 
-FTableauRecipeNode* FTableauLatentTree::EvaluateLeafElement(const FTableauAssetElement& TableauElement, const FTransform& CurrXform, TArray<FTableauRecipeNode>& CurrRecipe, UObject* Asset)
+FTableauRecipeNode* FTableauLatentTree::EvaluateLeafElement(const FTableauAssetElement& TableauElement, const UTableauAsset* OwningAsset, const FTransform& CurrXform, TArray<FTableauRecipeNode>& CurrRecipe, UObject* Asset)
 {
-	CurrRecipe.Add(ConvertTableauElementToRecipeNode(TableauElement, CurrXform, Asset));
+	CurrRecipe.Add(ConvertTableauElementToRecipeNode(TableauElement, OwningAsset, CurrXform, Asset));
 	return &CurrRecipe.Last();
 }
 
@@ -184,7 +247,7 @@ FTableauRecipeNode* FTableauLatentTree::EvaluateCompositeElement(UTableauAsset*
 	FTableauRecipeNode* FirstRecipe = nullptr;
 	for (; FirstManifest < InTableauAsset->TableauElement.Num(); ++FirstManifest)
 	{
-		Seed = FTableauUtils::NextSeed(Seed);
+		Seed = FTableauEvaluationUtils::NextSeed(Seed);
 		FVector Location = (InTableauAsset->TableauElement[FirstManifest].LocalTransform * CurrXform).GetLocation();
 		if (Filter->Sample(Location))
 		{
@@ -196,7 +259,7 @@ FTableauRecipeNode* FTableauLatentTree::EvaluateCompositeElement(UTableauAsset*
 			if (FuzzyTrue(InTableauAsset->TableauElement[FirstManifest].Weight, Seed))
 			{
 				FTransform LocalTransform(InTableauAsset->TableauElement[FirstManifest].LocalTransform * CurrXform);
-				FTableauUtils::JitterTransform(Seed, InTableauAsset->TableauElement[FirstManifest].MinScaleJitter, InTableauAsset->TableauElement[FirstManifest].MaxScaleJitter, InTableauAsset->TableauElement[FirstManifest].bSpinZAxis, LocalTransform);
+				FTableauEvaluationUtils::JitterTransform(Seed, InTableauAsset->TableauElement[FirstManifest].MinScaleJitter, InTableauAsset->TableauElement[FirstManifest].MaxScaleJitter, InTableauAsset->TableauElement[FirstManifest].bSpinZAxis, LocalTransform);
 				FirstRecipe = EvaluateTableau(InTableauAsset->TableauElement[FirstManifest], LocalTransform, Seed, CurrRecipe, EvaluationHistory);
 				if (FirstRecipe)
 				{
@@ -209,7 +272,7 @@ FTableauRecipeNode* FTableauLatentTree::EvaluateCompositeElement(UTableauAsset*
 	// Evaluate the remaining elements.
 	for (int32 Index = FirstManifest + 1; Index < InTableauAsset->TableauElement.Num(); ++Index)
 	{
-		Seed = FTableauUtils::NextSeed(Seed);
+		Seed = FTableauEvaluationUtils::NextSeed(Seed);
 		FVector Location = (InTableauAsset->TableauElement[FirstManifest].LocalTransform * CurrXform).GetLocation();
 		if (Filter->Sample(Location))
 		{
@@ -221,7 +284,7 @@ FTableauRecipeNode* FTableauLatentTree::EvaluateCompositeElement(UTableauAsset*
 			if (FuzzyTrue(InTableauAsset->TableauElement[Index].Weight, Seed))
 			{
 				FTransform LocalTransform(InTableauAsset->TableauElement[Index].LocalTransform * CurrXform);
-				FTableauUtils::JitterTransform(Seed, InTableauAsset->TableauElement[Index].MinScaleJitter, InTableauAsset->TableauElement[Index].MaxScaleJitter, InTableauAsset->TableauElement[Index].bSpinZAxis, LocalTransform);
+				FTableauEvaluationUtils::JitterTransform(Seed, InTableauAsset->TableauElement[Index].MinScaleJitter, InTableauAsset->TableauElement[Index].MaxScaleJitter, InTableauAsset->TableauElement[Index].bSpinZAxis, LocalTransform);
 
 				if (bHierarchical)
 				{
@@ -244,11 +307,7 @@ const FTableauAssetElement* FTableauLatentTree::SelectRandomElement(const UTable
 	check(InTableauAsset->TableauElement.Num() > 0);
 
 	// Find total weight
-	float TotalWeight = InTableauAsset->NothingWeight;
-	for (const FTableauAssetElement& TableauElement : InTableauAsset->TableauElement)
-	{
-		TotalWeight += TableauElement.Weight;
-	}
+	const float TotalWeight = GetTotalWeight(InTableauAsset);
 
 	// Get a weighted random index
 	FRandomStream Stream(LocalSeed);
@@ -276,8 +335,33 @@ const FTableauAssetElement* FTableauLatentTree::SelectRandomElement(const UTable
 
 }
 
+float FTableauLatentTree::GetTotalWeight(const UTableauAsset* InTableauAsset) const
+{
+	// Use the precomputed weight if the asset has been compiled.
+	if (Context.IsValid())
+	{
+		if (const FTableauCompiledAsset* CompiledAsset = Context->FindCompiledAsset(InTableauAsset))
+		{
+			return CompiledAsset->TotalWeight;
+		}
+	}
+
+	float TotalWeight = InTableauAsset->NothingWeight;
+	for (const FTableauAssetElement& TableauElement : InTableauAsset->TableauElement)
+	{
+		TotalWeight += TableauElement.Weight;
+	}
+	return TotalWeight;
+}
+
 UObject* FTableauLatentTree::SafelyResolveSoftPath(const FSoftObjectPath& path) const
 {
+	// Assets loaded up front by the Evaluation Context need no further resolution.
+	if (Context.IsValid())
+	{
+		return Context->ResolveAsset(path);
+	}
+
 	FSoftObjectPtr SoftObjectPtr(path);
 	if (SoftObjectPtr.IsValid())
 	{
@@ -289,7 +373,7 @@ UObject* FTableauLatentTree::SafelyResolveSoftPath(const FSoftObjectPath& path)
 	}
 }
 
-FTableauRecipeNode FTableauLatentTree::ConvertTableauElementToRecipeNode(const FTableauAssetElement& TableauElement, const FTransform& Transform, UObject* Asset) const
+FTableauRecipeNode FTableauLatentTree::ConvertTableauElementToRecipeNode(const FTableauAssetElement& TableauElement, const UTableauAsset* OwningAsset, const FTransform& Transform, UObject* Asset) const
 {
 	FTableauRecipeNode RecipeNode;
 	RecipeNode.Name = TableauElement.Name;
@@ -299,7 +383,11 @@ FTableauRecipeNode FTableauLatentTree::ConvertTableauElementToRecipeNode(const F
 
 	if (RecipeNode.bUseConfig)
 	{
-		RecipeNode.AssetConfig = TableauElement.AssetConfig;
+		RecipeNode.ConfigOwner = OwningAsset;
+		if (OwningAsset && OwningAsset->ConfigTable.IsValidIndex(TableauElement.ConfigIndex))
+		{
+			RecipeNode.ConfigHash = OwningAsset->ConfigTable[TableauElement.ConfigIndex].ContentHash;
+		}
 	}
 	else
 	{
@@ -0,0 +1,373 @@
+#include "TableauRuntimeSubsystem.h"
+
+// Engine Includes
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "FoliageType_InstancedStaticMesh.h"
+#include "HAL/IConsoleManager.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+#include "TableauComponent.h"
+#include "TableauHISMComponent.h"
+#include "TableauLatentTree.h"
+#include "TableauEvaluationContext.h"
+
+static TAutoConsoleVariable<int32> CVarTableauRuntimeInstancesPerFrame(
+	TEXT("Tableau.RuntimeInstancesPerFrame"),
+	50000,
+	TEXT("Number of instances from completed runtime Tableau evaluations added to instanced components per frame. At least one evaluation is applied each frame, however many instances it holds."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTableauRuntimeComponentPoolSize(
+	TEXT("Tableau.RuntimeComponentPoolSize"),
+	256,
+	TEXT("Maximum number of cleared runtime Tableau HISMs kept for reuse."),
+	ECVF_Default);
+
+
+//////////////////////////////////////////////////
+// UTableauRuntimeSubsystem
+
+void UTableauRuntimeSubsystem::Deinitialize()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	// Let the tasks in flight finish before releasing what they reference.
+	for (FEvaluation& Evaluation : Evaluations)
+	{
+		Evaluation.Future.Wait();
+	}
+	Evaluations.Empty();
+	PendingComponents.Empty();
+	PooledComponents.Empty();
+
+	if (HostActor && !HostActor->IsPendingKillPending())
+	{
+		HostActor->Destroy();
+	}
+	HostActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UTableauRuntimeSubsystem::RequestEvaluation(UTableauComponent* TableauComponent)
+{
+	if (TableauComponent == nullptr || TableauComponent->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	PendingComponents.AddUnique(TableauComponent);
+	ScheduleTick();
+}
+
+void UTableauRuntimeSubsystem::ReleaseEvaluation(UTableauComponent* TableauComponent)
+{
+	PendingComponents.Remove(TableauComponent);
+
+	// Orphan any evaluation in flight. It is discarded once its task completes.
+	for (FEvaluation& Evaluation : Evaluations)
+	{
+		if (Evaluation.TableauComponent.Get() == TableauComponent)
+		{
+			Evaluation.TableauComponent.Reset();
+		}
+	}
+
+	ReleaseRuntimeComponents(TableauComponent);
+}
+
+bool UTableauRuntimeSubsystem::IsEvaluationPending(const UTableauComponent* TableauComponent) const
+{
+	if (PendingComponents.Contains(TableauComponent))
+	{
+		return true;
+	}
+
+	for (const FEvaluation& Evaluation : Evaluations)
+	{
+		if (Evaluation.TableauComponent.Get() == TableauComponent)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UTableauRuntimeSubsystem::ScheduleTick()
+{
+	if (TickerHandle.IsValid())
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UTableauRuntimeSubsystem> WeakThis(this);
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+		{
+			if (UTableauRuntimeSubsystem* RuntimeSubsystem = WeakThis.Get())
+			{
+				return RuntimeSubsystem->Tick(DeltaTime);
+			}
+			return false;
+		}));
+}
+
+bool UTableauRuntimeSubsystem::Tick(float DeltaTime)
+{
+	LaunchPendingEvaluations();
+
+	// Apply completed evaluations in the order they were launched, up to the per frame instance budget.
+	int32 Budget = FMath::Max(CVarTableauRuntimeInstancesPerFrame.GetValueOnGameThread(), 1);
+	for (int32 Index = 0; Index < Evaluations.Num() && Budget > 0;)
+	{
+		if (!Evaluations[Index].Future.IsReady())
+		{
+			++Index;
+			continue;
+		}
+
+		// Orphaned evaluations are simply discarded, without spending the budget.
+		if (Evaluations[Index].TableauComponent.IsValid())
+		{
+			ApplyEvaluation(Evaluations[Index]);
+			Budget -= FMath::Max(Evaluations[Index].Result->NumInstances, 1);
+		}
+		Evaluations.RemoveAt(Index);
+	}
+
+	if (Evaluations.Num() == 0 && PendingComponents.Num() == 0)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void UTableauRuntimeSubsystem::LaunchPendingEvaluations()
+{
+	if (PendingComponents.Num() == 0)
+	{
+		return;
+	}
+
+	// Load everything the requested Tableaux reference once, on the game thread.
+	TSharedPtr<FTableauEvaluationContext> Context = MakeShareable(new FTableauEvaluationContext(GetWorld()));
+	for (const TWeakObjectPtr<UTableauComponent>& TableauComponent : PendingComponents)
+	{
+		if (TableauComponent.IsValid())
+		{
+			Context->AddTableau(TableauComponent->GetTableau());
+		}
+	}
+
+	for (const TWeakObjectPtr<UTableauComponent>& TableauComponent : PendingComponents)
+	{
+		if (!TableauComponent.IsValid() || TableauComponent->GetTableau() == nullptr || TableauComponent->GetOwner() == nullptr)
+		{
+			continue;
+		}
+
+#if !WITH_EDITOR
+		// Weightmaps can't be read outside the editor, so the filter would keep everything.
+		if (TableauComponent->FilterWeightmaps.Num() > 0)
+		{
+			UE_LOG(LogTableau, Warning, TEXT("%s filters by landscape weightmap, which can't be sampled at runtime. It was not evaluated."), *TableauComponent->GetPathName());
+			continue;
+		}
+#endif
+
+		TSharedPtr<FTableauFilterSampler> Filter = FTableauFilterSampler::GatherFilters(TableauComponent.Get(), GetWorld(), Context.Get());
+
+		FEvaluation& Evaluation = Evaluations.AddDefaulted_GetRef();
+		Evaluation.TableauComponent = TableauComponent;
+		Evaluation.LatentTree = MakeShareable(new FTableauLatentTree(TableauComponent->GetTableau(), Filter, false, Context));
+		Evaluation.Result = MakeShareable(new FEvaluationResult);
+
+		// The task only borrows the latent tree and result; both outlive it.
+		FTableauLatentTree* LatentTree = Evaluation.LatentTree.Get();
+		FEvaluationResult* Result = Evaluation.Result.Get();
+		const int32 Seed = TableauComponent->Seed;
+		const FTransform TableauSpace = TableauComponent->GetOwner()->ActorToWorld();
+		TUniqueFunction<void()> Evaluate = [LatentTree, Result, Seed, TableauSpace]()
+			{
+				LatentTree->EvaluateLatentTree(Seed);
+				GatherInstances(*LatentTree, TableauSpace, *Result);
+			};
+
+		// Filters that trace the scene or read actors are only safe on the game thread, so their Tableaux are
+		// evaluated here. The result is still applied in launch order, against the same budget.
+		if (Filter->IsThreadSafe())
+		{
+			Evaluation.Future = Async(EAsyncExecution::ThreadPool, MoveTemp(Evaluate));
+		}
+		else
+		{
+			Evaluate();
+
+			TPromise<void> Completed;
+			Completed.SetValue();
+			Evaluation.Future = Completed.GetFuture();
+		}
+	}
+
+	PendingComponents.Empty();
+}
+
+void UTableauRuntimeSubsystem::ApplyEvaluation(FEvaluation& Evaluation)
+{
+	UTableauComponent* TableauComponent = Evaluation.TableauComponent.Get();
+	if (TableauComponent == nullptr || TableauComponent->IsPendingKill())
+	{
+		return;
+	}
+
+	ReleaseRuntimeComponents(TableauComponent);
+
+	for (TPair<UStaticMesh*, TArray<FTransform>>& MeshInstances : Evaluation.Result->MeshInstances)
+	{
+		if (UTableauHISMComponent* Component = AcquireComponent(MeshInstances.Key, nullptr))
+		{
+			Component->AddInstancesInBulk(MeshInstances.Value, true);
+			Component->RebuildClusterTree();
+			TableauComponent->RuntimeComponents.Add(Component);
+		}
+	}
+
+	for (TPair<UFoliageType*, TArray<FTransform>>& FoliageInstances : Evaluation.Result->FoliageInstances)
+	{
+		if (UTableauHISMComponent* Component = AcquireComponent(nullptr, FoliageInstances.Key))
+		{
+			Component->AddInstancesInBulk(FoliageInstances.Value, true);
+			Component->RebuildClusterTree();
+			TableauComponent->RuntimeComponents.Add(Component);
+		}
+	}
+
+	if (Evaluation.Result->SkippedNodes > 0)
+	{
+		UE_LOG(LogTableau, Log, TEXT("%d elements of %s can't be instanced at runtime and were skipped."), Evaluation.Result->SkippedNodes, *TableauComponent->GetTableau()->GetName());
+	}
+}
+
+void UTableauRuntimeSubsystem::GatherInstances(FTableauLatentTree& LatentTree, const FTransform& TableauSpace, FEvaluationResult& Result)
+{
+	// Subordinate recipes are only expressed beneath configured actors, which can't be instanced, so only the
+	// top level of the Recipe is gathered. This matches what the editor spawns for the same Recipe.
+	for (const FTableauRecipeNode& RecipeNode : LatentTree.Recipe)
+	{
+		UStaticMesh* StaticMesh = RecipeNode.bUseConfig ? nullptr : Cast<UStaticMesh>(RecipeNode.AssetReference.Get());
+		if (StaticMesh)
+		{
+			Result.MeshInstances.FindOrAdd(StaticMesh).Add(RecipeNode.LocalTransform * TableauSpace);
+			++Result.NumInstances;
+		}
+		else
+		{
+			++Result.SkippedNodes;
+		}
+	}
+
+	for (TPair<UFoliageType*, TUniquePtr<FTableauFoliage>>& Foliage : LatentTree.GetFoliages())
+	{
+		TArray<FTransform>& Instances = Result.FoliageInstances.FindOrAdd(Foliage.Key);
+		Instances.Reserve(Instances.Num() + Foliage.Value->GetInstances().Num());
+		for (const FTransform& Instance : Foliage.Value->GetInstances())
+		{
+			Instances.Add(Instance * TableauSpace);
+		}
+		Result.NumInstances += Foliage.Value->GetInstances().Num();
+	}
+}
+
+UTableauHISMComponent* UTableauRuntimeSubsystem::AcquireComponent(UStaticMesh* StaticMesh, UFoliageType* FoliageType)
+{
+	const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh = Cast<UFoliageType_InstancedStaticMesh>(FoliageType);
+	if (FoliageType && FoliageType_InstancedStaticMesh == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FSoftObjectPath FoliageTypePath(FoliageType_InstancedStaticMesh);
+	if (FoliageType_InstancedStaticMesh)
+	{
+		StaticMesh = FoliageType_InstancedStaticMesh->GetStaticMesh();
+	}
+
+	// A pooled component is reused as is if it was configured for the same source.
+	for (int32 Index = PooledComponents.Num() - 1; Index >= 0; --Index)
+	{
+		UTableauHISMComponent* PooledComponent = PooledComponents[Index];
+		if (PooledComponent && PooledComponent->FoliageType == FoliageTypePath && PooledComponent->GetStaticMesh() == StaticMesh)
+		{
+			PooledComponents.RemoveAtSwap(Index);
+			return PooledComponent;
+		}
+	}
+
+	if (HostActor == nullptr || HostActor->IsPendingKillPending())
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+#if WITH_EDITOR
+		SpawnParameters.bHideFromSceneOutliner = true;
+#endif
+		HostActor = GetWorld()->SpawnActor<AActor>(SpawnParameters);
+
+		USceneComponent* RootComponent = NewObject<USceneComponent>(HostActor, TEXT("Root"), RF_Transient);
+		RootComponent->SetMobility(EComponentMobility::Static);
+		HostActor->SetRootComponent(RootComponent);
+		RootComponent->RegisterComponent();
+	}
+
+	UTableauHISMComponent* Component = NewObject<UTableauHISMComponent>(HostActor, NAME_None, RF_Transient);
+	if (FoliageType_InstancedStaticMesh)
+	{
+		Component->FoliageType = FoliageTypePath;
+		Component->ConfigureFromFoliageType(FoliageType_InstancedStaticMesh);
+	}
+	else
+	{
+		Component->SetStaticMesh(StaticMesh);
+	}
+	Component->SetupAttachment(HostActor->GetRootComponent());
+	Component->RegisterComponent();
+
+	return Component;
+}
+
+void UTableauRuntimeSubsystem::ReleaseRuntimeComponents(UTableauComponent* TableauComponent)
+{
+	if (TableauComponent == nullptr)
+	{
+		return;
+	}
+
+	const int32 MaxPoolSize = FMath::Max(CVarTableauRuntimeComponentPoolSize.GetValueOnGameThread(), 0);
+	for (UTableauHISMComponent* Component : TableauComponent->RuntimeComponents)
+	{
+		if (Component == nullptr || Component->IsPendingKill())
+		{
+			continue;
+		}
+
+		if (PooledComponents.Num() < MaxPoolSize)
+		{
+			Component->ClearInstances();
+			PooledComponents.Add(Component);
+		}
+		else
+		{
+			Component->DestroyComponent(false);
+		}
+	}
+	TableauComponent->RuntimeComponents.Empty();
+}
@@ -0,0 +1,254 @@
+#include "TableauStreamingSubsystem.h"
+
+// Engine Includes
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+// Local Includes
+#include "TableauAssetModule.h"
+#include "TableauComponent.h"
+#include "TableauRuntimeSubsystem.h"
+
+static TAutoConsoleVariable<float> CVarTableauStreamingCellSize(
+	TEXT("Tableau.StreamingCellSize"),
+	25600.0f,
+	TEXT("Size of the grid cells used to stream runtime Tableau content."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTableauStreamingLoadRadius(
+	TEXT("Tableau.StreamingLoadRadius"),
+	51200.0f,
+	TEXT("Distance from a streaming source within which Tableau cells are loaded."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTableauStreamingUnloadHysteresis(
+	TEXT("Tableau.StreamingUnloadHysteresis"),
+	12800.0f,
+	TEXT("Distance beyond the load radius that a Tableau cell must be from every streaming source to be released."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTableauStreamingUpdateInterval(
+	TEXT("Tableau.StreamingUpdateInterval"),
+	0.25f,
+	TEXT("Seconds between updates of the streamed Tableau cells."),
+	ECVF_Default);
+
+
+//////////////////////////////////////////////////
+// UTableauStreamingSubsystem
+
+void UTableauStreamingSubsystem::Deinitialize()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	Cells.Empty();
+	ComponentCells.Empty();
+	AdditionalSources.Empty();
+
+	Super::Deinitialize();
+}
+
+void UTableauStreamingSubsystem::RegisterTableau(UTableauComponent* TableauComponent)
+{
+	UnregisterTableau(TableauComponent);
+
+	if (TableauComponent == nullptr || TableauComponent->GetOwner() == nullptr || TableauComponent->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	if (Cells.Num() == 0)
+	{
+		CellSize = FMath::Max(CVarTableauStreamingCellSize.GetValueOnGameThread(), 100.0f);
+	}
+
+	const FIntPoint CellCoord = GetCell(TableauComponent->GetOwner()->GetActorLocation());
+	FCell& Cell = Cells.FindOrAdd(CellCoord);
+	Cell.Components.Add(TableauComponent);
+	ComponentCells.Add(TableauComponent, CellCoord);
+
+	// A Component joining a loaded cell is evaluated straight away.
+	if (Cell.bLoaded)
+	{
+		if (UTableauRuntimeSubsystem* RuntimeSubsystem = GetWorld()->GetSubsystem<UTableauRuntimeSubsystem>())
+		{
+			RuntimeSubsystem->RequestEvaluation(TableauComponent);
+		}
+	}
+
+	if (!TickerHandle.IsValid())
+	{
+		// Update on the next tick rather than waiting for the interval to elapse.
+		TimeSinceUpdate = TNumericLimits<float>::Max();
+
+		TWeakObjectPtr<UTableauStreamingSubsystem> WeakThis(this);
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+			{
+				if (UTableauStreamingSubsystem* StreamingSubsystem = WeakThis.Get())
+				{
+					return StreamingSubsystem->Tick(DeltaTime);
+				}
+				return false;
+			}));
+	}
+}
+
+void UTableauStreamingSubsystem::UnregisterTableau(UTableauComponent* TableauComponent)
+{
+	FIntPoint CellCoord;
+	if (!ComponentCells.RemoveAndCopyValue(TableauComponent, CellCoord))
+	{
+		return;
+	}
+
+	if (FCell* Cell = Cells.Find(CellCoord))
+	{
+		Cell->Components.RemoveAll([TableauComponent](const TWeakObjectPtr<UTableauComponent>& Component)
+			{
+				return Component.Get() == TableauComponent || !Component.IsValid();
+			});
+
+		if (Cell->Components.Num() == 0)
+		{
+			Cells.Remove(CellCoord);
+		}
+	}
+
+	if (UTableauRuntimeSubsystem* RuntimeSubsystem = GetWorld()->GetSubsystem<UTableauRuntimeSubsystem>())
+	{
+		RuntimeSubsystem->ReleaseEvaluation(TableauComponent);
+	}
+}
+
+void UTableauStreamingSubsystem::SetStreamingSource(const FName& SourceName, const FVector& Location)
+{
+	AdditionalSources.Add(SourceName, Location);
+}
+
+void UTableauStreamingSubsystem::RemoveStreamingSource(const FName& SourceName)
+{
+	AdditionalSources.Remove(SourceName);
+}
+
+bool UTableauStreamingSubsystem::Tick(float DeltaTime)
+{
+	if (Cells.Num() == 0)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate >= CVarTableauStreamingUpdateInterval.GetValueOnGameThread())
+	{
+		TimeSinceUpdate = 0.0f;
+		UpdateStreaming();
+	}
+
+	return true;
+}
+
+void UTableauStreamingSubsystem::UpdateStreaming()
+{
+	TArray<FVector> Sources;
+	GatherStreamingSources(Sources);
+
+	const float LoadRadius = FMath::Max(CVarTableauStreamingLoadRadius.GetValueOnGameThread(), 0.0f);
+	const float UnloadRadius = LoadRadius + FMath::Max(CVarTableauStreamingUnloadHysteresis.GetValueOnGameThread(), 0.0f);
+
+	// Cells to load, with their distance from the nearest source, so that the nearest are evaluated first.
+	TArray<TPair<float, FIntPoint>> CellsToLoad;
+
+	for (TPair<FIntPoint, FCell>& CellPair : Cells)
+	{
+		const FBox2D CellBounds(FVector2D(CellPair.Key) * CellSize, FVector2D(CellPair.Key + FIntPoint(1, 1)) * CellSize);
+
+		float NearestDistanceSquared = TNumericLimits<float>::Max();
+		for (const FVector& Source : Sources)
+		{
+			NearestDistanceSquared = FMath::Min(NearestDistanceSquared, CellBounds.ComputeSquaredDistanceToPoint(FVector2D(Source)));
+		}
+
+		FCell& Cell = CellPair.Value;
+		if (!Cell.bLoaded && NearestDistanceSquared <= FMath::Square(LoadRadius))
+		{
+			CellsToLoad.Add(TPair<float, FIntPoint>(NearestDistanceSquared, CellPair.Key));
+		}
+		else if (Cell.bLoaded && NearestDistanceSquared > FMath::Square(UnloadRadius))
+		{
+			UnloadCell(Cell);
+		}
+	}
+
+	CellsToLoad.Sort([](const TPair<float, FIntPoint>& A, const TPair<float, FIntPoint>& B)
+		{
+			return A.Key < B.Key;
+		});
+
+	for (const TPair<float, FIntPoint>& CellToLoad : CellsToLoad)
+	{
+		LoadCell(Cells.FindChecked(CellToLoad.Value));
+	}
+}
+
+FIntPoint UTableauStreamingSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void UTableauStreamingSubsystem::GatherStreamingSources(TArray<FVector>& OutSources) const
+{
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		if (const APlayerController* PlayerController = Iterator->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			OutSources.Add(ViewLocation);
+		}
+	}
+
+	for (const TPair<FName, FVector>& AdditionalSource : AdditionalSources)
+	{
+		OutSources.Add(AdditionalSource.Value);
+	}
+}
+
+void UTableauStreamingSubsystem::LoadCell(FCell& Cell)
+{
+	Cell.bLoaded = true;
+
+	if (UTableauRuntimeSubsystem* RuntimeSubsystem = GetWorld()->GetSubsystem<UTableauRuntimeSubsystem>())
+	{
+		for (const TWeakObjectPtr<UTableauComponent>& TableauComponent : Cell.Components)
+		{
+			if (TableauComponent.IsValid())
+			{
+				RuntimeSubsystem->RequestEvaluation(TableauComponent.Get());
+			}
+		}
+	}
+}
+
+void UTableauStreamingSubsystem::UnloadCell(FCell& Cell)
+{
+	Cell.bLoaded = false;
+
+	if (UTableauRuntimeSubsystem* RuntimeSubsystem = GetWorld()->GetSubsystem<UTableauRuntimeSubsystem>())
+	{
+		for (const TWeakObjectPtr<UTableauComponent>& TableauComponent : Cell.Components)
+		{
+			if (TableauComponent.IsValid())
+			{
+				RuntimeSubsystem->ReleaseEvaluation(TableauComponent.Get());
+			}
+		}
+	}
+}
@@ -24,6 +24,33 @@ namespace TableauActorConstants
 	const FName TABLEAU_SNAPTOFLOOR_TAG = TEXT("TTableauSnapToFloor");
 }
 
+/*
+* Foliage instances of a single Foliage Type that are drawn by the shared HISMs of the
+* UTableauFoliageSubsystem rather than by a HISM attached to the Tableau Actor.
+*/
+USTRUCT()
+struct TABLEAUASSET_API FTableauSharedFoliage
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	FSoftObjectPath FoliageType;
+
+	UPROPERTY()
+	bool bSnappable = true;
+
+	UPROPERTY()
+	bool bAlignToNormal = false;
+
+	UPROPERTY()
+	FFloatInterval GroundSlopeAngle = FFloatInterval(0.0f, 90.0f);
+
+	// Instance transforms relative to the Tableau Actor.
+	UPROPERTY()
+	TArray<FTransform> Instances;
+};
+
 UCLASS(Blueprintable, BlueprintType)
 class TABLEAUASSET_API ATableauActor : public AActor
 {
@@ -34,12 +61,20 @@ public:
 	//~ Begin AActor interface
 	ATableauActor(const FObjectInitializer& ObjectInitializer);
 
+	virtual void PostRegisterAllComponents() override;
+	virtual void PostUnregisterAllComponents() override;
+
 #if WITH_EDITOR
 	virtual bool GetReferencedContentObjects(TArray< UObject* >& Objects) const override;
+	virtual void PostEditMove(bool bFinished) override;
+	virtual void PostEditUndo() override;
 #endif
 	//~ End AActor interface
 
 	UTableauComponent* GetTableauComponent() const;
+
+	// Hand the Actor's shared foliage to the World's foliage subsystem, replacing anything handed over before.
+	void UpdateSharedFoliage();
 	
 public:
 	UPROPERTY(Category = Tableau, VisibleAnywhere, BlueprintReadWrite)
@@ -54,4 +89,8 @@ public:
 	UPROPERTY()
 	TArray<UTableauHISMComponent*> FoliageComponents;
 
+	// Foliage aggregated into shared HISMs, when the Tableau Component opts in.
+	UPROPERTY()
+	TArray<FTableauSharedFoliage> SharedFoliage;
+
 };
@@ -3,6 +3,7 @@
 // Engine Includes
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Serialization/BulkData.h"
 
 // Generated Include
 #include "TableauAsset.generated.h"
@@ -27,7 +28,11 @@
 * is snapped. 
 *
 * Elements in the asset list refer back to the asset the will instance from. However, the Instance produced is generated from the
-* stored clipboard string, allowing actor specific tweaks to survive the process, eg. vertex painting, light adjustments, material overrides, etc.
+* stored actor config, allowing actor specific tweaks to survive the process, eg. vertex painting, light adjustments, material overrides, etc.
+* Configs are kept compressed in the asset's ConfigTable, each distinct config once, and elements refer to them by index; a Tableau
+* captured from many copies of the same prop stores that prop's config a single time. The compressed configs themselves are held in
+* lazily loaded bulk data, so loading the asset reads only the element table; a config is streamed in and decompressed when an element
+* using it is first spawned.
 * Each Element also flags if it is "snapable". This attribute has no meaning if applied to a Tableau asset. For any other asset, ie. leaf nodes
 * in the expressed structure, the flag determines if the snap to floor operation will be applied. 
 */
@@ -43,6 +48,18 @@ namespace ETableauEvaluationMode
 	};
 }
 
+UENUM()
+namespace ETableauConfigFormat
+{
+	enum Type
+	{
+		// T3D clipboard text, as UTF-8.
+		Text,
+		// Binary capture written by the editor's FTableauActorConfig.
+		Binary
+	};
+}
+
 USTRUCT()
 struct TABLEAUASSET_API FTableauAssetElement
 {
@@ -58,6 +75,11 @@ public:
 	UPROPERTY(Category = Tableau, EditAnywhere)
 	FName Name;
 
+	// Stable identifier of the element in the source file it was imported from, if the source provides one.
+	// Reimport matches elements by this, or by Name where it's not set.
+	UPROPERTY(Category = Tableau, VisibleAnywhere)
+	FName SourceId;
+
 	UPROPERTY(Category = Tableau, EditAnywhere)
 	FSoftObjectPath AssetReference;
 
@@ -67,9 +89,18 @@ public:
 	UPROPERTY(Category = Tableau, EditAnywhere, DisplayName = "Use Captured Config")
 	bool bUseConfig = false;
 
+	// Index of the captured config in the owning Tableau Asset's ConfigTable, or INDEX_NONE.
+	UPROPERTY()
+	int32 ConfigIndex = INDEX_NONE;
+
+	// Captured config of elements saved before the ConfigTable existed, as T3D clipboard text, or as binary.
+	// Moved into the ConfigTable when the element is added or loaded.
 	UPROPERTY()
 	FString AssetConfig;
 
+	UPROPERTY()
+	TArray<uint8> AssetConfigData;
+
 	UPROPERTY(Category = Tableau, EditAnywhere)
 	FTransform LocalTransform;
 
@@ -93,6 +124,82 @@ public:
 
 };
 
+/*
+* Structural metrics of a Tableau Asset and the Tableaux nested within it, reported as asset registry tags so
+* that large Tableaux may be found without loading any assets.
+*
+* The metrics are a snapshot, computed when the asset is saved after its own elements or settings changed.
+* Editing a nested Tableau doesn't update the metrics of the Tableaux referencing it until they are next
+* edited and saved.
+*/
+USTRUCT()
+struct TABLEAUASSET_API FTableauAssetMetrics
+{
+	GENERATED_BODY()
+
+public:
+
+	// Levels of nested Tableaux, counting this one. Zero if the metrics have never been computed.
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	int32 MaxDepth = 0;
+
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	int32 DirectElementCount = 0;
+
+	// Elements of this and every nested Tableau, counted once for each place the nested Tableau is referenced.
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	int32 TransitiveElementCount = 0;
+
+	// Distinct non-Tableau assets that may be expressed.
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	int32 LeafAssetCount = 0;
+
+	// Distinct Foliage Types among the leaf assets.
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	int32 FoliageTypeCount = 0;
+
+	// Mean number of leaf instances produced by an evaluation, given the element weights.
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	float ExpectedInstanceCount = 0.0f;
+
+	// Bounds of everything that may be expressed, relative to the Tableau.
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	FBox LocalBounds = FBox(ForceInit);
+};
+
+/*
+* A captured actor config, identified by a hash of its contents. Its compressed payload is a range of the
+* Tableau Asset's config bulk data.
+*/
+USTRUCT()
+struct TABLEAUASSET_API FTableauAssetConfig
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	FString ContentHash;
+
+	UPROPERTY()
+	TEnumAsByte<ETableauConfigFormat::Type> Format = ETableauConfigFormat::Binary;
+
+	UPROPERTY()
+	int32 UncompressedSize = 0;
+
+	// Range of the bulk data holding the zlib compressed config, or the config itself where compression
+	// didn't make it smaller.
+	UPROPERTY()
+	int64 PayloadOffset = 0;
+
+	UPROPERTY()
+	int32 PayloadSize = 0;
+
+	// Payload of configs saved before the bulk data existed. Moved into the bulk data on load.
+	UPROPERTY()
+	TArray<uint8> CompressedData;
+};
+
 UCLASS(Blueprintable, BlueprintType, ClassGroup = Tableau, Category = "Tableau")
 class TABLEAUASSET_API UTableauAsset : public UObject
 {
@@ -103,14 +210,48 @@ public:
 	//~ Begin UObject interface
 	UTableauAsset(const FObjectInitializer& ObjectInitializer);
 	virtual void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+	virtual void PreEditChange(FProperty* PropertyAboutToChange) override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 	//~ End UObject interface
 
 	void AddElement(const FName Name, const FSoftObjectPath& AssetReference, const FString& AssetConfig, const FTransform& LocalTransform, uint32 Seed=0);
 	void AddElement(const FTableauAssetElement& NewElement);
+
+	// Append many elements at once, growing the element array a single time.
+	void AddElements(TArray<FTableauAssetElement>&& NewElements);
+
 	void ClearElements();
 
+	// Replace the elements, keeping the ConfigTable so that the new elements may refer to configs by their
+	// existing ConfigIndex. Configs no longer referenced are dropped when the asset is saved.
+	void SetElements(TArray<FTableauAssetElement>&& NewElements);
+
+	// Store a captured config, returning its index in the ConfigTable. Identical configs share an index.
+	int32 AddConfig(const TArray<uint8>& Config, ETableauConfigFormat::Type Format);
+
+	// Find a captured config, decompressing it on first use. Returns nullptr if the index is invalid, or in
+	// cooked builds, which don't carry the payloads. Decompressed configs are cached up to a budget, so the
+	// config returned is only valid until the next call. Must be called on the game thread.
+	const TArray<uint8>* FindConfig(int32 ConfigIndex, ETableauConfigFormat::Type& OutFormat) const;
+
+	// Find the current index of a config by its ContentHash, which unlike the index survives the ConfigTable
+	// being compacted. Returns INDEX_NONE if there's no such config. Must be called on the game thread.
+	int32 FindConfigIndex(const FString& ContentHash) const;
+
 	void ReplaceTableauReferences(const FSoftObjectPath& ReferenceToReplace, const FSoftObjectPath& ReferenceReplacement);
 
+#if WITH_EDITOR
+	// Fired before the elements of any Tableau Asset are edited, added or removed. Evaluations reading the
+	// elements on other threads are expected to complete before the handler returns.
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnTableauElementsChangingDelegate, const UTableauAsset*);
+	static FOnTableauElementsChangingDelegate OnTableauElementsChanging;
+#endif
+
 public:
 
 	// Super/Comp mode of evaluation
@@ -127,10 +268,72 @@ public:
 	UPROPERTY(EditAnywhere, Category = Tableau)
 	TArray<FTableauAssetElement> TableauElement;
 
+	// Distinct captured configs, referenced by the elements' ConfigIndex.
+	UPROPERTY()
+	TArray<FTableauAssetConfig> ConfigTable;
+
 #if WITH_EDITORONLY_DATA
 	// Source for reimport
 	UPROPERTY(Category = SourceAsset, VisibleAnywhere)
 	FString SourceFilePath;
+
+	UPROPERTY(Category = Metrics, VisibleAnywhere)
+	FTableauAssetMetrics Metrics;
+#endif
+
+#if WITH_EDITOR
+	// Recompute the Metrics, loading the nested Tableaux and leaf assets.
+	void UpdateMetrics();
+
+	// Drop the configs no element refers to any longer.
+	void CompactConfigTable();
+#endif
+
+private:
+	// Broadcast OnTableauElementsChanging and mark the Metrics for recomputation.
+	void NotifyElementsChanging();
+
+	// Move the legacy configs of the elements from FirstElement on into the ConfigTable.
+	void InternElementConfigs(int32 FirstElement);
+
+	// Rebuild the ConfigLookup if the table has changed under it, eg. by an undo or compaction.
+	void ValidateConfigLookup(const FString& ContentHash) const;
+
+	// Payloads are appended to PendingConfigPayloads, so that adding a config doesn't load the bulk data.
+	void AppendConfigPayload(FTableauAssetConfig& Entry, const uint8* Payload, int32 PayloadSize);
+
+	// Move the pending payloads to the end of the bulk data, where their offsets already place them.
+	void FlushPendingConfigPayloads();
+
+	// Read an entry's payload, streaming only its range from disk if the bulk data isn't loaded.
+	bool ReadConfigPayload(const FTableauAssetConfig& Entry, TArray<uint8>& OutPayload) const;
+
+	// Record the pending payloads in the transaction buffer, or restore them, moving the payloads of the restored
+	// ConfigTable that no longer lie where it says into the pending payloads.
+	void SerializeTransactedConfigPayloads(FArchive& Ar, const TArray<FTableauAssetConfig>& PreviousConfigTable);
+
+private:
+	// Compressed payloads of the ConfigTable, one after another. Left out of cooked packages, and out of the
+	// transaction buffer so that a Modify() doesn't load it.
+	FByteBulkData ConfigBulkData;
+
+	// Incremented whenever the bulk data is rewritten rather than appended to.
+	int32 ConfigBulkDataGeneration = 0;
+
+	// Payloads added since the bulk data was last saved, following on from it.
+	TArray<uint8> PendingConfigPayloads;
+
+	// Index of each config by ContentHash, built when first needed.
+	mutable TMap<FString, int32> ConfigLookup;
+
+	// Configs decompressed so far, by ContentHash, and their keys oldest first for eviction.
+	mutable TMap<FString, TArray<uint8>> DecompressedConfigs;
+	mutable TArray<FString> DecompressedConfigOrder;
+	mutable int64 DecompressedConfigBytes = 0;
+
+#if WITH_EDITORONLY_DATA
+	// Set when the elements or settings change, so that the Metrics are only recomputed on save if needed.
+	bool bMetricsDirty = false;
 #endif
 	
 };
@@ -0,0 +1,85 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+// Generated Include
+#include "TableauBakedRecipe.generated.h"
+
+// Forward Declares
+class UStaticMesh;
+class UFoliageType;
+
+
+/*
+* An instance to be baked: a Static Mesh or Foliage Type placed relative to the baked Tableau. Parent is the
+* index of the instance this one is subordinate to, or INDEX_NONE.
+*/
+struct FTableauBakeInstance
+{
+	UObject* Source = nullptr;
+	FTransform Transform = FTransform::Identity;
+	int32 Parent = INDEX_NONE;
+};
+
+/*
+* A contiguous run of decoded instances sharing a Static Mesh or Foliage Type.
+*/
+struct FTableauBakedRange
+{
+	UStaticMesh* StaticMesh = nullptr;
+	UFoliageType* FoliageType = nullptr;
+	int32 FirstInstance = 0;
+	int32 InstanceCount = 0;
+};
+
+/*
+* UTableauBakedRecipe stores the evaluated output of a placed Tableau so that it may be expressed without
+* evaluating the latent tree or pasting configured actors.
+*
+* The instances are packed into a single blob, serialized with one bulk read: a versioned header followed by fixed
+* size records holding the location, the rotation as a quantized unit quaternion, the scale as half precision floats,
+* an index into the Static Mesh and Foliage Type tables and the index of the parent instance. Records are ordered by
+* source so that each HISM is fed from one contiguous range. Blobs of an unknown version are discarded on load.
+*/
+UCLASS()
+class TABLEAUASSET_API UTableauBakedRecipe : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UObject interface
+	virtual void Serialize(FArchive& Ar) override;
+	//~ End UObject interface
+
+	// Replace the baked contents. Instances whose source is neither a Static Mesh nor a Foliage Type are dropped.
+	// Returns false, leaving the contents unchanged, if the instances can't be baked.
+	bool Bake(const TArray<FTableauBakeInstance>& Instances);
+
+	// Unpack the instances, relative to the baked Tableau, and the ranges sharing a source.
+	// OutParents is optional. Returns false if the blob is malformed.
+	bool Decode(TArray<FTransform>& OutTransforms, TArray<FTableauBakedRange>& OutRanges, TArray<int32>* OutParents = nullptr) const;
+
+	int32 GetInstanceCount() const
+	{
+		return InstanceCount;
+	}
+
+public:
+	UPROPERTY(Category = Tableau, VisibleAnywhere)
+	TArray<UStaticMesh*> Meshes;
+
+	UPROPERTY(Category = Tableau, VisibleAnywhere)
+	TArray<UFoliageType*> FoliageTypes;
+
+	// Bounds of the instance locations, relative to the baked Tableau.
+	UPROPERTY(Category = Tableau, VisibleAnywhere)
+	FBox Bounds;
+
+private:
+	UPROPERTY(Category = Tableau, VisibleAnywhere)
+	int32 InstanceCount = 0;
+
+	TArray<uint8> RecipeBlob;
+};
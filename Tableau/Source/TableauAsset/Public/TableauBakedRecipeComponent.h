@@ -0,0 +1,50 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+
+// Generated Include
+#include "TableauBakedRecipeComponent.generated.h"
+
+// Forward Declares
+class UTableauBakedRecipe;
+class UTableauHISMComponent;
+
+
+/*
+* UTableauBakedRecipeComponent expresses a Baked Recipe as instanced components, one HISM per Static Mesh and
+* per Foliage Type. No latent tree is evaluated: the instances are decoded from the recipe's blob and fed to the
+* HISMs in bulk when the component is registered.
+*/
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class TABLEAUASSET_API UTableauBakedRecipeComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UActorComponent interface
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	//~ End UActorComponent interface
+
+#if WITH_EDITOR
+	//~ Begin UObject interface
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	//~ End UObject interface
+#endif
+
+	// Replace the instanced components with those described by the Baked Recipe.
+	void RebuildInstances();
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = Tableau, EditAnywhere)
+	UTableauBakedRecipe* BakedRecipe;
+
+private:
+	void DestroyInstances();
+
+private:
+	UPROPERTY(Transient)
+	TArray<UTableauHISMComponent*> InstanceComponents;
+};
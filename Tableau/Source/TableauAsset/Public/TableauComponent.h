@@ -11,18 +11,33 @@
 // Generated Include
 #include "TableauComponent.generated.h"
 
+// Forward Declares
+class UTableauHISMComponent;
+
 /*
 * The Tableau Component is responsible for keeping track of the Instanced Actors resulting from the 
 * evaluation of the associated Tableau Asset. Note that there is very little core logic contained by
 * the Component itself: generation and management of the Instances is handled by the FTableauActorManager
 * class and the various structs and classes of TableauUtils.
 *
-* The registry of Instances maintained by the Component is structured as a forest, ie. an array of trees.
-* In most cases the registry will probably just be a flat list. Hierarchy is only introduced when snapping
-* relationships appear when a HierarchicalComposition Tableau is encountered in evaluation.
+* The registry of Instances maintained by the Component is a forest stored as a flat array in registration
+* order, each tracker holding the index of its parent. In most cases the registry is simply a list of roots.
+* Hierarchy is only introduced when snapping relationships appear when a HierarchicalComposition Tableau is
+* encountered in evaluation. Since parents precede their subordinates, a single forward pass visits every
+* parent before its children.
 *
 * The Tableau Component holds reference to the Tableau Asset and a Seed value for generating the Instances.
 * It is also responsible for generating it's bounds and Color for drawing.
+*
+* Since evaluation is deterministic, regeneration need not record the Instances in the transaction buffer.
+* The Component records a hash of the recipe inputs (Tableau, Seed and filter settings) and a snapshot hash
+* of the Instances it produced. When the Instances are still exactly as the last regeneration left them, the
+* regeneration records only the Component; undo and redo restore the recipe inputs and evaluate them again.
+* Instances that were edited by hand are regenerated inside a conventional transaction.
+*
+* Outside the editor, a Component may instead be evaluated at runtime by the UTableauRuntimeSubsystem. Its
+* Static Meshes and Foliage are then expressed as transient instanced components rather than Instanced Actors.
+* Such Components may also be streamed in and out around the players by the UTableauStreamingSubsystem.
 */
 
 USTRUCT()
@@ -32,21 +47,9 @@ struct FTableauInstanceTracker
 
 	TWeakObjectPtr<AActor> TableauInstance;
 
-	TArray<FTableauInstanceTracker> SubInstances;
-
-	// Perform function on each leaf member of tree.
-	void Apply(void (*ApplyFunc)(AActor*))
-	{
-		if (TableauInstance.IsValid())
-		{
-			ApplyFunc(TableauInstance.Get());
-		}
-
-		for (FTableauInstanceTracker& Instance : SubInstances)
-		{
-			Instance.Apply(ApplyFunc);
-		}
-	}
+	// Index of the tracker of the Instance this one is subordinate to, or INDEX_NONE for a root.
+	// A parent is always registered, and so indexed, before its subordinates.
+	int32 Parent = INDEX_NONE;
 };
 
 USTRUCT()
@@ -104,7 +107,13 @@ public:
 	//~ Begin UPrimitiveComponent interface
 	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
 	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void PostEditImport() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditUndo() override;
+#endif
 	//~ End UPrimitiveComponent interface
 
 	UTableauAsset* GetTableau() const;
@@ -118,31 +127,61 @@ public:
 	void ClearInstances();
 
 	// When an Instanced Actor is spawned, it must be registered with the Component.
-	// Parent indicates which tree the reference should be added to; nullptr indicates
-	// that it should be added as a new root.
-	void RegisterInstance(TWeakObjectPtr<AActor> InInstance, FTableauInstanceTracker* Parent = nullptr);
-
-	// Get a pointer to the most recently registered instance.
-	FTableauInstanceTracker* GetLastInstanceTracker();
+	// Parent is the index of the Instance the reference is subordinate to; INDEX_NONE indicates
+	// that it should be added as a new root. Returns the index of the new tracker.
+	int32 RegisterInstance(TWeakObjectPtr<AActor> InInstance, int32 Parent = INDEX_NONE);
 
 	// Validate and update instance tracking.
 	void RestoreInstances();
 
-	TArray<FTableauInstanceTracker> GetInstances() const
+	// The Instances registry, parents preceding their subordinates.
+	const TArray<FTableauInstanceTracker>& GetInstances() const
 	{ 
 		return TableauInstances; 
 	}
 
+	// Called whenever an Actor may have been lost from an editor World: deleted, replaced, undone or removed
+	// with its Level. Registries are only walked for validation if one was lost since they were last validated.
+	static void InvalidateInstanceTracking();
+
+	// Color coded to the Tableau's evaluation mode. Cached, so it may be called every frame.
 	FLinearColor GetColor() const;
+
+	// Combined bounds of the Instances and generated components. Cached until invalidated, and carried along
+	// with the Component when it moves.
 	FBox GetBoundingBox() const;
 
+	// Discard the cached bounds and update the Component's bounds. Must be called whenever Instances or
+	// generated components are spawned, deleted or moved independently of the Component.
+	void InvalidateBounds();
+
+	// Hash of the inputs that deterministically produce the Instances.
+	uint32 ComputeRecipeHash() const;
+
+	// Hash of the placement of the tracked Instances and generated components.
+	uint32 ComputeInstanceSnapshotHash() const;
+
+	// Are the Instances exactly as the last regeneration left them, and owned by the Component rather
+	// than the transaction buffer? If so, they may be regenerated without recording them.
+	bool CanRegenerateWithoutTransaction() const;
+
+	// Have the Instances been moved, added or deleted since the last regeneration? Components that have
+	// never recorded a regeneration have no snapshot to compare against, and are reported as unedited.
+	bool HasEditedInstances() const;
+
+	// Record the recipe and Instance snapshot following a regeneration. bTransacted indicates that the
+	// Instances were spawned inside a transaction.
+	void RecordRegeneration(bool bTransacted);
+
 	DECLARE_DELEGATE_OneParam(FOnTableauDuplicateDelegate, AActor*);
 	static FOnTableauDuplicateDelegate OnTableauDuplicate;
 
+	// Fired when undo or redo restores a recipe whose Instances were not recorded in the transaction buffer.
+	// The bound handler is expected to regenerate the Instances.
+	DECLARE_DELEGATE_OneParam(FOnTableauRecipeRestoredDelegate, UTableauComponent*);
+	static FOnTableauRecipeRestoredDelegate OnTableauRecipeRestored;
+
 private:
-	FBox GetBoundingBox(const TArray<FTableauInstanceTracker>& SubInstances) const;
-	UObject* SafelyResolveSoftPath(const FSoftObjectPath& path) const;
-	void ClearInstances(TArray<FTableauInstanceTracker>& SubInstances);
 	bool IsValid() const;
 
 public:
@@ -161,6 +200,21 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = Tableau, EditAnywhere, meta = (DisplayName = "Exclude HISM Components from HLOD Generation"))
 	bool bExcludeHISMsFromHLOD = false;
 
+	// Rather than attaching a HISM per Foliage Type, add foliage instances to HISMs shared with nearby Tableaux.
+	// The shared HISMs are transient, so they get no baked static lighting or HLOD proxies.
+	UPROPERTY(BlueprintReadWrite, Category = Tableau, EditAnywhere, meta = (DisplayName = "Share Foliage HISMs with Other Tableaux"))
+	bool bShareFoliage = false;
+
+	// Evaluate the Tableau asynchronously when play begins, populating the owner with instanced components.
+	// Intended for Tableaux placed without regenerating their Instances in the editor.
+	UPROPERTY(BlueprintReadWrite, Category = Tableau, EditAnywhere, meta = (DisplayName = "Evaluate at Runtime"))
+	bool bEvaluateAtRuntime = false;
+
+	// Rather than evaluating when play begins, evaluate the Tableau whenever it comes within the streaming
+	// load radius of a player, and release it once it is out of range.
+	UPROPERTY(BlueprintReadWrite, Category = Tableau, EditAnywhere, meta = (DisplayName = "Stream at Runtime", EditCondition = "bEvaluateAtRuntime"))
+	bool bStreamAtRuntime = false;
+
 	UPROPERTY(Category = Tableau, EditAnywhere)
 	TArray<FFilterActor> FilterActors;
 
@@ -170,10 +224,47 @@ public:
 	UPROPERTY(Category = Tableau, EditAnywhere)
 	TArray<FFilterTag> FilterTags;
 
+	// Recipe hash of the most recent regeneration.
+	UPROPERTY()
+	uint32 RecipeHash = 0;
+
+	// Snapshot hash of the Instances as the most recent regeneration left them.
+	UPROPERTY()
+	uint32 InstanceSnapshotHash = 0;
+
+	// True if the current Instances were spawned inside a transaction. A freshly loaded level has no
+	// transaction history, so this is transient.
+	UPROPERTY(Transient)
+	bool bInstancesTransacted = false;
+
+	// Pooled instanced components, hosted by the runtime subsystem, expressing runtime evaluation.
+	UPROPERTY(Transient)
+	TArray<UTableauHISMComponent*> RuntimeComponents;
+
 private:
 	UPROPERTY()
 	TArray<FTableauInstanceTracker> TableauInstances;
 
+	// The recipe actually present in the World. Not transacted, so that undo and redo may compare it
+	// with the restored recipe.
+	uint32 LiveRecipeHash = 0;
+	bool bLiveInstancesTransacted = false;
+
+	// The Tableau and evaluation mode the cached color was looked up for.
+	mutable const UTableauAsset* CachedColorTableau = nullptr;
+	mutable int32 CachedColorEvaluationMode = INDEX_NONE;
+	mutable FLinearColor CachedColor = FLinearColor::Black;
+
+	// The cached bounds, and the Component transform they were gathered at.
+	mutable FBox CachedBoundingBox = FBox(ForceInit);
+	mutable FTransform CachedBoundingBoxTransform = FTransform::Identity;
+	mutable bool bBoundingBoxDirty = true;
+
+	// The tracking generation at which the registry was last found valid.
+	mutable uint32 ValidatedGeneration = 0;
+
+	static uint32 InstanceTrackingGeneration;
+
 };
 
 
@@ -0,0 +1,77 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+// Local Includes
+#include "TableauAsset.h"
+#include "TableauFilter.h"
+
+// Forward Declares
+class UWorld;
+
+
+/*
+* Data precomputed for a Tableau Asset so that repeated evaluations need not walk the element list.
+*/
+struct FTableauCompiledAsset
+{
+	FTableauCompiledAsset()
+		: TotalWeight(0.0f)
+	{
+	}
+
+	// Sum of element weights plus the NothingWeight, as used by Superposition selection.
+	float TotalWeight;
+};
+
+/*
+* FTableauEvaluationContext holds the caches that may be shared by every Tableau evaluated in a batch:
+* the loaded assets reachable from the root Tableaux, compiled Tableau Assets, a single exclusion volume
+* filter and the landscape weightmap caches.
+*
+* All of the assets are loaded on the game thread when a root Tableau is added. Afterwards the context is
+* read only (aside from the internally locked landscape caches) and may be used by latent tree evaluations
+* running in parallel.
+*/
+class TABLEAUASSET_API FTableauEvaluationContext : public FGCObject
+{
+public:
+	FTableauEvaluationContext(UWorld* InWorld);
+	virtual ~FTableauEvaluationContext();
+
+	//~ Begin FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	//~ End FGCObject interface
+
+	// Load and compile every asset reachable from the provided Tableau. Must be called on the game thread.
+	void AddTableau(const UTableauAsset* TableauAsset);
+
+	// Find a previously loaded asset. Returns nullptr if the reference was never loaded by this context.
+	UObject* ResolveAsset(const FSoftObjectPath& AssetReference) const;
+
+	// Find the compiled data for a Tableau Asset. Returns nullptr if the asset was never added.
+	const FTableauCompiledAsset* FindCompiledAsset(const UTableauAsset* TableauAsset) const;
+
+	// A single filter covering every Tableau Exclusion Volume loaded in the World.
+	TSharedPtr<FTableauFilter> GetExclusionFilter();
+
+	// Weightmap cache shared by every landscape layer filter sampling the named layer.
+	TSharedPtr<FTableauLandscapeLayerCache> GetLandscapeLayerCache(const FName& LayerName);
+
+private:
+	void LoadAsset(const FSoftObjectPath& AssetReference);
+
+private:
+	UWorld* World;
+
+	TMap<FSoftObjectPath, UObject*> ResolvedAssets;
+
+	TMap<const UTableauAsset*, FTableauCompiledAsset> CompiledAssets;
+
+	TSharedPtr<FTableauFilter> ExclusionFilter;
+
+	TMap<FName, TSharedPtr<FTableauLandscapeLayerCache>> LandscapeLayerCaches;
+};
@@ -3,13 +3,17 @@
 // Engine Includes
 #include "Math/Vector.h"
 #include "Math/TransformNonVectorized.h"
+#include "HAL/CriticalSection.h"
 
 // Local Includes
 
 // Forward Declares
+class UWorld;
 class ULandscapeComponent;
 class USplineComponent;
 class ATableauExclusionVolume;
+class UTableauComponent;
+class FTableauEvaluationContext;
 
 
 // Abstract base class of all tableau filters.
@@ -18,6 +22,9 @@ class FTableauFilter
 public:
 	// Returns false if the sampled point should be culled.
 	virtual bool Sample(const FVector& Location) const = 0;
+
+	// May the filter be sampled off the game thread? Filters that query the scene or its actors may not.
+	virtual bool IsThreadSafe() const { return false; }
 };
 
 class FTableauCylinderVolumeFilter : public FTableauFilter
@@ -26,24 +33,36 @@ public:
 	FTableauCylinderVolumeFilter(const FVector& InCenter, float InRadius);
 
 	virtual bool Sample(const FVector& Location) const override;
+	virtual bool IsThreadSafe() const override { return true; }
 
 private:
 	FVector Center;
 	float Radius;
 };
 
+// Weightmap data read from landscape components for a single layer. The cache may be shared by several
+// filters, possibly sampling on different threads, so access is serialized.
+struct FTableauLandscapeLayerCache
+{
+	FCriticalSection CriticalSection;
+	TMap<ULandscapeComponent*, TArray<uint8>> LayerCacheData;
+};
+
+// Landscape weightmaps are only readable on the CPU in editor builds. Elsewhere the filter keeps every sample,
+// so the runtime subsystem refuses to evaluate components that filter by weightmap.
 class FTableauLandscapeWeightmapFilter : public FTableauFilter
 {
 public:
-	FTableauLandscapeWeightmapFilter(const FName InLayerName, float WeightThreshold);
+	FTableauLandscapeWeightmapFilter(const UWorld* InWorld, const FName InLayerName, float WeightThreshold, TSharedPtr<FTableauLandscapeLayerCache> InLayerCache = nullptr);
 	virtual ~FTableauLandscapeWeightmapFilter();
 
 	virtual bool Sample(const FVector& Location) const override;
 
 private:
+	TWeakObjectPtr<const UWorld> World;
 	FName LandscapeLayerName;
 	float Threshold;
-	TUniquePtr<TMap<ULandscapeComponent*, TArray<uint8>>> LandscapeLayerCacheData;
+	TSharedPtr<FTableauLandscapeLayerCache> LandscapeLayerCache;
 };
 
 class FTableauSplineFilter : public FTableauFilter
@@ -69,31 +88,54 @@ private:
 	TWeakObjectPtr<ATableauExclusionVolume> ExclusionVolume;
 };
 
+// Tests against a set of exclusion volumes at once. The volumes' bounds are gathered on construction
+// so that most samples are rejected without touching the volume brushes.
+class FTableauExclusionVolumeIndexFilter : public FTableauFilter
+{
+public:
+	FTableauExclusionVolumeIndexFilter(const TArray<TWeakObjectPtr<ATableauExclusionVolume>>& InVolumes);
+
+	virtual bool Sample(const FVector& Location) const override;
+
+	// Only an index without volumes never touches the scene.
+	virtual bool IsThreadSafe() const override { return ExclusionVolumes.Num() == 0; }
+
+private:
+	TArray<TWeakObjectPtr<ATableauExclusionVolume>> ExclusionVolumes;
+	TArray<FBox> ExclusionBounds;
+};
+
 class FTableauTagFilter : public FTableauFilter
 {
 public:
-	FTableauTagFilter(const FName InTag, float InTolerance);
+	FTableauTagFilter(const UWorld* InWorld, const FName InTag, float InTolerance);
 
 	virtual bool Sample(const FVector& Location) const override;
 
 private:
+	TWeakObjectPtr<const UWorld> World;
 	FName Tag;
 	float Tolerance;
 };
 
 
-class FTableauFilterSampler
+class TABLEAUASSET_API FTableauFilterSampler
 {
 public:
-	FTableauFilterSampler(const FTransform& InToWorldTransform);
+	// Filters that query the scene (landscape layers and tags) sample the provided World.
+	FTableauFilterSampler(const FTransform& InToWorldTransform, const UWorld* InWorld = nullptr);
 	~FTableauFilterSampler();
 
+	// Assemble filters from Tableau Component configuration. If an evaluation context is provided, its
+	// exclusion volume filter and landscape weightmap caches are shared rather than built anew.
+	static TSharedPtr<FTableauFilterSampler> GatherFilters(const UTableauComponent* TableauComponent, UWorld* World, FTableauEvaluationContext* Context = nullptr);
+
 	// Add a cylindrical filter. Any sample points inside the cylinder will be culled.
 	void AddCylinderVolumeFilter(const FVector& Origin, float Radius);
 
 	// Add a landscape weight map filter. The Landscape is sampled in the vertical line of the location.
 	// If the prescribed weightmap has a value below the threshold at that location, the point is culled.
-	void AddLandscapeLayerFilter(const FName& LayerName, float WeightmapThreshold);
+	void AddLandscapeLayerFilter(const FName& LayerName, float WeightmapThreshold, TSharedPtr<FTableauLandscapeLayerCache> LayerCache = nullptr);
 
 	// Add a spline filter. The point is culled if the projected 2d distance from the closest 
 	// location on the spline component is less than the Radius.
@@ -105,14 +147,21 @@ public:
 	// Search the World for all TableauExclusionVolumes and include them in the filter.
 	void AddAllLoadedExclusionVolumes(UWorld* World);
 
+	// Add a prebuilt filter, which may be shared with other samplers.
+	void AddFilter(TSharedPtr<FTableauFilter> Filter);
+
 	// Tests a sample location: returns true if the test location should be kept.
 	bool Sample(const FVector& TestLocation) const;
 
+	// May every filter be sampled off the game thread?
+	bool IsThreadSafe() const;
+
 	// Clear all prexisting filters
 	void Reset();
 
 private:
 	const FTransform ToWorldTransform;
+	TWeakObjectPtr<const UWorld> World;
 	TArray<TSharedPtr<FTableauFilter>> Filters;
 
 };
\ No newline at end of file
@@ -2,17 +2,15 @@
 
 // Engine Includes
 #include "CoreMinimal.h"
-#include "Editor.h"
 
 // Local Includes
-#include "TableauEditorModule.h"
 #include "TableauActor.h"
 #include "TableauHISMComponent.h"
 
 // Forward Declares
 class UFoliageType;
 
-class TABLEAUEDITOR_API FTableauFoliage
+class TABLEAUASSET_API FTableauFoliage
 {
 public:
 	FTableauFoliage(UFoliageType* InFoliageType, const FTransform& Xform, const FName& InName, bool bIsSnappable);
@@ -21,12 +19,19 @@ public:
 	// Add an instance of this type.
 	void AddInstance(const FTransform& Transform);
 
+	UFoliageType* GetFoliageType() const;
+
+	// Instance transforms, relative to the evaluated Tableau.
+	const TArray<FTransform>& GetInstances() const;
+
 	// Configure a HISM Component using the composed Foliage Type and attach it to the Actor.
 	void ConfigureAndAttachHISM(ATableauActor* Actor);
 
+	// Store the instances on the Actor for aggregation into the World's shared foliage HISMs.
+	void AddToSharedFoliage(ATableauActor* Actor);
+
 private:
 	void UpdateComponentSettings(UTableauHISMComponent* HISMComponent);
-	void RefreshComponentProperties(UTableauHISMComponent* Component);
 
 private:
 	TWeakObjectPtr<UFoliageType> FoliageType;
@@ -39,24 +44,3 @@ private:
 	bool bAlignToSurfaceNormal;
 
 };
-
-class FTableauFoliageManager
-{
-public:
-	FTableauFoliageManager(ATableauActor* InActor);
-
-	// Destroy Foliage Components attached to the actor.
-	void DestroyFoliageComponents();
-
-	// Trace all Foliage instances to floor
-	void SnapToFloor(const UWorld* InWorld);
-
-	// How do we extract foliage? I don't know yet.
-	void ExtractFoliage(UWorld* InWorld);
-
-private:
-	void SnapInstancesToFloor(UTableauHISMComponent* Component, const UWorld* InWorld);
-
-private:
-	TWeakObjectPtr<ATableauActor> TableauActor;
-};
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+// Generated Include
+#include "TableauFoliageSubsystem.generated.h"
+
+// Forward Declares
+class ATableauActor;
+class UTableauHISMComponent;
+
+
+/*
+* UTableauFoliageSubsystem aggregates the foliage of Tableau Actors that opt in to sharing. Rather than each
+* Tableau Actor attaching its own HISM per Foliage Type, the instances are gathered into shared HISMs keyed by
+* Foliage Type and by the spatial cell containing the owning Actor, so that many Tableaux scattering the same
+* foliage share cluster trees and draw calls.
+*
+* The Tableau Actor remains the owner of its instances: they are stored on the Actor (and saved with it) and
+* the subsystem rebuilds the shared HISMs from them. Within a shared HISM each Actor's instances form one
+* contiguous range, so regeneration, snapping and unpacking continue to operate per Actor.
+*
+* The shared HISMs are hosted by a transient Actor, so unlike the HISMs a Tableau Actor attaches itself, they
+* aren't saved with the level and receive neither baked static lighting nor HLOD proxies. Sharing is therefore
+* opted into per Tableau Component (bShareFoliage); Tableaux that need lighting or HLODs keep their own HISMs.
+*
+* Changes are coalesced: registering or unregistering Actors marks their ranges and cells dirty, and dirty cells
+* are updated once on the next tick. Removed ranges are closed up and new ranges appended, so only the instances
+* following the first removed range are touched, rather than every instance in the cell.
+*/
+UCLASS()
+class TABLEAUASSET_API UTableauFoliageSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem interface
+
+	// Add the Actor's shared foliage to the aggregated HISMs, replacing any previously registered instances.
+	void UpdateActor(ATableauActor* TableauActor);
+
+	// Remove the Actor's instances from the aggregated HISMs.
+	void UnregisterActor(ATableauActor* TableauActor);
+
+	// Find the range of instances owned by the Actor for the shared foliage entry at SharedFoliageIndex.
+	// Only valid once dirty cells have been updated.
+	bool FindInstanceRange(const ATableauActor* TableauActor, int32 SharedFoliageIndex, UTableauHISMComponent*& OutComponent, int32& OutFirstInstance, int32& OutInstanceCount) const;
+
+	// World space bounds of all the instances owned by the Actor.
+	FBox GetActorFoliageBounds(const ATableauActor* TableauActor) const;
+
+	// Update any cells whose membership has changed. The owners' foliage bounds are only known once their
+	// cells are updated, so their Tableau Components' bounds are invalidated here.
+	void FlushDirtyCells();
+
+private:
+	struct FCellKey
+	{
+		FSoftObjectPath FoliageType;
+		FIntPoint Cell;
+
+		bool operator==(const FCellKey& Other) const
+		{
+			return FoliageType == Other.FoliageType && Cell == Other.Cell;
+		}
+
+		friend uint32 GetTypeHash(const FCellKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.FoliageType), GetTypeHash(Key.Cell));
+		}
+	};
+
+	struct FInstanceRange
+	{
+		TWeakObjectPtr<ATableauActor> Owner;
+		int32 SharedFoliageIndex;
+		int32 FirstInstance;
+		int32 InstanceCount;
+		FBox Bounds;
+
+		// Pending changes, applied when the cell is next updated.
+		bool bAdded = false;
+		bool bRemoved = false;
+	};
+
+	struct FCell
+	{
+		UTableauHISMComponent* Component = nullptr;
+		TArray<FInstanceRange> Ranges;
+		bool bDirty = false;
+	};
+
+	// Close up the removed ranges and append the added ones.
+	void UpdateCell(const FCellKey& Key, FCell& Cell, TSet<ATableauActor*>& OutUpdatedOwners);
+	UTableauHISMComponent* CreateCellComponent(const FSoftObjectPath& FoliageType);
+	void ScheduleFlush();
+
+private:
+	TMap<FCellKey, FCell> Cells;
+
+	// The cells each registered Actor has instances in.
+	TMap<TWeakObjectPtr<ATableauActor>, TArray<FCellKey>> ActorCells;
+
+	// Transient Actor hosting the shared HISMs.
+	UPROPERTY(Transient)
+	AActor* HostActor;
+
+	UPROPERTY(Transient)
+	TArray<UTableauHISMComponent*> CellComponents;
+
+	FDelegateHandle FlushTickerHandle;
+};
@@ -4,6 +4,8 @@
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "TableauHISMComponent.generated.h"
 
+// Forward Declares
+class UFoliageType_InstancedStaticMesh;
 
 
 /**
@@ -21,6 +23,24 @@ public:
 	// Set Component to be excluded from HLOD generation
 	void ExcludeFromHLOD();
 
+	// Configure rendering, collision and placement settings to match the Foliage Type.
+	void ConfigureFromFoliageType(const UFoliageType_InstancedStaticMesh* FoliageType_InstancedStaticMesh);
+
+	// Add many instances in a single pass. The cluster tree is not rebuilt; call RebuildClusterTree
+	// once all instances have been added.
+	void AddInstancesInBulk(const TArray<FTransform>& InstanceTransforms, bool bWorldSpace = false);
+
+	// Replace the instances. If the instance count is unchanged, the existing instances are updated in
+	// place rather than removed and added again. The cluster tree is not rebuilt.
+	void SetInstancesInBulk(const TArray<FTransform>& InstanceTransforms);
+
+	// Replace the instances from StartInstance onward, keeping those before it. Instances are updated in place,
+	// then removed from or added at the end, so that none is reordered. The cluster tree is not rebuilt.
+	void ReplaceInstancesFrom(int32 StartInstance, const TArray<FTransform>& InstanceTransforms, bool bWorldSpace = false);
+
+	// Rebuild the cluster tree on a worker thread. Unbuilt instances continue to render in the meantime.
+	void RebuildClusterTree();
+
 public:
 	UPROPERTY()
 	FSoftObjectPath FoliageType;
@@ -1,15 +1,16 @@
 #pragma once
 
-// Editor Includes
+// Engine Includes
 #include "CoreMinimal.h"
-#include "Editor.h"
-#include "FoliageType.h"
-#include "FoliageType_InstancedStaticMesh.h"
 
 // Local Includes
+#include "TableauAsset.h"
 #include "TableauFoliage.h"
 #include "TableauFilter.h"
 
+// Forward Declares
+class FTableauEvaluationContext;
+class UFoliageType;
 
 /*
 * Node describing the required information to spawn an actor comprising the Tableau.
@@ -18,7 +19,6 @@ struct FTableauRecipeNode
 {
 	FTableauRecipeNode()
 		: Name("TableauInstance")
-		, AssetConfig("")
 		, AssetReference(nullptr)
 		, LocalTransform(FTransform::Identity)
 		, bSnapToFloor(true)
@@ -30,12 +30,18 @@ struct FTableauRecipeNode
 	// Name of the original actor cloned for this Tableau
 	FName Name;
 
-	// Clipboard contents of the actor resulting from a copy/paste edact operation.
-	FString AssetConfig;
+	// Captured config of the actor, by ContentHash in the ConfigTable of the Tableau Asset owning the element,
+	// since the table may be compacted while the Recipe is held. It's only decompressed when the actor is spawned.
+	TWeakObjectPtr<const UTableauAsset> ConfigOwner;
+	FString ConfigHash;
 
 	// Pointer to the referenced asset.
 	TWeakObjectPtr<UObject> AssetReference;
 
+	// In asset editor mode, Foliage Types are expressed by their Static Mesh. This is the Foliage Type the
+	// referenced asset was taken from, if any.
+	TWeakObjectPtr<UFoliageType> FoliageType;
+
 	// Transform of the actor local to the Tableau actor
 	FTransform LocalTransform;
 
@@ -49,15 +55,29 @@ struct FTableauRecipeNode
 	TArray<FTableauRecipeNode> SubRecipe;
 };
 
+/*
+* Seeding and jitter shared by the latent tree and the tools that spawn Tableau elements directly.
+*/
+struct TABLEAUASSET_API FTableauEvaluationUtils
+{
+	// Modify transform to reflect random rotation and scaling around origin.
+	static void JitterTransform(uint32 Seed, float MinScale, float MaxScale, bool bSpinZAxis, FTransform& Transform);
+
+	static int32 NextSeed(int32 Seed);
+};
+
 /*
 * Utility class for unpacking a latent tree description from latently nested Tableau assets.
+* The latent tree has no editor dependencies. Given an Evaluation Context, it may be evaluated on a worker thread.
 */
-class FTableauLatentTree
+class TABLEAUASSET_API FTableauLatentTree
 {
 
 public:
 
-	FTableauLatentTree(const UTableauAsset* InTableauAsset, TSharedPtr<FTableauFilterSampler> InFilter, bool bUseAssetEditorMode=false);
+	// If an Evaluation Context is provided, assets are resolved through it rather than loaded on demand. In that case
+	// the evaluation does not touch the asset loader and may run off the game thread.
+	FTableauLatentTree(const UTableauAsset* InTableauAsset, TSharedPtr<FTableauFilterSampler> InFilter, bool bUseAssetEditorMode=false, TSharedPtr<const FTableauEvaluationContext> InContext=nullptr);
 
 	// Prepare Recipe for spawning by evaluating the latent Tableau tree using the provided Seed for random Superposition selections.
 	void EvaluateLatentTree(int32 Seed);
@@ -69,11 +89,12 @@ public:
 
 private:
 	FTableauRecipeNode* EvaluateTableau(const FTableauAssetElement& TableauElement, const FTransform& CurrXform, int32 LocalSeed, TArray<FTableauRecipeNode>& CurrRecipe, TArray<UTableauAsset*> EvaluationHistory);
-	FTableauRecipeNode* EvaluateLeafElement(const FTableauAssetElement& TableauElement, const FTransform& CurrXform, TArray<FTableauRecipeNode>& CurrRecipe, UObject* Asset = nullptr);
+	FTableauRecipeNode* EvaluateLeafElement(const FTableauAssetElement& TableauElement, const UTableauAsset* OwningAsset, const FTransform& CurrXform, TArray<FTableauRecipeNode>& CurrRecipe, UObject* Asset = nullptr);
 	FTableauRecipeNode* EvaluateCompositeElement(UTableauAsset* InTableauAsset, const FTransform& CurrXform, int32 LocalSeed, bool bHierarchical, TArray<FTableauRecipeNode>& CurrRecipe, TArray<UTableauAsset*> EvaluationHistory);
 
 	UObject* SafelyResolveSoftPath(const FSoftObjectPath& path) const;
-	FTableauRecipeNode ConvertTableauElementToRecipeNode(const FTableauAssetElement& TableauElement, const FTransform& Transform, UObject* Asset) const;
+	float GetTotalWeight(const UTableauAsset* InTableauAsset) const;
+	FTableauRecipeNode ConvertTableauElementToRecipeNode(const FTableauAssetElement& TableauElement, const UTableauAsset* OwningAsset, const FTransform& Transform, UObject* Asset) const;
 
 	bool FuzzyTrue(float Probability, int32 Seed) const;
 
@@ -87,6 +108,8 @@ public:
 
 	TSharedPtr<FTableauFilterSampler> Filter;
 
+	TSharedPtr<const FTableauEvaluationContext> Context;
+
 	bool bAssetEditorMode;
 
 };
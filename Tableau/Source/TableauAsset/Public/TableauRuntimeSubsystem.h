@@ -0,0 +1,103 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Subsystems/WorldSubsystem.h"
+
+// Generated Include
+#include "TableauRuntimeSubsystem.generated.h"
+
+// Forward Declares
+class UStaticMesh;
+class UFoliageType;
+class UTableauComponent;
+class UTableauHISMComponent;
+class FTableauLatentTree;
+
+
+/*
+* UTableauRuntimeSubsystem evaluates Tableau Components without the editor, so that procedural levels may be
+* populated from Tableau Assets at load time.
+*
+* Requests made in the same frame share a single Evaluation Context: the assets reachable from the requested
+* Tableaux are loaded once on the game thread, after which each latent tree is evaluated on a worker thread.
+* Tableaux whose filters query the scene (tags, splines, exclusion volumes) are evaluated on the game thread
+* instead, and those filtered by landscape weightmap, which can't be read outside the editor, are refused.
+* Completed evaluations are applied on the game thread, within a per frame budget of instances, by filling a HISM
+* per Static Mesh and per Foliage Type with world space instances.
+*
+* The HISMs are hosted by a transient Actor and pooled: releasing an evaluation clears its HISMs and returns them
+* to the pool, from which a later evaluation of the same Static Mesh or Foliage Type may take them again.
+*
+* Only Static Meshes and Foliage Types can be instanced. Elements expressed as configured actors, and Actor or
+* Blueprint assets, are skipped.
+*/
+UCLASS()
+class TABLEAUASSET_API UTableauRuntimeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem interface
+
+	// Evaluate the Component's Tableau asynchronously. Its runtime instances are replaced when the evaluation is applied.
+	UFUNCTION(BlueprintCallable, Category = Tableau)
+	void RequestEvaluation(UTableauComponent* TableauComponent);
+
+	// Abandon any evaluation in flight for the Component and return its runtime instances to the pool.
+	// Does not wait for the abandoned evaluation's task.
+	UFUNCTION(BlueprintCallable, Category = Tableau)
+	void ReleaseEvaluation(UTableauComponent* TableauComponent);
+
+	// Is an evaluation requested or in flight for the Component?
+	bool IsEvaluationPending(const UTableauComponent* TableauComponent) const;
+
+private:
+	// World space instance transforms gathered from the evaluation.
+	struct FEvaluationResult
+	{
+		TMap<UStaticMesh*, TArray<FTransform>> MeshInstances;
+		TMap<UFoliageType*, TArray<FTransform>> FoliageInstances;
+		int32 SkippedNodes = 0;
+		int32 NumInstances = 0;
+	};
+
+	struct FEvaluation
+	{
+		TWeakObjectPtr<UTableauComponent> TableauComponent;
+		TSharedPtr<FTableauLatentTree> LatentTree;
+		TSharedPtr<FEvaluationResult> Result;
+		TFuture<void> Future;
+	};
+
+	bool Tick(float DeltaTime);
+	void ScheduleTick();
+	void LaunchPendingEvaluations();
+	void ApplyEvaluation(FEvaluation& Evaluation);
+
+	static void GatherInstances(FTableauLatentTree& LatentTree, const FTransform& TableauSpace, FEvaluationResult& Result);
+
+	// Take a pooled HISM configured for the Static Mesh or Foliage Type, creating one if none is free.
+	UTableauHISMComponent* AcquireComponent(UStaticMesh* StaticMesh, UFoliageType* FoliageType);
+	void ReleaseRuntimeComponents(UTableauComponent* TableauComponent);
+
+private:
+	TArray<TWeakObjectPtr<UTableauComponent>> PendingComponents;
+
+	// The latent trees and results are owned here, and only released once their task has completed, so that
+	// the shared Evaluation Context is always destroyed on the game thread.
+	TArray<FEvaluation> Evaluations;
+
+	// Transient Actor hosting the runtime HISMs.
+	UPROPERTY(Transient)
+	AActor* HostActor;
+
+	// Cleared HISMs available for reuse.
+	UPROPERTY(Transient)
+	TArray<UTableauHISMComponent*> PooledComponents;
+
+	FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+// Generated Include
+#include "TableauStreamingSubsystem.generated.h"
+
+// Forward Declares
+class UTableauComponent;
+
+
+/*
+* UTableauStreamingSubsystem generates Tableau content around the streaming sources of a game World rather than
+* keeping it baked into the level.
+*
+* Registered Tableau Components are partitioned into grid cells by the location of their owners. The player
+* view points are the streaming sources. When a cell comes within the load radius of a source, its Tableaux are
+* evaluated asynchronously by the UTableauRuntimeSubsystem and expressed in pooled instanced components. When
+* the cell is further than the load radius plus a hysteresis distance from every source, the evaluations are
+* released and the components returned to the pool. Evaluation is deterministic in the Component's Seed, so a
+* cell that is loaded again shows the same content.
+*/
+UCLASS()
+class TABLEAUASSET_API UTableauStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem interface
+
+	// Add the Component to the grid cell containing its owner. It is evaluated when the cell is loaded.
+	void RegisterTableau(UTableauComponent* TableauComponent);
+
+	// Remove the Component from the grid, releasing its runtime instances.
+	void UnregisterTableau(UTableauComponent* TableauComponent);
+
+	// Add a streaming source in addition to the player view points, eg. for a cinematic camera.
+	// Sources are identified by name; adding an existing source moves it.
+	void SetStreamingSource(const FName& SourceName, const FVector& Location);
+	void RemoveStreamingSource(const FName& SourceName);
+
+	// Load and release cells according to the current streaming sources.
+	void UpdateStreaming();
+
+private:
+	struct FCell
+	{
+		TArray<TWeakObjectPtr<UTableauComponent>> Components;
+		bool bLoaded = false;
+	};
+
+	bool Tick(float DeltaTime);
+	FIntPoint GetCell(const FVector& Location) const;
+	void GatherStreamingSources(TArray<FVector>& OutSources) const;
+	void LoadCell(FCell& Cell);
+	void UnloadCell(FCell& Cell);
+
+private:
+	TMap<FIntPoint, FCell> Cells;
+
+	// The cell each registered Component was placed in.
+	TMap<TWeakObjectPtr<UTableauComponent>, FIntPoint> ComponentCells;
+
+	TMap<FName, FVector> AdditionalSources;
+
+	// Cell size used to partition the registered Components. Changing the console variable takes effect when
+	// the grid is next empty.
+	float CellSize = 0.0f;
+
+	float TimeSinceUpdate = 0.0f;
+
+	FDelegateHandle TickerHandle;
+};
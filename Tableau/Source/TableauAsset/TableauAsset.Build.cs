@@ -36,6 +36,8 @@ public class TableauAsset : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"Foliage",
+				"Landscape",
 				"Slate",
 				"SlateCore",
 				// ... add private dependencies that you statically link with here ...	
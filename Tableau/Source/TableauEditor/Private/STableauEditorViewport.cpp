@@ -3,17 +3,32 @@
 #include "STableauEditorViewport.h"
 
 // Engine Includes
+#include "Engine/StaticMesh.h"
+#include "FoliageType_InstancedStaticMesh.h"
 #include "Slate/SceneViewport.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/SOverlay.h"
+#include "Widgets/Text/STextBlock.h"
 
 // Local Includes
 #include "TableauAsset.h"
+#include "TableauHISMComponent.h"
 #include "TableauEditorViewportClient.h"
-#include "TableauLatentTree.h"
+#include "TableauPreviewEvaluator.h"
 #include "TableauUtils.h"
 
 
 #define LOCTEXT_NAMESPACE "TableauEditorViewport"
 
+// constants
+static const int32 SpeculativeSeedCount = 8;
+static const int32 MaxGridDimension = 8;
+static const float GridSpacingScale = 1.25f;
+static const float MinGridSpacing = 100.0f;
+
 
 void STableauEditorViewport::Construct(const FArguments& InArgs)
 {
@@ -29,6 +44,8 @@ void STableauEditorViewport::Construct(const FArguments& InArgs)
 
 	Tableau = InArgs._ObjectToEdit;
 
+	PreviewEvaluator = MakeUnique<FTableauPreviewEvaluator>(World);
+
 	CurrentViewMode = VMI_Lit;
 
 	SEditorViewport::Construct(SEditorViewport::FArguments());
@@ -37,7 +54,15 @@ void STableauEditorViewport::Construct(const FArguments& InArgs)
 
 STableauEditorViewport::STableauEditorViewport()
 	: PreviewScene(MakeShareable(new FAdvancedPreviewScene(FPreviewScene::ConstructionValues())))
-	, Seed(0.0)
+	, Seed(0)
+	, ScrubDirection(1)
+	, bPreviewCurrent(false)
+	, bResetCameraOnPreview(false)
+	, bGridPreview(false)
+	, GridColumns(4)
+	, GridRows(4)
+	, GridCellsApplied(INDEX_NONE)
+	, GridSpacing(0.0f)
 {
 
 }
@@ -74,41 +99,416 @@ void STableauEditorViewport::RefreshViewport()
 
 void STableauEditorViewport::UpdatePreviewTableau(UTableauAsset* InTableau, bool bResetCamera/*= true*/)
 {
-	// Clear any existing components
-	for (USceneComponent* Component : TableauComponents)
+	Tableau = InTableau;
+
+	// Cached results are stale once the Tableau is edited. The current preview is kept until the new
+	// evaluation completes.
+	PreviewEvaluator->SetTableau(Tableau);
+	bPreviewCurrent = false;
+	GridCellsApplied = INDEX_NONE;
+	bResetCameraOnPreview |= bResetCamera;
+
+	RequestPreview();
+}
+
+bool STableauEditorViewport::IsPreviewingTableau(const UTableauAsset* InTableau) const
+{
+	return PreviewEvaluator->DependsOn(InTableau);
+}
+
+int32 STableauEditorViewport::GetPreviewSeed() const
+{
+	return Seed;
+}
+
+void STableauEditorViewport::SetPreviewSeed(int32 InSeed)
+{
+	if (InSeed == Seed)
 	{
-		Component->DestroyComponent();
+		return;
 	}
-	TableauComponents.Empty();
 
+	// Speculate that scrubbing continues in the same direction.
+	ScrubDirection = (InSeed < Seed) ? -1 : 1;
+	Seed = InSeed;
+	bPreviewCurrent = false;
+	GridCellsApplied = INDEX_NONE;
+
+	RequestPreview();
+}
+
+void STableauEditorViewport::RequestPreview()
+{
+	if (bGridPreview)
+	{
+		UpdateGridPreview();
+		return;
+	}
+
+	if (bPreviewCurrent)
+	{
+		return;
+	}
+
+	if (TSharedPtr<const FTableauPreviewResult> Result = PreviewEvaluator->FindResult(Seed))
+	{
+		ApplyPreviewResult(*Result);
+	}
+	else
+	{
+		PreviewEvaluator->RequestEvaluation(Seed);
+	}
+
+	for (int32 Offset = 1; Offset <= SpeculativeSeedCount; ++Offset)
+	{
+		if (!PreviewEvaluator->RequestEvaluation(Seed + Offset * ScrubDirection))
+		{
+			break;
+		}
+	}
+}
+
+void STableauEditorViewport::ApplyPreviewResult(const FTableauPreviewResult& Result)
+{
+	ClearPreviewComponents();
+
+	FBox Box = Result.Bounds;
+
+	for (const TPair<UObject*, FTransform>& Asset : Result.Assets)
+	{
+		Box += AddPreviewComponent(Asset.Key, Asset.Value);
+	}
+
+	UpdateInstancedComponents(Result.InstanceTransforms);
+
+	if (bResetCameraOnPreview)
+	{
+		// Set camera
+		EditorViewportClient->FocusViewportOnBox(Box);
+		bResetCameraOnPreview = false;
+	}
+
+	bPreviewCurrent = true;
+}
+
+void STableauEditorViewport::UpdateGridPreview()
+{
+	const int32 CellCount = GridColumns * GridRows;
+	if (GridCellsApplied == CellCount)
+	{
+		return;
+	}
+
+	// Every cell is requested at once, so that the seeds are evaluated in parallel.
+	TArray<TSharedPtr<const FTableauPreviewResult>> Results;
+	Results.SetNum(CellCount);
+
+	int32 CellsAvailable = 0;
+	for (int32 Cell = 0; Cell < CellCount; ++Cell)
+	{
+		Results[Cell] = PreviewEvaluator->FindResult(Seed + Cell);
+		if (Results[Cell].IsValid())
+		{
+			++CellsAvailable;
+		}
+		else
+		{
+			PreviewEvaluator->RequestEvaluation(Seed + Cell);
+		}
+	}
+
+	// The grid is only rebuilt as more of its cells complete.
+	if (CellsAvailable > 0 && CellsAvailable != GridCellsApplied)
+	{
+		ApplyGridPreview(Results);
+		GridCellsApplied = CellsAvailable;
+	}
+}
+
+void STableauEditorViewport::ApplyGridPreview(const TArray<TSharedPtr<const FTableauPreviewResult>>& Results)
+{
+	ClearPreviewComponents();
+
+	// Cells are spaced to fit the widest variant evaluated so far.
+	GridSpacing = 0.0f;
+	for (const TSharedPtr<const FTableauPreviewResult>& Result : Results)
+	{
+		if (Result.IsValid() && Result->Bounds.IsValid)
+		{
+			const FVector Size = Result->Bounds.GetSize();
+			GridSpacing = FMath::Max3(GridSpacing, Size.X, Size.Y);
+		}
+	}
+	GridSpacing = FMath::Max(GridSpacing * GridSpacingScale, MinGridSpacing);
+
+	// All of the cells share the instanced components.
+	TMap<TPair<UStaticMesh*, UFoliageType*>, TArray<FTransform>> InstanceTransforms;
 	FBox Box(ForceInit);
 
-	if (Tableau != nullptr)
+	for (int32 Cell = 0; Cell < Results.Num(); ++Cell)
 	{
-		// Express the latent tree -- disregarding foliage and captured config -- for display in the editor.
-		
-		TSharedPtr<FTableauFilterSampler> Filter = MakeShareable(new FTableauFilterSampler(FTransform::Identity));
-		FTableauLatentTree TableauLatentTree(Tableau, Filter, true);
-		TableauLatentTree.EvaluateLatentTree(Seed);
+		const FTableauPreviewResult* Result = Results[Cell].Get();
+		if (Result == nullptr)
+		{
+			continue;
+		}
+
+		// Center each variant on its cell.
+		const FVector Center = Result->Bounds.IsValid ? Result->Bounds.GetCenter() : FVector::ZeroVector;
+		const FVector Offset = GetGridCellOrigin(Cell) - FVector(Center.X, Center.Y, 0.0f);
 
-		TArray<FTableauRecipeNode> Recipes = TableauLatentTree.GetRecipe();
-		for (const FTableauRecipeNode& RecipeNode : Recipes)
+		for (const TPair<TPair<UStaticMesh*, UFoliageType*>, TArray<FTransform>>& Instances : Result->InstanceTransforms)
 		{
-			if (RecipeNode.AssetReference.IsValid())
+			TArray<FTransform>& CellTransforms = InstanceTransforms.FindOrAdd(Instances.Key);
+			CellTransforms.Reserve(CellTransforms.Num() + Instances.Value.Num());
+			for (const FTransform& Instance : Instances.Value)
 			{
-				USceneComponent* NewComponent = FTableauUtils::BuildComponent(RecipeNode.AssetReference.Get());
-				TableauComponents.Add(NewComponent);
-				PreviewScene->AddComponent(NewComponent, RecipeNode.LocalTransform);
-				Box += NewComponent->Bounds.GetBox();
+				CellTransforms.Add(FTransform(Instance.GetRotation(), Instance.GetTranslation() + Offset, Instance.GetScale3D()));
 			}
 		}
 
-		if (bResetCamera)
+		for (const TPair<UObject*, FTransform>& Asset : Result->Assets)
+		{
+			Box += AddPreviewComponent(Asset.Key, FTransform(Asset.Value.GetRotation(), Asset.Value.GetTranslation() + Offset, Asset.Value.GetScale3D()));
+		}
+
+		Box += Result->Bounds.ShiftBy(Offset);
+	}
+
+	UpdateInstancedComponents(InstanceTransforms);
+
+	if (bResetCameraOnPreview)
+	{
+		EditorViewportClient->FocusViewportOnBox(Box);
+		bResetCameraOnPreview = false;
+	}
+}
+
+FVector STableauEditorViewport::GetGridCellOrigin(int32 Cell) const
+{
+	return FVector((Cell % GridColumns) * GridSpacing, (Cell / GridColumns) * GridSpacing, 0.0f);
+}
+
+bool STableauEditorViewport::SelectGridCell(const FVector& RayOrigin, const FVector& RayDirection)
+{
+	if (!bGridPreview || GridSpacing <= 0.0f || FMath::IsNearlyZero(RayDirection.Z))
+	{
+		return false;
+	}
+
+	// Find where the ray meets the ground plane the cells are laid out on.
+	const float Distance = -RayOrigin.Z / RayDirection.Z;
+	if (Distance < 0.0f)
+	{
+		return false;
+	}
+
+	const FVector GroundLocation = RayOrigin + RayDirection * Distance;
+	const int32 Column = FMath::RoundToInt(GroundLocation.X / GridSpacing);
+	const int32 Row = FMath::RoundToInt(GroundLocation.Y / GridSpacing);
+	if (Column < 0 || Column >= GridColumns || Row < 0 || Row >= GridRows)
+	{
+		return false;
+	}
+
+	// Apply the cell's seed and return to previewing it alone.
+	const int32 CellSeed = Seed + Row * GridColumns + Column;
+	SetGridPreview(ECheckBoxState::Unchecked);
+	SetPreviewSeed(CellSeed);
+	bResetCameraOnPreview = true;
+
+	return true;
+}
+
+ECheckBoxState STableauEditorViewport::IsGridPreview() const
+{
+	return bGridPreview ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void STableauEditorViewport::SetGridPreview(ECheckBoxState InState)
+{
+	bGridPreview = (InState == ECheckBoxState::Checked);
+	bPreviewCurrent = false;
+	GridCellsApplied = INDEX_NONE;
+	bResetCameraOnPreview = true;
+
+	RequestPreview();
+}
+
+int32 STableauEditorViewport::GetGridColumns() const
+{
+	return GridColumns;
+}
+
+void STableauEditorViewport::SetGridColumns(int32 InColumns)
+{
+	GridColumns = FMath::Clamp(InColumns, 1, MaxGridDimension);
+	GridCellsApplied = INDEX_NONE;
+}
+
+int32 STableauEditorViewport::GetGridRows() const
+{
+	return GridRows;
+}
+
+void STableauEditorViewport::SetGridRows(int32 InRows)
+{
+	GridRows = FMath::Clamp(InRows, 1, MaxGridDimension);
+	GridCellsApplied = INDEX_NONE;
+}
+
+void STableauEditorViewport::ClearPreviewComponents()
+{
+	// Non-instanced components are few, so they are simply rebuilt.
+	for (USceneComponent* Component : TableauComponents)
+	{
+		PreviewScene->RemoveComponent(Component);
+		Component->DestroyComponent();
+	}
+	TableauComponents.Empty();
+}
+
+FBox STableauEditorViewport::AddPreviewComponent(UObject* Asset, const FTransform& Transform)
+{
+	USceneComponent* NewComponent = FTableauUtils::BuildComponent(Asset);
+	TableauComponents.Add(NewComponent);
+	PreviewScene->AddComponent(NewComponent, Transform);
+	return NewComponent->Bounds.GetBox();
+}
+
+void STableauEditorViewport::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SEditorViewport::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	PreviewEvaluator->Tick();
+
+	// Swap in the result for the current seed once it's ready. Requests dropped while too many evaluations
+	// were in flight are made again.
+	RequestPreview();
+}
+
+void STableauEditorViewport::PopulateViewportOverlays(TSharedRef<SOverlay> Overlay)
+{
+	SEditorViewport::PopulateViewportOverlays(Overlay);
+
+	Overlay->AddSlot()
+		.HAlign(HAlign_Right)
+		.VAlign(VAlign_Top)
+		.Padding(FMargin(6.0f, 36.0f))
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(FMargin(0.0f, 0.0f, 6.0f, 0.0f))
+			[
+				SNew(STextBlock)
+				.Text(LOCTEXT("PreviewSeedLabel", "Seed"))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SBox)
+				.WidthOverride(100.0f)
+				[
+					SNew(SSpinBox<int32>)
+					.MinValue(TOptional<int32>())
+					.MaxValue(TOptional<int32>())
+					.Delta(1)
+					.Value(this, &STableauEditorViewport::GetPreviewSeed)
+					.OnValueChanged(this, &STableauEditorViewport::SetPreviewSeed)
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(FMargin(12.0f, 0.0f, 6.0f, 0.0f))
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &STableauEditorViewport::IsGridPreview)
+				.OnCheckStateChanged(this, &STableauEditorViewport::SetGridPreview)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("GridPreviewLabel", "Seed Grid"))
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SBox)
+				.WidthOverride(40.0f)
+				[
+					SNew(SSpinBox<int32>)
+					.MinValue(1)
+					.MaxValue(MaxGridDimension)
+					.Value(this, &STableauEditorViewport::GetGridColumns)
+					.OnValueChanged(this, &STableauEditorViewport::SetGridColumns)
+					.ToolTipText(LOCTEXT("GridColumnsTooltip", "Columns of seeds in the grid"))
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(FMargin(4.0f, 0.0f, 0.0f, 0.0f))
+			[
+				SNew(SBox)
+				.WidthOverride(40.0f)
+				[
+					SNew(SSpinBox<int32>)
+					.MinValue(1)
+					.MaxValue(MaxGridDimension)
+					.Value(this, &STableauEditorViewport::GetGridRows)
+					.OnValueChanged(this, &STableauEditorViewport::SetGridRows)
+					.ToolTipText(LOCTEXT("GridRowsTooltip", "Rows of seeds in the grid"))
+				]
+			]
+		];
+}
+
+void STableauEditorViewport::UpdateInstancedComponents(const TMap<TPair<UStaticMesh*, UFoliageType*>, TArray<FTransform>>& InstanceTransforms)
+{
+	TArray<UTableauHISMComponent*> UpdatedComponents;
+	UpdatedComponents.Reserve(InstanceTransforms.Num());
+
+	for (const TPair<TPair<UStaticMesh*, UFoliageType*>, TArray<FTransform>>& Instances : InstanceTransforms)
+	{
+		UStaticMesh* StaticMesh = Instances.Key.Key;
+		const FSoftObjectPath FoliageTypePath(Instances.Key.Value);
+
+		// Reuse the component already previewing this source, if there is one.
+		const int32 ComponentIndex = InstancedComponents.IndexOfByPredicate([StaticMesh, &FoliageTypePath](const UTableauHISMComponent* Component)
+			{
+				return Component->GetStaticMesh() == StaticMesh && Component->FoliageType == FoliageTypePath;
+			});
+
+		UTableauHISMComponent* Component = nullptr;
+		if (ComponentIndex != INDEX_NONE)
 		{
-			// Set camera
-			EditorViewportClient->FocusViewportOnBox(Box);
-		}		
+			Component = InstancedComponents[ComponentIndex];
+			InstancedComponents.RemoveAtSwap(ComponentIndex);
+		}
+		else
+		{
+			Component = NewObject<UTableauHISMComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+			Component->SetStaticMesh(StaticMesh);
+			Component->SetMobility(EComponentMobility::Static);
+			Component->ConfigureFromFoliageType(Cast<UFoliageType_InstancedStaticMesh>(Instances.Key.Value));
+			Component->FoliageType = FoliageTypePath;
+			PreviewScene->AddComponent(Component, FTransform::Identity);
+		}
+
+		Component->SetInstancesInBulk(Instances.Value);
+		Component->RebuildClusterTree();
+		UpdatedComponents.Add(Component);
 	}
+
+	// Any components left over preview sources no longer in the Tableau.
+	for (UTableauHISMComponent* Component : InstancedComponents)
+	{
+		PreviewScene->RemoveComponent(Component);
+		Component->DestroyComponent();
+	}
+
+	InstancedComponents = MoveTemp(UpdatedComponents);
 }
 
 bool STableauEditorViewport::IsVisible() const
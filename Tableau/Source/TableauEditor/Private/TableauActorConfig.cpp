@@ -0,0 +1,398 @@
+#include "TableauActorConfig.h"
+
+// Engine Includes
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "Misc/FeedbackContext.h"
+#include "Misc/ScopedSlowTask.h"
+#include "UnrealExporter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+// Local Includes
+#include "TableauEditorModule.h"
+
+#define LOCTEXT_NAMESPACE "TableauActorConfig"
+
+// constants
+static const uint32 ActorConfigMagic = 0x43415454;
+static const uint32 ActorConfigVersion = 2;
+static const uint32 ActorConfigVersionWithoutCustomProperties = 1;
+static const FName ActorLabelPropertyName(TEXT("ActorLabel"));
+static const FName RootComponentPropertyName(TEXT("RootComponent"));
+static const FName InstanceComponentsPropertyName(TEXT("InstanceComponents"));
+
+namespace
+{
+	enum class EConfigReference : uint8
+	{
+		Null,
+		// The captured actor, or one of its subobjects, by path relative to the actor.
+		Local,
+		// Anything outside the level, by full path.
+		External
+	};
+
+	/*
+	* Serializes object references so that they survive being spawned as a new actor: references within the
+	* captured actor are made relative to it, and references to other level objects are dropped.
+	*
+	* The placement of the actor -- its root transform and label -- is left out, as it's replaced on spawn.
+	* Copies of the same prop then capture identically, so the Tableau Asset stores their config once.
+	*
+	* The actor's component references are skipped when its properties are loaded before construction, since
+	* the components added to the captured instance don't exist yet and would resolve to null.
+	*/
+	class FConfigArchive : public FObjectAndNameAsStringProxyArchive
+	{
+	public:
+		FConfigArchive(FArchive& InInnerArchive, AActor* InActor, bool bInSkipPlacement, bool bInSkipComponentReferences = false)
+			: FObjectAndNameAsStringProxyArchive(InInnerArchive, true)
+			, Actor(InActor)
+			, bSkipPlacement(bInSkipPlacement)
+			, bSkipComponentReferences(bInSkipComponentReferences)
+		{
+		}
+
+		virtual bool ShouldSkipProperty(const FProperty* InProperty) const override
+		{
+			if (bSkipComponentReferences && InProperty->GetOwnerClass() == AActor::StaticClass())
+			{
+				const FName PropertyName = InProperty->GetFName();
+				if (PropertyName == RootComponentPropertyName || PropertyName == InstanceComponentsPropertyName)
+				{
+					return true;
+				}
+			}
+
+			if (bSkipPlacement)
+			{
+				const FName PropertyName = InProperty->GetFName();
+				if (PropertyName == USceneComponent::GetRelativeLocationPropertyName()
+					|| PropertyName == USceneComponent::GetRelativeRotationPropertyName()
+					|| PropertyName == USceneComponent::GetRelativeScale3DPropertyName()
+					|| PropertyName == ActorLabelPropertyName)
+				{
+					return true;
+				}
+			}
+
+			return FObjectAndNameAsStringProxyArchive::ShouldSkipProperty(InProperty);
+		}
+
+		virtual FArchive& operator<<(UObject*& Obj) override
+		{
+			if (IsLoading())
+			{
+				uint8 ReferenceType = (uint8)EConfigReference::Null;
+				InnerArchive << ReferenceType;
+
+				if (ReferenceType == (uint8)EConfigReference::Local)
+				{
+					FString RelativePath;
+					InnerArchive << RelativePath;
+					Obj = RelativePath.IsEmpty() ? Actor : StaticFindObject(UObject::StaticClass(), Actor, *RelativePath);
+				}
+				else if (ReferenceType == (uint8)EConfigReference::External)
+				{
+					FObjectAndNameAsStringProxyArchive::operator<<(Obj);
+				}
+				else
+				{
+					Obj = nullptr;
+				}
+			}
+			else
+			{
+				EConfigReference ReferenceType = EConfigReference::Null;
+				if (Obj && (Obj == Actor || Obj->IsIn(Actor)))
+				{
+					ReferenceType = EConfigReference::Local;
+				}
+				else if (Obj && Obj->GetTypedOuter<ULevel>() == nullptr)
+				{
+					ReferenceType = EConfigReference::External;
+				}
+
+				uint8 ReferenceTypeValue = (uint8)ReferenceType;
+				InnerArchive << ReferenceTypeValue;
+
+				if (ReferenceType == EConfigReference::Local)
+				{
+					FString RelativePath = (Obj == Actor) ? FString() : Obj->GetPathName(Actor);
+					InnerArchive << RelativePath;
+				}
+				else if (ReferenceType == EConfigReference::External)
+				{
+					FObjectAndNameAsStringProxyArchive::operator<<(Obj);
+				}
+			}
+
+			return *this;
+		}
+
+	private:
+		AActor* Actor;
+		bool bSkipPlacement;
+		bool bSkipComponentReferences;
+	};
+
+	void SaveProperties(AActor* Actor, UObject* Object, TArray<uint8>& OutProperties)
+	{
+		FMemoryWriter Writer(OutProperties, true);
+		FConfigArchive Archive(Writer, Actor, Object == Actor || Object == Actor->GetRootComponent());
+		Object->SerializeScriptProperties(Archive);
+	}
+
+	void LoadProperties(AActor* Actor, UObject* Object, const TArray<uint8>& Properties, bool bSkipComponentReferences = false)
+	{
+		FMemoryReader Reader(Properties, true);
+		FConfigArchive Archive(Reader, Actor, false, bSkipComponentReferences);
+		Object->SerializeScriptProperties(Archive);
+	}
+
+	// Data kept outside the reflected properties, eg. the painted vertex colors of a Static Mesh Component,
+	// exported as the CustomProperties lines of T3D text.
+	FString SaveCustomProperties(UObject* Object)
+	{
+		FStringOutputDevice CustomProperties;
+		Object->ExportCustomProperties(CustomProperties, 0);
+		return MoveTemp(CustomProperties);
+	}
+
+	void LoadCustomProperties(UObject* Object, const FString& CustomProperties)
+	{
+		TArray<FString> Lines;
+		CustomProperties.ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			const TCHAR* Str = *Line;
+			FParse::Next(&Str);
+			if (FParse::Command(&Str, TEXT("CustomProperties")))
+			{
+				Object->ImportCustomProperties(Str, GWarn);
+			}
+		}
+	}
+}
+
+
+//////////////////////////////////////////////////
+// FTableauActorConfig
+
+void FTableauActorConfig::CaptureActors(const TArray<AActor*>& Actors, TArray<TArray<uint8>>& OutConfigs)
+{
+	OutConfigs.SetNum(Actors.Num());
+
+	FScopedSlowTask SlowTask(Actors.Num(), LOCTEXT("CapturingActors", "Capturing actors..."));
+	SlowTask.MakeDialogDelayed(1.0f);
+
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		SlowTask.EnterProgressFrame();
+		if (!CaptureActor(Actors[Index], OutConfigs[Index]))
+		{
+			OutConfigs[Index].Empty();
+		}
+	}
+}
+
+bool FTableauActorConfig::CaptureActor(AActor* Actor, TArray<uint8>& OutConfig)
+{
+	if (Actor == nullptr || Actor->IsPendingKillPending())
+	{
+		return false;
+	}
+
+	OutConfig.Reset();
+	FMemoryWriter Writer(OutConfig, true);
+
+	uint32 Magic = ActorConfigMagic;
+	uint32 Version = ActorConfigVersion;
+	FString ClassPath = Actor->GetClass()->GetPathName();
+	Writer << Magic << Version << ClassPath;
+
+	FString RootComponentName = Actor->GetRootComponent() ? Actor->GetRootComponent()->GetName() : FString();
+	Writer << RootComponentName;
+
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+	int32 ComponentCount = Components.Num();
+	Writer << ComponentCount;
+
+	for (UActorComponent* Component : Components)
+	{
+		FString ComponentName = Component->GetName();
+		FString ComponentClassPath = Component->GetClass()->GetPathName();
+		bool bInstanceComponent = (Component->CreationMethod == EComponentCreationMethod::Instance);
+		TArray<uint8> Properties;
+		SaveProperties(Actor, Component, Properties);
+		FString CustomProperties = SaveCustomProperties(Component);
+
+		Writer << ComponentName << ComponentClassPath << bInstanceComponent << Properties << CustomProperties;
+	}
+
+	TArray<uint8> ActorProperties;
+	SaveProperties(Actor, Actor, ActorProperties);
+	FString ActorCustomProperties = SaveCustomProperties(Actor);
+	Writer << ActorProperties << ActorCustomProperties;
+
+	return !Writer.IsError();
+}
+
+AActor* FTableauActorConfig::SpawnActor(UWorld* World, const TArray<uint8>& Config, const FTransform& Xform, const FName& Name)
+{
+	FMemoryReader Reader(Config, true);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	FString ClassPath;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != ActorConfigMagic || (Version != ActorConfigVersion && Version != ActorConfigVersionWithoutCustomProperties))
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to spawn %s: the captured config is malformed."), *Name.ToString());
+		return nullptr;
+	}
+
+	Reader << ClassPath;
+	UClass* ActorClass = LoadObject<UClass>(nullptr, *ClassPath);
+	if (ActorClass == nullptr || !ActorClass->IsChildOf(AActor::StaticClass()))
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to spawn %s: class %s not found."), *Name.ToString(), *ClassPath);
+		return nullptr;
+	}
+
+	struct FCapturedComponent
+	{
+		FString Name;
+		FString ClassPath;
+		bool bInstanceComponent;
+		TArray<uint8> Properties;
+		FString CustomProperties;
+	};
+
+	// Configs captured before custom properties were recorded hold neither them nor the root's name.
+	const bool bHasCustomProperties = (Version != ActorConfigVersionWithoutCustomProperties);
+
+	FString RootComponentName;
+	if (bHasCustomProperties)
+	{
+		Reader << RootComponentName;
+	}
+
+	int32 ComponentCount = 0;
+	Reader << ComponentCount;
+	if (Reader.IsError() || ComponentCount < 0)
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to spawn %s: the captured config is malformed."), *Name.ToString());
+		return nullptr;
+	}
+
+	TArray<FCapturedComponent> CapturedComponents;
+	CapturedComponents.SetNum(ComponentCount);
+	for (FCapturedComponent& CapturedComponent : CapturedComponents)
+	{
+		Reader << CapturedComponent.Name << CapturedComponent.ClassPath << CapturedComponent.bInstanceComponent << CapturedComponent.Properties;
+		if (bHasCustomProperties)
+		{
+			Reader << CapturedComponent.CustomProperties;
+		}
+	}
+
+	TArray<uint8> ActorProperties;
+	FString ActorCustomProperties;
+	Reader << ActorProperties;
+	if (bHasCustomProperties)
+	{
+		Reader << ActorCustomProperties;
+	}
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to spawn %s: the captured config is malformed."), *Name.ToString());
+		return nullptr;
+	}
+
+	// The actor's properties are applied before construction, as they may drive its construction script.
+	// Its references to its components are left to the components recreated below.
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = World->GetCurrentLevel();
+	SpawnParameters.ObjectFlags = RF_Transactional;
+	SpawnParameters.bDeferConstruction = true;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Actor = World->SpawnActor(ActorClass, &FTransform::Identity, SpawnParameters);
+	if (Actor == nullptr)
+	{
+		return nullptr;
+	}
+
+	LoadProperties(Actor, Actor, ActorProperties, true);
+	LoadCustomProperties(Actor, ActorCustomProperties);
+	Actor->FinishSpawning(FTransform::Identity);
+
+	// Recreate the components that were added to the captured instance, now that construction has created the
+	// rest, so that the component properties loaded below may refer to any of them.
+	TArray<TPair<UActorComponent*, const FCapturedComponent*>> Components;
+	for (const FCapturedComponent& CapturedComponent : CapturedComponents)
+	{
+		UActorComponent* Component = FindObjectFast<UActorComponent>(Actor, *CapturedComponent.Name);
+		if (Component == nullptr && CapturedComponent.bInstanceComponent)
+		{
+			UClass* ComponentClass = LoadObject<UClass>(nullptr, *CapturedComponent.ClassPath);
+			if (ComponentClass && ComponentClass->IsChildOf(UActorComponent::StaticClass()))
+			{
+				Component = NewObject<UActorComponent>(Actor, ComponentClass, *CapturedComponent.Name, RF_Transactional);
+				Actor->AddInstanceComponent(Component);
+			}
+		}
+
+		if (Component)
+		{
+			Components.Add(TPair<UActorComponent*, const FCapturedComponent*>(Component, &CapturedComponent));
+		}
+		else
+		{
+			UE_LOG(LogTableau, Warning, TEXT("Component %s of %s could not be restored."), *CapturedComponent.Name, *Name.ToString());
+		}
+	}
+
+	for (const TPair<UActorComponent*, const FCapturedComponent*>& Component : Components)
+	{
+		LoadProperties(Actor, Component.Key, Component.Value->Properties);
+		LoadCustomProperties(Component.Key, Component.Value->CustomProperties);
+	}
+
+	// A recreated component may have been the captured actor's root.
+	if (!RootComponentName.IsEmpty())
+	{
+		USceneComponent* RootComponent = FindObjectFast<USceneComponent>(Actor, *RootComponentName);
+		if (RootComponent && RootComponent != Actor->GetRootComponent())
+		{
+			Actor->SetRootComponent(RootComponent);
+		}
+	}
+
+	for (const TPair<UActorComponent*, const FCapturedComponent*>& Component : Components)
+	{
+		if (!Component.Key->IsRegistered())
+		{
+			Component.Key->RegisterComponent();
+		}
+	}
+	Actor->ReregisterAllComponents();
+
+	if (USceneComponent* Root = Actor->GetRootComponent())
+	{
+		Root->SetRelativeTransform(Xform);
+	}
+
+	Actor->SetActorLabel(Name.ToString());
+	Actor->PostEditMove(true);
+	Actor->MarkPackageDirty();
+
+	return Actor;
+}
+
+#undef LOCTEXT_NAMESPACE
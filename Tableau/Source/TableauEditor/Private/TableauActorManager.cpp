@@ -4,6 +4,7 @@
 // Engine Includes
 #include "Editor.h"
 #include "Engine/Selection.h"
+#include "FoliageType.h"
 #include "LevelEditor.h"
 #include "ISceneOutliner.h"
 #include "ActorTreeItem.h"
@@ -13,17 +14,64 @@
 #include "Widgets/Views/STreeView.h"
 #include "AssetSelection.h"
 #include "ScopedTransaction.h"
-#include "Components/SplineComponent.h"
+#include "Async/ParallelFor.h"
 
 // Local Includes
 #include "TableauEditorModule.h"
 #include "TableauActorFactory.h"
 #include "TableauUtils.h"
+#include "TableauEvaluationContext.h"
+#include "TableauFloorSampler.h"
+#include "TableauFoliageManager.h"
+#include "TableauBakedRecipe.h"
 
 
 // constants
 static const FFloatInterval DefaultViableGroundSlopeAngleInterval(0.0, 90.0);
 
+namespace
+{
+	// Gather the Static Mesh Components of tracked Instances. The first mesh of an Instance parents the meshes
+	// of its subordinate Instances.
+	void GatherInstanceMeshes(const TArray<FTableauInstanceTracker>& Instances, const FTransform& TableauSpace, TArray<FTableauBakeInstance>& OutInstances)
+	{
+		// The baked instance parenting the meshes of each tracker's subordinates.
+		TArray<int32> InstanceParents;
+		InstanceParents.Init(INDEX_NONE, Instances.Num());
+
+		for (int32 Index = 0; Index < Instances.Num(); ++Index)
+		{
+			const FTableauInstanceTracker& Instance = Instances[Index];
+			const int32 Parent = (Instance.Parent != INDEX_NONE) ? InstanceParents[Instance.Parent] : INDEX_NONE;
+			int32& InstanceParent = InstanceParents[Index];
+			InstanceParent = Parent;
+
+			if (AActor* Actor = Instance.TableauInstance.Get())
+			{
+				TArray<UStaticMeshComponent*> StaticMeshComponents;
+				Actor->GetComponents(StaticMeshComponents);
+				for (UStaticMeshComponent* StaticMeshComponent : StaticMeshComponents)
+				{
+					if (StaticMeshComponent->IsA<UInstancedStaticMeshComponent>() || StaticMeshComponent->GetStaticMesh() == nullptr)
+					{
+						continue;
+					}
+
+					FTableauBakeInstance& BakeInstance = OutInstances.AddDefaulted_GetRef();
+					BakeInstance.Source = StaticMeshComponent->GetStaticMesh();
+					BakeInstance.Transform = StaticMeshComponent->GetComponentTransform().GetRelativeTransform(TableauSpace);
+					BakeInstance.Parent = Parent;
+
+					if (InstanceParent == Parent)
+					{
+						InstanceParent = OutInstances.Num() - 1;
+					}
+				}
+			}
+		}
+	}
+}
+
 FTableauActorManager::FTableauActorManager(ATableauActor* InTableauActor, UWorld* InTargetWorld)
 	: TableauActor(InTableauActor)
 {
@@ -60,56 +108,253 @@ void FTableauActorManager::UpdateInstances(bool bIsPreview)
 		return;
 	}
 
+	// Untouched Instances may be reproduced by evaluating the recorded recipe, so only the Component need
+	// be transacted. Hand edited Instances must be recorded in full.
+	const bool bTransactInstances = bIsPreview || bAssetEditorWorkflow || !TableauComponent->CanRegenerateWithoutTransaction();
+	if (!bTransactInstances)
+	{
+		ModifyInstanceContainers();
+	}
+
+	{
+		TGuardValue<ITransaction*> UndoGuard(GUndo, bTransactInstances ? GUndo : nullptr);
+
+		if (!bIsPreview)
+		{
+			PrepareForRegeneration();
+		}
+
+		TUniquePtr<FTableauLatentTree> TableauLatentTree = EvaluateLatentTree(Filter);
+
+		SpawnInstances(TableauLatentTree->GetRecipe(), bIsPreview);
+		SpawnFoliage(TableauLatentTree->GetFoliages());
+
+		if (!bIsPreview)
+		{
+			FinalizeRegeneration();
+		}
+	}
+
 	if (!bIsPreview)
 	{
-		TableauComponent->RestoreInstances();
+		TableauComponent->RecordRegeneration(bTransactInstances);
+	}
+
+}
+
+void FTableauActorManager::ModifyInstanceContainers()
+{
+	if (ULevel* Level = TableauActor->GetLevel())
+	{
+		Level->Modify();
+	}
+
+	TableauActor->Modify();
+	if (USceneComponent* RootComponent = TableauActor->GetRootComponent())
+	{
+		RootComponent->Modify();
+	}
+}
+
+void FTableauActorManager::RegenerateFromRecipe()
+{
+	// Undo and redo have already restored the recipe inputs. Nothing here may be recorded.
+	TGuardValue<ITransaction*> UndoGuard(GUndo, nullptr);
 
-		// Remove child spawns
+	UTableauComponent* TableauComponent = TableauActor->GetTableauComponent();
+	if (TableauComponent->GetTableau() == nullptr)
+	{
+		TableauComponent->RestoreInstances();
 		DeleteInstances();
+		return;
 	}
 
-	FTableauLatentTree TableauLatentTree(TableauAsset, Filter, !bAssetEditorWorkflow);
-	TableauLatentTree.EvaluateLatentTree(TableauComponent->Seed);
+	TSharedPtr<FTableauFilterSampler> Filter = GatherFilters(TableauComponent);
+	PrepareForRegeneration();
 
-	SpawnInstances(TableauLatentTree.GetRecipe(), bIsPreview);
-	SpawnFoliage(TableauLatentTree.GetFoliages());
+	TUniquePtr<FTableauLatentTree> TableauLatentTree = EvaluateLatentTree(Filter);
+	const TArray<FTableauRecipeNode>& Recipe = TableauLatentTree->GetRecipe();
+	SpawnInstances(Recipe, 0, Recipe.Num(), false);
+	SpawnFoliage(TableauLatentTree->GetFoliages());
 
-	if (!bIsPreview)
+	FinalizeRegeneration();
+
+	// Evaluation is deterministic, but filters and snapping sample the World, which may have changed since.
+	const uint32 InstanceSnapshotHash = TableauComponent->ComputeInstanceSnapshotHash();
+	if (InstanceSnapshotHash != TableauComponent->InstanceSnapshotHash)
+	{
+		UE_LOG(LogTableau, Warning, TEXT("%s: Instances restored by undo differ from those recorded. The World may have changed since they were generated."), *TableauActor->GetName());
+		TableauComponent->InstanceSnapshotHash = InstanceSnapshotHash;
+	}
+}
+
+void FTableauActorManager::UpdateInstances(const TArray<ATableauActor*>& TableauActors)
+{
+	const FScopedTransaction Transaction(FText::FromString(TEXT("Regenerate Tableau")));
+
+	struct FBatchEntry
+	{
+		ATableauActor* TableauActor;
+		TSharedPtr<FTableauFilterSampler> Filter;
+		TUniquePtr<FTableauLatentTree> LatentTree;
+		bool bTransactInstances;
+	};
+
+	TArray<FBatchEntry> Batch;
+	Batch.Reserve(TableauActors.Num());
+
+	TMap<UWorld*, TSharedPtr<FTableauEvaluationContext>> Contexts;
+
+	// Gather everything the evaluations will need on the game thread.
+	for (ATableauActor* TableauActor : TableauActors)
 	{
-		if (TableauComponent->bAutoSnap)
+		if (TableauActor == nullptr || TableauActor->IsPendingKillPending())
 		{
-			SnapToFloor();
+			continue;
 		}
-		
-		MoveSelectionToTableauParent();
 
-		TableauComponent->UpdateBounds();
+		UTableauComponent* TableauComponent = TableauActor->GetTableauComponent();
+		const UTableauAsset* TableauAsset = TableauComponent->GetTableau();
 
-		// Need to allow a moment for the Outliner to refresh...
-		FTimerDelegate Delegate = FTimerDelegate::CreateLambda([]()
-			{
-				for (FSelectionIterator Iter(*GEditor->GetSelectedActors()); Iter; ++Iter)
-				{
-					if (ATableauActor* Actor = Cast<ATableauActor>(*Iter))
-					{
-						FTableauActorManager Manager(Actor);
-						Manager.CollapseActorInOutliner();
-					}
-				}
-			});
+		// If the Tableau Asset is not set, there is no point proceeding.
+		if (TableauAsset == nullptr)
+		{
+			continue;
+		}
+
+		FTableauActorManager Manager(TableauActor);
+
+		TSharedPtr<FTableauEvaluationContext>& Context = Contexts.FindOrAdd(Manager.TargetWorld);
+		if (!Context.IsValid())
+		{
+			Context = MakeShareable(new FTableauEvaluationContext(Manager.TargetWorld));
+		}
+		Context->AddTableau(TableauAsset);
+
+		TableauComponent->Modify(true);
 
-		static FTimerHandle DelayTimer;
-		if (DelayTimer.IsValid())
+		FBatchEntry& Entry = Batch.AddDefaulted_GetRef();
+		Entry.TableauActor = TableauActor;
+		Entry.Filter = Manager.GatherFilters(TableauComponent, Context.Get());
+		Entry.LatentTree = Manager.CreateLatentTree(Entry.Filter, Context);
+		Entry.bTransactInstances = !TableauComponent->CanRegenerateWithoutTransaction();
+		if (!Entry.bTransactInstances)
 		{
-			GEditor->GetTimerManager()->ClearTimer(DelayTimer);
+			Manager.ModifyInstanceContainers();
 		}
-		GEditor->GetTimerManager()->SetTimer(DelayTimer, Delegate, 0.1f, false);
 
+		TGuardValue<ITransaction*> UndoGuard(GUndo, Entry.bTransactInstances ? GUndo : nullptr);
+		Manager.PrepareForRegeneration();
+	}
+
+	// The latent trees only read from the shared context, so they may be evaluated concurrently. Filters that
+	// trace the scene or read the landscape are only safe on the game thread, so their Tableaux are evaluated here.
+	TArray<FBatchEntry*> ConcurrentEntries;
+	for (FBatchEntry& Entry : Batch)
+	{
+		if (!Entry.Filter.IsValid() || Entry.Filter->IsThreadSafe())
+		{
+			ConcurrentEntries.Add(&Entry);
+		}
+		else
+		{
+			Entry.LatentTree->EvaluateLatentTree(Entry.TableauActor->GetTableauComponent()->Seed);
+		}
+	}
+
+	ParallelFor(ConcurrentEntries.Num(), [&ConcurrentEntries](int32 Index)
+		{
+			FBatchEntry& Entry = *ConcurrentEntries[Index];
+			Entry.LatentTree->EvaluateLatentTree(Entry.TableauActor->GetTableauComponent()->Seed);
+		});
+
+	for (FBatchEntry& Entry : Batch)
+	{
+		{
+			TGuardValue<ITransaction*> UndoGuard(GUndo, Entry.bTransactInstances ? GUndo : nullptr);
+
+			FTableauActorManager Manager(Entry.TableauActor);
+			const TArray<FTableauRecipeNode>& Recipe = Entry.LatentTree->GetRecipe();
+			Manager.SpawnInstances(Recipe, 0, Recipe.Num(), false);
+			Manager.SpawnFoliage(Entry.LatentTree->GetFoliages());
+			Manager.FinalizeRegeneration();
+		}
+
+		Entry.TableauActor->GetTableauComponent()->RecordRegeneration(Entry.bTransactInstances);
+	}
+
+	Batch.Empty();
+	Contexts.Empty();
+
+	GEngine->ForceGarbageCollection(true);
+}
+
+TUniquePtr<FTableauLatentTree> FTableauActorManager::EvaluateLatentTree(TSharedPtr<FTableauFilterSampler> Filter) const
+{
+	TUniquePtr<FTableauLatentTree> TableauLatentTree = CreateLatentTree(Filter);
+	TableauLatentTree->EvaluateLatentTree(TableauActor->GetTableauComponent()->Seed);
+
+	return TableauLatentTree;
+}
+
+TUniquePtr<FTableauLatentTree> FTableauActorManager::CreateLatentTree(TSharedPtr<FTableauFilterSampler> Filter, TSharedPtr<const FTableauEvaluationContext> Context) const
+{
+	const UTableauComponent* TableauComponent = TableauActor->GetTableauComponent();
+
+	return TUniquePtr<FTableauLatentTree>(new FTableauLatentTree(TableauComponent->GetTableau(), Filter, !bAssetEditorWorkflow, Context));
+}
+
+void FTableauActorManager::PrepareForRegeneration()
+{
+	UTableauComponent* TableauComponent = TableauActor->GetTableauComponent();
+	TableauComponent->RestoreInstances();
+
+	// Remove child spawns
+	DeleteInstances();
+}
+
+void FTableauActorManager::FinalizeRegeneration()
+{
+	UTableauComponent* TableauComponent = TableauActor->GetTableauComponent();
+
+	if (TableauComponent->bAutoSnap)
+	{
+		SnapToFloor();
 	}
+	
+	MoveSelectionToTableauParent();
 
+	TableauComponent->InvalidateBounds();
+
+	// Need to allow a moment for the Outliner to refresh...
+	FTimerDelegate Delegate = FTimerDelegate::CreateLambda([]()
+		{
+			for (FSelectionIterator Iter(*GEditor->GetSelectedActors()); Iter; ++Iter)
+			{
+				if (ATableauActor* Actor = Cast<ATableauActor>(*Iter))
+				{
+					FTableauActorManager Manager(Actor);
+					Manager.CollapseActorInOutliner();
+				}
+			}
+		});
+
+	static FTimerHandle DelayTimer;
+	if (DelayTimer.IsValid())
+	{
+		GEditor->GetTimerManager()->ClearTimer(DelayTimer);
+	}
+	GEditor->GetTimerManager()->SetTimer(DelayTimer, Delegate, 0.1f, false);
 }
 
 void FTableauActorManager::SpawnInstances(TArray<FTableauRecipeNode>& Recipe, bool bIsPreview)
+{
+	SpawnInstances(Recipe, 0, Recipe.Num(), bIsPreview);
+
+	GEngine->ForceGarbageCollection(true);
+}
+
+void FTableauActorManager::SpawnInstances(const TArray<FTableauRecipeNode>& Recipe, int32 FirstNode, int32 NodeCount, bool bIsPreview)
 {
 
 	// Stash current level
@@ -121,7 +366,12 @@ void FTableauActorManager::SpawnInstances(TArray<FTableauRecipeNode>& Recipe, bo
 	// We will be transforming the spawned actors into the Tableau's local space.
 	const FTransform TableauSpace = TableauActor->GetActorTransform();
 
-	TArray<TWeakObjectPtr<AActor>> SpawnedActors = FTableauUtils::SpawnInstances(TableauActor, TableauSpace, Recipe, TableauActor->GetTableauComponent(), nullptr, bIsPreview);
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+	const int32 LastNode = FMath::Min(FirstNode + NodeCount, Recipe.Num());
+	for (int32 NodeIndex = FirstNode; NodeIndex < LastNode; ++NodeIndex)
+	{
+		SpawnedActors.Append(FTableauUtils::SpawnInstance(TableauActor, TableauSpace, Recipe[NodeIndex], TableauActor->GetTableauComponent(), INDEX_NONE, bIsPreview));
+	}
 
 	// Parent spawned actors to Tableau
 	for (auto It = SpawnedActors.CreateConstIterator(); It; ++It)
@@ -133,11 +383,9 @@ void FTableauActorManager::SpawnInstances(TArray<FTableauRecipeNode>& Recipe, bo
 	// We're done so revert the level
 	TargetWorld->SetCurrentLevel(OldCurrentLevel);
 
-	GEngine->ForceGarbageCollection(true);
-
 }
 
-AActor* FTableauActorManager::SpawnElement(ULevel* Level, const FTableauAssetElement& Element, int32 Seed, const FTransform& Space)
+AActor* FTableauActorManager::SpawnElement(ULevel* Level, const UTableauAsset* TableauAsset, const FTableauAssetElement& Element, int32 Seed, const FTransform& Space)
 {
 	AActor* ReturnElement = nullptr;
 
@@ -154,8 +402,7 @@ AActor* FTableauActorManager::SpawnElement(ULevel* Level, const FTableauAssetEle
 	}
 	else if (Element.bUseConfig & !bAssetEditorWorkflow)
 	{
-		FString Config = Element.AssetConfig;
-		ReturnElement = FTableauUtils::PasteActor(TargetWorld, Config, SpawnXform, Element.Name);
+		ReturnElement = FTableauUtils::SpawnConfiguredActor(TargetWorld, TableauAsset, Element.ConfigIndex, SpawnXform, Element.Name);
 	}
 	else
 	{
@@ -168,6 +415,22 @@ AActor* FTableauActorManager::SpawnElement(ULevel* Level, const FTableauAssetEle
 
 void FTableauActorManager::SpawnFoliage(TMap<UFoliageType*, TUniquePtr<FTableauFoliage>>& Foliages)
 {
+	// Shared foliage is aggregated across Tableaux by the World's foliage subsystem.
+	// Preview Tableaux always draw their own foliage.
+	if (TableauActor->GetTableauComponent()->bShareFoliage && !bAssetEditorWorkflow)
+	{
+		TableauActor->Modify();
+		for (const auto& Foliage : Foliages)
+		{
+			if (Foliage.Value.IsValid())
+			{
+				Foliage.Value->AddToSharedFoliage(TableauActor);
+			}
+		}
+		TableauActor->UpdateSharedFoliage();
+		return;
+	}
+
 	// Call upon each Foliage type to configure, fill, and attach a HISM component for that type.
 	for (const auto& Foliage : Foliages)
 	{
@@ -182,16 +445,15 @@ void FTableauActorManager::DeleteInstances()
 {
 	// Get all of the actor's instances and delete them.
 	UTableauComponent* Component = TableauActor->GetTableauComponent();
-	TArray<FTableauInstanceTracker> Instances = Component->GetInstances();
+	ULayersSubsystem* LayersSubsystem = GEditor->GetEditorSubsystem<ULayersSubsystem>();
 
-	for (FTableauInstanceTracker& Instance : Instances)
+	for (const FTableauInstanceTracker& Instance : Component->GetInstances())
 	{
-		Instance.Apply([](AActor* InActor)
-			{
-				GEditor->GetEditorSubsystem<ULayersSubsystem>()->DisassociateActorFromLayers(InActor);
-				InActor->GetLevel()->OwningWorld->DestroyActor(InActor, true);
-			});
-
+		if (AActor* InActor = Instance.TableauInstance.Get())
+		{
+			LayersSubsystem->DisassociateActorFromLayers(InActor);
+			InActor->GetLevel()->OwningWorld->DestroyActor(InActor, true);
+		}
 	}
 
 	Component->ClearInstances();
@@ -216,6 +478,7 @@ void FTableauActorManager::DeleteInstances()
 	}
 	TableauActor->ChildActorComponents.Empty();
 
+	Component->InvalidateBounds();
 }
 
 void FTableauActorManager::Reseed()
@@ -281,15 +544,12 @@ void FTableauActorManager::MoveSelectionToTableauParent()
 {
 	// Deselect children
 	UTableauComponent* Component = TableauActor->GetTableauComponent();
-	TArray<FTableauInstanceTracker> Instances = Component->GetInstances();
-	for (FTableauInstanceTracker& Instance : Instances)
+	for (const FTableauInstanceTracker& Instance : Component->GetInstances())
 	{
-
-		Instance.Apply([](AActor* InActor)
-			{
-				GEditor->SelectActor(InActor, false, false, true);
-			});
-
+		if (AActor* InActor = Instance.TableauInstance.Get())
+		{
+			GEditor->SelectActor(InActor, false, false, true);
+		}
 	}
 
 	// Select parent
@@ -317,24 +577,22 @@ void FTableauActorManager::Unpack()
 
 	UTableauComponent* Component = TableauActor->GetTableauComponent();
 	Component->Modify(true);
-	TArray<FTableauInstanceTracker> Instances = Component->GetInstances();
 
 	// Extract instance actors from Tableau and select them in order.
 	GEditor->SelectNone(true, true, false);
-	for (FTableauInstanceTracker& Instance : Instances)
+	for (const FTableauInstanceTracker& Instance : Component->GetInstances())
 	{
-		Instance.Apply([](AActor* InActor)
-			{
-				InActor->Modify(true);
-				FDetachmentTransformRules DetachmentRule(EDetachmentRule::KeepWorld, true);
-				InActor->DetachFromActor(DetachmentRule);
-
-				// Remove tag indicating Tableau element status.
-				InActor->Tags.Remove(TableauActorConstants::TABLEAU_ELEMENT_TAG);
+		if (AActor* InActor = Instance.TableauInstance.Get())
+		{
+			InActor->Modify(true);
+			FDetachmentTransformRules DetachmentRule(EDetachmentRule::KeepWorld, true);
+			InActor->DetachFromActor(DetachmentRule);
 
-				GEditor->SelectActor(InActor, true, true, true, false);
-			});
+			// Remove tag indicating Tableau element status.
+			InActor->Tags.Remove(TableauActorConstants::TABLEAU_ELEMENT_TAG);
 
+			GEditor->SelectActor(InActor, true, true, true, false);
+		}
 	}
 
 	// Unpack HISMs by converting to Foliage Actor
@@ -418,7 +676,7 @@ void FTableauActorManager::UnpackTopLayer()
 			{
 				if (Filter->Sample(Element->LocalTransform.GetLocation()))
 				{
-					NewSelection.Add(SpawnElement(ActorLevel, *Element, FTableauUtils::NextSeed(Seed), TableauSpace));
+					NewSelection.Add(SpawnElement(ActorLevel, TableauAsset, *Element, FTableauUtils::NextSeed(Seed), TableauSpace));
 				}
 			}
 		}
@@ -431,11 +689,11 @@ void FTableauActorManager::UnpackTopLayer()
 				{
 					if (Element.bDeterministic)
 					{
-						NewSelection.Add(SpawnElement(ActorLevel, Element, Element.Seed, TableauSpace));
+						NewSelection.Add(SpawnElement(ActorLevel, TableauAsset, Element, Element.Seed, TableauSpace));
 					}
 					else
 					{
-						NewSelection.Add(SpawnElement(ActorLevel, Element, Seed, TableauSpace));
+						NewSelection.Add(SpawnElement(ActorLevel, TableauAsset, Element, Seed, TableauSpace));
 					}
 				}
 			}
@@ -498,11 +756,11 @@ void FTableauActorManager::UnpackForEditing()
 			Seed = FTableauUtils::NextSeed(Seed);
 			if (Element.bDeterministic)
 			{
-				NewSelection.Add(SpawnElement(ActorLevel, Element, Element.Seed, TableauSpace));
+				NewSelection.Add(SpawnElement(ActorLevel, TableauAsset, Element, Element.Seed, TableauSpace));
 			}
 			else
 			{
-				NewSelection.Add(SpawnElement(ActorLevel, Element, Seed, TableauSpace));
+				NewSelection.Add(SpawnElement(ActorLevel, TableauAsset, Element, Seed, TableauSpace));
 			}
 		}	
 	}
@@ -528,11 +786,17 @@ void FTableauActorManager::SnapToFloor()
 	const FScopedTransaction Transaction(FText::FromString(TEXT("Snap Tableau")));
 
 	UTableauComponent* Component = TableauActor->GetTableauComponent();
-	SnapToFloor(Component->GetInstances(), FVector(0.f, 0.f, 0.f));
+	SnapToFloor(Component->GetInstances());
 
-	// We also snap any attached Foliage HISMs
 	FTableauFoliageManager FoliageManager(TableauActor);
-	FoliageManager.SnapToFloor(TargetWorld);
+	const FBox Region = TableauActor->GetComponentsBoundingBox(true) + FoliageManager.GetSharedFoliageBounds();
+	FoliageManager.WithdrawSharedFoliage();
+
+	// Components are snapped in bulk, sampling landscape heightfields directly where possible.
+	const FTableauFloorSampler FloorSampler(TargetWorld, Region, TableauActor);
+
+	// We also snap any attached Foliage HISMs
+	FoliageManager.SnapToFloor(FloorSampler);
 
 	// Snap all StaticMesh Components
 	for (UStaticMeshComponent* StaticMesh : TableauActor->StaticMeshComponents)
@@ -541,7 +805,7 @@ void FTableauActorManager::SnapToFloor()
 		if (!StaticMesh->IsA<UTableauHISMComponent>())
 		{
 			FTransform WorldTransform(StaticMesh->GetComponentLocation());
-			FTableauUtils::TraceToWorld(WorldTransform, TargetWorld, DefaultViableGroundSlopeAngleInterval, TableauActor, false);
+			FloorSampler.SnapToFloor(WorldTransform, DefaultViableGroundSlopeAngleInterval, false);
 			StaticMesh->SetWorldLocation(WorldTransform.GetLocation());
 		}
 	}
@@ -550,12 +814,14 @@ void FTableauActorManager::SnapToFloor()
 	for (UChildActorComponent* ChildActor : TableauActor->ChildActorComponents)
 	{
 		FTransform WorldTransform(ChildActor->GetComponentLocation());
-		FTableauUtils::TraceToWorld(WorldTransform, TargetWorld, DefaultViableGroundSlopeAngleInterval, TableauActor, false);
+		FloorSampler.SnapToFloor(WorldTransform, DefaultViableGroundSlopeAngleInterval, false);
 		ChildActor->SetWorldLocation(WorldTransform.GetLocation());
 	}
+
+	Component->InvalidateBounds();
 }
 
-void FTableauActorManager::SnapToFloor(const TArray<FTableauInstanceTracker>& Instances, const FVector& ParentTranslate)
+void FTableauActorManager::SnapToFloor(const TArray<FTableauInstanceTracker>& Instances)
 {
 
 	// Get all of the actor instances and snap them to the floor.
@@ -563,35 +829,88 @@ void FTableauActorManager::SnapToFloor(const TArray<FTableauInstanceTracker>& In
 	// If the actor has a snap tag, always snap it.
 	// Otherwise, translate the actor with it's parent.
 
-	for (const FTableauInstanceTracker& Instance : Instances)
+	// How far each Instance moved. Parents precede their subordinates, so a parent's offset is
+	// always known by the time its subordinates are visited.
+	TArray<FVector> Offsets;
+	Offsets.Init(FVector::ZeroVector, Instances.Num());
+
+	for (int32 Index = 0; Index < Instances.Num(); ++Index)
 	{
-		if (Instance.TableauInstance.IsValid())
+		const FTableauInstanceTracker& Instance = Instances[Index];
+		if (AActor* InActor = Instance.TableauInstance.Get())
 		{
-			Instance.TableauInstance->Modify(true);
+			InActor->Modify(true);
 
-			const FVector InitialLocation = Instance.TableauInstance->GetActorLocation();
+			const FVector InitialLocation = InActor->GetActorLocation();
 
-			if (Instance.TableauInstance->ActorHasTag(TableauActorConstants::TABLEAU_SNAPTOFLOOR_TAG))
+			if (InActor->ActorHasTag(TableauActorConstants::TABLEAU_SNAPTOFLOOR_TAG))
 			{
-				GEditor->SnapObjectTo(Instance.TableauInstance.Get(), false, true, true, false);
+				GEditor->SnapObjectTo(InActor, false, true, true, false);
 			}
-			else
+			else if (Instance.Parent != INDEX_NONE)
 			{
-				Instance.TableauInstance->AddActorLocalOffset(ParentTranslate, false);
+				InActor->AddActorLocalOffset(Offsets[Instance.Parent], false);
 			}
 
-			if (Instance.SubInstances.Num() > 0)
-			{
-				// Find how much the owning actor has moved and translate unsnapped 
-				// children by that offset.
-				const FVector Offset = Instance.TableauInstance->GetActorLocation() - InitialLocation;
+			Offsets[Index] = InActor->GetActorLocation() - InitialLocation;
+		}
+	}
+
+}
+
+bool FTableauActorManager::BakeRecipe(UTableauBakedRecipe* BakedRecipe) const
+{
+	check(BakedRecipe);
+
+	TArray<FTableauBakeInstance> Instances;
+	const FTransform TableauSpace = TableauActor->GetActorTransform();
 
-				SnapToFloor(Instance.SubInstances, Offset);
+	// Static Mesh Components spawned directly from the Recipe.
+	for (const UStaticMeshComponent* StaticMeshComponent : TableauActor->StaticMeshComponents)
+	{
+		if (StaticMeshComponent && StaticMeshComponent->GetStaticMesh())
+		{
+			FTableauBakeInstance& BakeInstance = Instances.AddDefaulted_GetRef();
+			BakeInstance.Source = StaticMeshComponent->GetStaticMesh();
+			BakeInstance.Transform = StaticMeshComponent->GetComponentTransform().GetRelativeTransform(TableauSpace);
+		}
+	}
+
+	// Foliage held by the Actor's own HISMs.
+	for (const UTableauHISMComponent* Foliage : TableauActor->FoliageComponents)
+	{
+		FSoftObjectPtr SoftObjectPtr(Foliage->FoliageType);
+		if (UFoliageType* FoliageType = Cast<UFoliageType>(SoftObjectPtr.LoadSynchronous()))
+		{
+			for (int32 i = 0; i < Foliage->GetInstanceCount(); ++i)
+			{
+				FTableauBakeInstance& BakeInstance = Instances.AddDefaulted_GetRef();
+				BakeInstance.Source = FoliageType;
+				Foliage->GetInstanceTransform(i, BakeInstance.Transform, true);
+				BakeInstance.Transform = BakeInstance.Transform.GetRelativeTransform(TableauSpace);
 			}
+		}
+	}
 
+	// And by the shared HISMs.
+	for (const FTableauSharedFoliage& SharedFoliage : TableauActor->SharedFoliage)
+	{
+		FSoftObjectPtr SoftObjectPtr(SharedFoliage.FoliageType);
+		if (UFoliageType* FoliageType = Cast<UFoliageType>(SoftObjectPtr.LoadSynchronous()))
+		{
+			for (const FTransform& Instance : SharedFoliage.Instances)
+			{
+				FTableauBakeInstance& BakeInstance = Instances.AddDefaulted_GetRef();
+				BakeInstance.Source = FoliageType;
+				BakeInstance.Transform = Instance;
+			}
 		}
 	}
 
+	GatherInstanceMeshes(TableauActor->GetTableauComponent()->GetInstances(), TableauSpace, Instances);
+
+	BakedRecipe->Modify();
+	return BakedRecipe->Bake(Instances);
 }
 
 void FTableauActorManager::FilterBySelectedActors()
@@ -640,53 +959,9 @@ void FTableauActorManager::ValidateTracking()
 	FTableauFoliageManager FoliageManager(TableauActor);
 }
 
-TSharedPtr<FTableauFilterSampler> FTableauActorManager::GatherFilters(const UTableauComponent* TableauComponent) const
+TSharedPtr<FTableauFilterSampler> FTableauActorManager::GatherFilters(const UTableauComponent* TableauComponent, FTableauEvaluationContext* Context) const
 {
-	TSharedPtr<FTableauFilterSampler> Filter(new FTableauFilterSampler(TableauActor->ActorToWorld()));
-
-	// Actors in the component's FilterActors list create cylinder filter volumes
-	// corresponding to the bounds of the actor.
-	// All locations are in the TableauComponent local space
-	for (const FFilterActor& FilterActor : TableauComponent->FilterActors)
-	{
-		if (FilterActor.Actor.IsValid())
-		{
-			// If the actor contains a spline component, it is handled differently.
-			if (USplineComponent* SplineComponent = Cast<USplineComponent>(FilterActor.Actor->GetRootComponent()))
-			{
-				TWeakObjectPtr<USplineComponent> SplineComponentPtr(SplineComponent);
-				Filter->AddSplineFilter(SplineComponentPtr, FilterActor.ExpandVolume);
-			}
-			else
-			{
-				// This is treated as a general actor.
-				float Radius, Height;
-				FilterActor.Actor->GetComponentsBoundingCylinder(Radius, Height, false);
-
-				Filter->AddCylinderVolumeFilter(FilterActor.Actor->GetActorLocation(), Radius + FilterActor.ExpandVolume);
-			}
-		}
-	}
-
-	// Add a filter for each specified landscape layer
-	for (const FFilterWeightmap& FilterWeightmap : TableauComponent->FilterWeightmaps)
-	{
-		Filter->AddLandscapeLayerFilter(FilterWeightmap.LayerName, FilterWeightmap.WeightThreshold);
-	}
-
-	// Add a filter for each specified tag.
-	for (const FFilterTag& FilterTag : TableauComponent->FilterTags)
-	{
-		Filter->AddTagFilter(FilterTag.Tag, FilterTag.Tolerance);
-	}
-
-	if (!TableauComponent->bIgnoreExclusion)
-	{
-		// Add any TableauExclusionVolumes in the currently loaded World.
-		Filter->AddAllLoadedExclusionVolumes(TargetWorld);
-	}
-
-	return Filter;
+	return FTableauFilterSampler::GatherFilters(TableauComponent, TargetWorld, Context);
 }
 
 
@@ -13,8 +13,9 @@ void FTableauComponentVisualizer::DrawVisualization(const UActorComponent* Compo
 		return;
 	}
 
-	FLinearColor DrawColor = TableauComponent->GetColor();
-	FBox BoundingBox = TableauComponent->GetBoundingBox();
+	// Both are cached by the Component, so drawing neither loads nor walks the Instances.
+	const FLinearColor DrawColor = TableauComponent->GetColor();
+	const FBox BoundingBox = TableauComponent->GetBoundingBox();
 
 	// Draw a colored box around the contained objects, color coded to the mode.
 	DrawWireBox(PDI, BoundingBox, DrawColor, SDPG_Foreground, 2.5);
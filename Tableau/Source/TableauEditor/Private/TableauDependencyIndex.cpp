@@ -0,0 +1,213 @@
+#include "TableauDependencyIndex.h"
+
+// Engine Includes
+#include "AssetRegistryModule.h"
+#include "Editor.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+
+// Local Includes
+#include "TableauActor.h"
+#include "TableauAsset.h"
+#include "TableauComponent.h"
+
+
+//////////////////////////////////////////////////
+// FTableauDependencyIndex
+
+FTableauDependencyIndex::FTableauDependencyIndex()
+	: bDirty(true)
+{
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().AddRaw(this, &FTableauDependencyIndex::OnLevelActorAdded);
+		GEngine->OnLevelActorDeleted().AddRaw(this, &FTableauDependencyIndex::OnLevelActorDeleted);
+	}
+	FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FTableauDependencyIndex::OnLevelAddedToWorld);
+	FEditorDelegates::MapChange.AddRaw(this, &FTableauDependencyIndex::OnMapChange);
+	FEditorDelegates::PostUndoRedo.AddRaw(this, &FTableauDependencyIndex::OnPostUndoRedo);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FTableauDependencyIndex::OnObjectPropertyChanged);
+}
+
+FTableauDependencyIndex::~FTableauDependencyIndex()
+{
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().RemoveAll(this);
+		GEngine->OnLevelActorDeleted().RemoveAll(this);
+	}
+	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
+	FEditorDelegates::MapChange.RemoveAll(this);
+	FEditorDelegates::PostUndoRedo.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+}
+
+void FTableauDependencyIndex::FindDependentComponents(const UTableauAsset* TableauAsset, TArray<UTableauComponent*>& OutComponents)
+{
+	if (TableauAsset == nullptr)
+	{
+		return;
+	}
+
+	if (bDirty)
+	{
+		Rebuild();
+	}
+
+	if (const TArray<TWeakObjectPtr<UTableauComponent>>* Components = Dependents.Find(FSoftObjectPath(TableauAsset)))
+	{
+		for (const TWeakObjectPtr<UTableauComponent>& Component : *Components)
+		{
+			if (Component.IsValid())
+			{
+				OutComponents.AddUnique(Component.Get());
+			}
+		}
+	}
+}
+
+void FTableauDependencyIndex::Invalidate()
+{
+	bDirty = true;
+}
+
+void FTableauDependencyIndex::Rebuild()
+{
+	Dependents.Empty();
+
+	// Shared Tableaux are only walked once, however many Components place them.
+	TMap<FSoftObjectPath, TArray<FSoftObjectPath>> NestedTableaux;
+
+	for (TObjectIterator<UTableauComponent> It; It; ++It)
+	{
+		UTableauComponent* Component = *It;
+		if (Component->IsTemplate() || Component->IsPendingKill() || Component->GetTableau() == nullptr)
+		{
+			continue;
+		}
+
+		// Only placed Tableau Actors are regenerated in the editor.
+		UWorld* World = Component->GetWorld();
+		if (World == nullptr || World->WorldType != EWorldType::Editor || Cast<ATableauActor>(Component->GetOwner()) == nullptr)
+		{
+			continue;
+		}
+
+		for (const FSoftObjectPath& TableauPath : GatherNestedTableaux(Component->GetTableau(), NestedTableaux))
+		{
+			Dependents.FindOrAdd(TableauPath).Add(Component);
+		}
+	}
+
+	bDirty = false;
+}
+
+const TArray<FSoftObjectPath>& FTableauDependencyIndex::GatherNestedTableaux(const UTableauAsset* TableauAsset, TMap<FSoftObjectPath, TArray<FSoftObjectPath>>& NestedTableaux) const
+{
+	const FSoftObjectPath RootPath(TableauAsset);
+	if (const TArray<FSoftObjectPath>* Gathered = NestedTableaux.Find(RootPath))
+	{
+		return *Gathered;
+	}
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FSoftObjectPath> Gathered;
+	Gathered.Add(RootPath);
+
+	// Gathered doubles as the stack, so that self referencing Tableaux terminate.
+	for (int32 Index = 0; Index < Gathered.Num(); ++Index)
+	{
+		const UTableauAsset* Current = (Index == 0) ? TableauAsset : Cast<UTableauAsset>(Gathered[Index].ResolveObject());
+		if (Current == nullptr)
+		{
+			continue;
+		}
+
+		for (const FTableauAssetElement& Element : Current->TableauElement)
+		{
+			if (!Element.AssetReference.IsValid() || Gathered.Contains(Element.AssetReference))
+			{
+				continue;
+			}
+
+			// Only Tableaux are loaded. An element that's already loaded is checked directly, otherwise its
+			// class is looked up in the asset registry.
+			bool bIsTableau = false;
+			if (const UObject* Loaded = Element.AssetReference.ResolveObject())
+			{
+				bIsTableau = Loaded->IsA<UTableauAsset>();
+			}
+			else
+			{
+				const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(Element.AssetReference.GetAssetPathName());
+				const UClass* AssetClass = AssetData.IsValid() ? AssetData.GetClass() : nullptr;
+				bIsTableau = AssetClass && AssetClass->IsChildOf(UTableauAsset::StaticClass()) && Element.AssetReference.TryLoad() != nullptr;
+			}
+
+			if (bIsTableau)
+			{
+				Gathered.Add(Element.AssetReference);
+			}
+		}
+	}
+
+	return NestedTableaux.Add(RootPath, MoveTemp(Gathered));
+}
+
+void FTableauDependencyIndex::OnLevelActorAdded(AActor* Actor)
+{
+	// Only Tableau Actors are indexed.
+	if (Cast<ATableauActor>(Actor))
+	{
+		Invalidate();
+	}
+}
+
+void FTableauDependencyIndex::OnLevelActorDeleted(AActor* Actor)
+{
+	const ATableauActor* TableauActor = Cast<ATableauActor>(Actor);
+	if (TableauActor == nullptr || bDirty)
+	{
+		return;
+	}
+
+	// Removing the Component can't change what any other Component depends on.
+	const UTableauComponent* Component = TableauActor->GetTableauComponent();
+	for (auto It = Dependents.CreateIterator(); It; ++It)
+	{
+		It.Value().RemoveAll([Component](const TWeakObjectPtr<UTableauComponent>& Dependent)
+			{
+				return !Dependent.IsValid() || Dependent.Get() == Component;
+			});
+
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FTableauDependencyIndex::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	Invalidate();
+}
+
+void FTableauDependencyIndex::OnMapChange(uint32 MapChangeFlags)
+{
+	Invalidate();
+}
+
+void FTableauDependencyIndex::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Either a Component's Tableau or a Tableau's nested Tableaux may have changed.
+	if (Cast<UTableauComponent>(Object) || Cast<ATableauActor>(Object) || Cast<UTableauAsset>(Object))
+	{
+		Invalidate();
+	}
+}
+
+void FTableauDependencyIndex::OnPostUndoRedo()
+{
+	Invalidate();
+}
@@ -84,6 +84,8 @@ TSharedRef<SDockTab> FTableauEditor::SpawnPropertiesTab(const FSpawnTabArgs& Arg
 
 FTableauEditor::~FTableauEditor()
 {
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+
 	// On destruction we reset our tab and details view 
 	Viewport.Reset();
 	DetailsView.Reset();
@@ -138,6 +140,9 @@ void FTableauEditor::InitEditorForTableau(UTableauAsset* ObjectToEdit)
 
 	DetailsView = PropertyEditorModule.CreateDetailView(DetailsViewArgs);
 
+	// Refresh the preview when the Tableau is edited.
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddSP(this, &FTableauEditor::OnObjectPropertyChanged);
+
 	SetEditorTableau(ObjectToEdit);
 }
 
@@ -184,4 +189,14 @@ void FTableauEditor::SetEditorTableau(UTableauAsset* InTableau, bool bResetCamer
 	Viewport->RefreshViewport();
 }
 
+void FTableauEditor::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Nested Tableaux contribute their elements and weights to the preview too.
+	const UTableauAsset* EditedTableau = Cast<UTableauAsset>(Object);
+	if (EditedTableau != nullptr && Viewport.IsValid() && Viewport->IsPreviewingTableau(EditedTableau))
+	{
+		Viewport->UpdatePreviewTableau(Tableau, false);
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
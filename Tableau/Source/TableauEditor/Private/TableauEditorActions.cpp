@@ -1,7 +1,13 @@
 #include "TableauEditorActions.h"
 
+// Engine Includes
+#include "AssetRegistryModule.h"
+#include "AssetToolsModule.h"
+
 // Local Includes
 #include "TableauActorManager.h"
+#include "TableauRegenerationTask.h"
+#include "TableauBakedRecipe.h"
 
 #define LOCTEXT_NAMESPACE "TableauEditorActions"
 
@@ -25,11 +31,24 @@ void FTableauEditorActions::SnapTableauActorsToFloor()
 
 void FTableauEditorActions::RegenerateSelectedTableauActors()
 {
-	ApplyToAllSelectedTableau([](ATableauActor* InActor)
-		{
-			FTableauActorManager Manager(InActor);
-			Manager.UpdateInstances(false);
-		});
+	TArray<ATableauActor*> SelectedActors;
+	GEditor->GetSelectedActors()->GetSelectedObjects<ATableauActor>(SelectedActors);
+
+	if (SelectedActors.Num() > 0)
+	{
+		FTableauActorManager::UpdateInstances(SelectedActors);
+	}
+}
+
+void FTableauEditorActions::RegenerateSelectedTableauActorsTimeSliced()
+{
+	TArray<ATableauActor*> SelectedActors;
+	GEditor->GetSelectedActors()->GetSelectedObjects<ATableauActor>(SelectedActors);
+
+	if (SelectedActors.Num() > 0)
+	{
+		FTableauRegenerationTask::Launch(SelectedActors);
+	}
 }
 
 void FTableauEditorActions::UnpackSelectedTableauActors()
@@ -68,5 +87,44 @@ void FTableauEditorActions::FilterBySelectedActors()
 		});
 }
 
+void FTableauEditorActions::BakeSelectedTableauActors()
+{
+	TArray<ATableauActor*> SelectedActors;
+	GEditor->GetSelectedActors()->GetSelectedObjects<ATableauActor>(SelectedActors);
+
+	const FAssetToolsModule& AssetToolsModule = FModuleManager::Get().LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
+
+	for (ATableauActor* TableauActor : SelectedActors)
+	{
+		const UTableauAsset* TableauAsset = TableauActor->GetTableauComponent()->GetTableau();
+		if (TableauAsset == nullptr)
+		{
+			continue;
+		}
+
+		FString Name, PackageName;
+		AssetToolsModule.Get().CreateUniqueAssetName(TableauAsset->GetOutermost()->GetName(), TEXT("_Baked"), /*out*/ PackageName, /*out*/ Name);
+
+		UPackage* Package = CreatePackage(nullptr, *PackageName);
+		UTableauBakedRecipe* BakedRecipe = NewObject<UTableauBakedRecipe>(Package, *Name, RF_Public | RF_Standalone | RF_Transactional);
+		if (BakedRecipe == nullptr)
+		{
+			UE_LOG(LogTableau, Error, TEXT("Unable to create Baked Recipe asset %s"), *PackageName);
+			continue;
+		}
+
+		FTableauActorManager Manager(TableauActor);
+		if (!Manager.BakeRecipe(BakedRecipe))
+		{
+			BakedRecipe->ClearFlags(RF_Public | RF_Standalone);
+			BakedRecipe->MarkPendingKill();
+			continue;
+		}
+
+		FAssetRegistryModule::AssetCreated(BakedRecipe);
+		UE_LOG(LogTableau, Log, TEXT("Baked %d instances of %s into %s"), BakedRecipe->GetInstanceCount(), *TableauActor->GetActorLabel(), *PackageName);
+	}
+}
+
 
 #undef LOCTEXT_NAMESPACE
@@ -24,10 +24,12 @@ void FTableauEditorCommands::RegisterCommands()
 	UI_COMMAND(ReseedSelectedTableauActors, "ReseedSelectedTableauActors", "Reseed Selected Tableau Actors", EUserInterfaceActionType::Button, FInputChord(EModifierKey::Shift | EModifierKey::Control,EKeys::R));
 	UI_COMMAND(SnapTableauActorsToFloor, "SnapTableauActorsToFloor", "Snap Tableau Actors To Floor", EUserInterfaceActionType::Button, FInputChord(EModifierKey::Control | EModifierKey::Shift, EKeys::End));
 	UI_COMMAND(RegenerateSelectedTableauActors, "RegenerateSelectedTableauActors", "Regenerate Selected Tableau Actors", EUserInterfaceActionType::Button, FInputChord());
+	UI_COMMAND(RegenerateSelectedTableauActorsTimeSliced, "RegenerateSelectedTableauActorsTimeSliced", "Regenerate Selected Tableau Actors (Time Sliced)", EUserInterfaceActionType::Button, FInputChord());
 	UI_COMMAND(UnpackSelectedTableauActors, "UnpackSelectedTableauActors", "Unpack Selected Tableau Actors", EUserInterfaceActionType::Button, FInputChord());
 	UI_COMMAND(UnpackOneLayer, "UnpackOneLayer", "Unpack One Layer", EUserInterfaceActionType::Button, FInputChord());
 	UI_COMMAND(UnpackForEditing, "UnpackForEditing", "Unpack For Editing", EUserInterfaceActionType::Button, FInputChord());
 	UI_COMMAND(FilterBySelectedActors, "FilterBySelectedActors", "Filter By Selected Actors", EUserInterfaceActionType::Button, FInputChord());
+	UI_COMMAND(BakeSelectedTableauActors, "BakeSelectedTableauActors", "Bake Selected Tableau Actors", EUserInterfaceActionType::Button, FInputChord());
 
 }
 
@@ -9,6 +9,8 @@
 #include "Editor/UnrealEdEngine.h"
 #include "UnrealEdGlobals.h"
 #include "Engine/Selection.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
 
 // Local Includes
 #include "TableauActorFactory.h"
@@ -22,6 +24,9 @@
 #include "TableauComponentVisualizer.h"
 #include "TableauAssetTypeActions.h"
 #include "TableauEditor.h"
+#include "TableauRegenerationTask.h"
+#include "TableauDependencyIndex.h"
+#include "TableauSourceWatcher.h"
 
 
 const FName TableauEditorAppIdentifier = FName(TEXT("TableauEditorApp"));
@@ -125,6 +130,15 @@ struct FTableauMenuExtend
 			LOCTEXT("RegenerateSelectedTableauActors", "Regenerate Selected Tableau Actors"),
 			LOCTEXT("RegenerateSelectedTableauActorsTooltip", "Regenerate the hierarchy to pick up any changes."));
 
+		// --------------------
+		// Regenerate selected Tableau Actors over several frames
+		// --------------------
+		InputMenuBuilder.AddMenuEntry(
+			FTableauEditorCommands::Get().RegenerateSelectedTableauActorsTimeSliced,
+			NAME_None,
+			LOCTEXT("RegenerateSelectedTableauActorsTimeSliced", "Regenerate Selected Tableau Actors (Time Sliced)"),
+			LOCTEXT("RegenerateSelectedTableauActorsTimeSlicedTooltip", "Regenerate the hierarchy over several frames. Progress is reported and the regeneration may be cancelled."));
+
 		// --------------------
 		// Unpack selected Tableau Actors
 		// --------------------
@@ -161,6 +175,15 @@ struct FTableauMenuExtend
 			LOCTEXT("FilterBySelectedActors", "Filter By Selected Actors"),
 			LOCTEXT("FilterBySelectedActorsTooltip", "Use selected non-Tableau actors as filters."));
 
+		// --------------------
+		// Bake selected Tableau Actors
+		// --------------------
+		InputMenuBuilder.AddMenuEntry(
+			FTableauEditorCommands::Get().BakeSelectedTableauActors,
+			NAME_None,
+			LOCTEXT("BakeSelectedTableauActors", "Bake Selected Tableau Actors"),
+			LOCTEXT("BakeSelectedTableauActorsTooltip", "Store the current output of the Tableau in a Baked Recipe asset, for expression at runtime without evaluation."));
+
 		InputMenuBuilder.EndSection();
 	}
 };
@@ -236,10 +259,12 @@ void FTableauEditorModule::RegisterCommands()
 	TableauCommands->MapAction(Commands.ReseedSelectedTableauActors, FExecuteAction::CreateStatic(&FTableauEditorActions::ReseedSelectedTableauActors));
 	TableauCommands->MapAction(Commands.SnapTableauActorsToFloor, FExecuteAction::CreateStatic(&FTableauEditorActions::SnapTableauActorsToFloor));
 	TableauCommands->MapAction(Commands.RegenerateSelectedTableauActors, FExecuteAction::CreateStatic(&FTableauEditorActions::RegenerateSelectedTableauActors));
+	TableauCommands->MapAction(Commands.RegenerateSelectedTableauActorsTimeSliced, FExecuteAction::CreateStatic(&FTableauEditorActions::RegenerateSelectedTableauActorsTimeSliced), FCanExecuteAction::CreateLambda([]() { return !FTableauRegenerationTask::IsTaskRunning(); }));
 	TableauCommands->MapAction(Commands.UnpackSelectedTableauActors, FExecuteAction::CreateStatic(&FTableauEditorActions::UnpackSelectedTableauActors));
 	TableauCommands->MapAction(Commands.UnpackOneLayer, FExecuteAction::CreateStatic(&FTableauEditorActions::UnpackOneLayer));
 	TableauCommands->MapAction(Commands.UnpackForEditing, FExecuteAction::CreateStatic(&FTableauEditorActions::UnpackForEditing));
 	TableauCommands->MapAction(Commands.FilterBySelectedActors, FExecuteAction::CreateStatic(&FTableauEditorActions::FilterBySelectedActors));
+	TableauCommands->MapAction(Commands.BakeSelectedTableauActors, FExecuteAction::CreateStatic(&FTableauEditorActions::BakeSelectedTableauActors));
 
 	FLevelEditorModule& LevelEditor = FModuleManager::GetModuleChecked<FLevelEditorModule>(TEXT("LevelEditor"));
 	TSharedRef<FUICommandList> CommandBindings = LevelEditor.GetGlobalLevelEditorActions();
@@ -270,12 +295,61 @@ void  FTableauEditorModule::RegisterEditorDelegates()
 
 	// Bind Actor duplicate delegate.
 	UTableauComponent::OnTableauDuplicate.BindRaw(this, &FTableauEditorModule::OnTableauActorDuplicate);
+
+	// Bind recipe restoration delegate, for regenerations that were transacted without their Instances.
+	UTableauComponent::OnTableauRecipeRestored.BindRaw(this, &FTableauEditorModule::OnTableauRecipeRestored);
+
+	// Instances moved by hand change the bounds of their Tableau, and any deleted Actor might have been
+	// a tracked Instance.
+	if (GEngine)
+	{
+		GEngine->OnActorMoved().AddRaw(this, &FTableauEditorModule::OnActorMoved);
+		GEngine->OnLevelActorDeleted().AddRaw(this, &FTableauEditorModule::OnLevelActorDeleted);
+	}
+
+	// Instances are also lost without a deletion notice when they are replaced, when a transaction that
+	// spawned them is undone, and when their Level is removed.
+	if (GEditor)
+	{
+		GEditor->OnObjectsReplaced().AddRaw(this, &FTableauEditorModule::OnObjectsReplaced);
+		GEditor->RegisterForUndo(this);
+	}
+	FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FTableauEditorModule::OnLevelRemovedFromWorld);
+
+	// Saving a Tableau Asset regenerates the placed Tableaux that depend on it.
+	DependencyIndex = MakeUnique<FTableauDependencyIndex>();
+	UPackage::PackageSavedEvent.AddRaw(this, &FTableauEditorModule::OnPackageSaved);
+	FTableauRegenerationTask::OnTaskFinished.AddRaw(this, &FTableauEditorModule::OnRegenerationTaskFinished);
+
+	// As does automatically reimporting one, when enabled.
+	SourceWatcher = MakeUnique<FTableauSourceWatcher>(FTableauSourceWatcher::FOnSourcesReimported::CreateRaw(this, &FTableauEditorModule::RegenerateDependents));
 }
 
 void  FTableauEditorModule::UnregisterEditorDelegates()
 {
 	USelection::SelectionChangedEvent.RemoveAll(this);
 	USelection::SelectObjectEvent.RemoveAll(this);
+
+	UTableauComponent::OnTableauRecipeRestored.Unbind();
+
+	if (GEngine)
+	{
+		GEngine->OnActorMoved().RemoveAll(this);
+		GEngine->OnLevelActorDeleted().RemoveAll(this);
+	}
+
+	if (GEditor)
+	{
+		GEditor->OnObjectsReplaced().RemoveAll(this);
+		GEditor->UnregisterForUndo(this);
+	}
+	FWorldDelegates::LevelRemovedFromWorld.RemoveAll(this);
+
+	UPackage::PackageSavedEvent.RemoveAll(this);
+	FTableauRegenerationTask::OnTaskFinished.RemoveAll(this);
+	SourceWatcher.Reset();
+	DependencyIndex.Reset();
+	PendingSavedTableaux.Empty();
 }
 
 void FTableauEditorModule::OnLevelSelectionChanged(UObject* Obj)
@@ -371,6 +445,179 @@ void FTableauEditorModule::OnTableauActorDuplicate(AActor* Actor)
 }
 
 
+void FTableauEditorModule::OnTableauRecipeRestored(UTableauComponent* Component)
+{
+	// The undo is still in progress. Regenerate once it has completed.
+	PendingRecipeRestorations.AddUnique(Component);
+
+	if (PendingRecipeRestorations.Num() == 1)
+	{
+		GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateLambda([this]()
+			{
+				TArray<TWeakObjectPtr<UTableauComponent>> Components = MoveTemp(PendingRecipeRestorations);
+				PendingRecipeRestorations.Reset();
+
+				for (const TWeakObjectPtr<UTableauComponent>& RestoredComponent : Components)
+				{
+					if (ATableauActor* TableauActor = Cast<ATableauActor>(RestoredComponent.IsValid() ? RestoredComponent->GetOwner() : nullptr))
+					{
+						if (!TableauActor->IsPendingKillPending())
+						{
+							FTableauActorManager Manager(TableauActor);
+							Manager.RegenerateFromRecipe();
+						}
+					}
+				}
+			}));
+	}
+}
+
+void FTableauEditorModule::OnLevelActorDeleted(AActor* Actor)
+{
+	UTableauComponent::InvalidateInstanceTracking();
+}
+
+void FTableauEditorModule::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	UTableauComponent::InvalidateInstanceTracking();
+}
+
+void FTableauEditorModule::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	UTableauComponent::InvalidateInstanceTracking();
+}
+
+void FTableauEditorModule::PostUndo(bool bSuccess)
+{
+	UTableauComponent::InvalidateInstanceTracking();
+}
+
+void FTableauEditorModule::PostRedo(bool bSuccess)
+{
+	UTableauComponent::InvalidateInstanceTracking();
+}
+
+void FTableauEditorModule::OnActorMoved(AActor* Actor)
+{
+	// Instances may be nested, so find the Tableau at the root of the attachment.
+	for (AActor* Parent = Actor ? Actor->GetAttachParentActor() : nullptr; Parent; Parent = Parent->GetAttachParentActor())
+	{
+		if (ATableauActor* TableauActor = Cast<ATableauActor>(Parent))
+		{
+			TableauActor->GetTableauComponent()->InvalidateBounds();
+			break;
+		}
+	}
+}
+
+void FTableauEditorModule::OnPackageSaved(const FString& PackageFileName, UObject* PackageObject)
+{
+	// Autosaves leave the assets unchanged, and cooking or commandlets saving packages have no placed
+	// Tableaux to regenerate.
+	if (PackageObject == nullptr || (GUnrealEd && GUnrealEd->IsAutosaving()) || IsRunningCommandlet() || GIsCookerLoadingPackage)
+	{
+		return;
+	}
+
+	TArray<UObject*> PackageObjects;
+	GetObjectsWithOuter(PackageObject, PackageObjects, false);
+
+	const int32 PreviouslyPending = PendingSavedTableaux.Num();
+	for (UObject* Object : PackageObjects)
+	{
+		if (UTableauAsset* TableauAsset = Cast<UTableauAsset>(Object))
+		{
+			PendingSavedTableaux.AddUnique(TableauAsset);
+		}
+	}
+
+	// Every package saved in the same frame, eg. by Save All, is regenerated as one batch on the next tick.
+	if (PreviouslyPending == 0 && PendingSavedTableaux.Num() > 0)
+	{
+		GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateRaw(this, &FTableauEditorModule::RegenerateSavedTableauDependents));
+	}
+}
+
+void FTableauEditorModule::RegenerateSavedTableauDependents()
+{
+	TArray<TWeakObjectPtr<UTableauAsset>> SavedTableaux = MoveTemp(PendingSavedTableaux);
+	PendingSavedTableaux.Reset();
+
+	TArray<UTableauAsset*> TableauAssets;
+	for (const TWeakObjectPtr<UTableauAsset>& SavedTableau : SavedTableaux)
+	{
+		if (SavedTableau.IsValid())
+		{
+			TableauAssets.Add(SavedTableau.Get());
+		}
+	}
+
+	RegenerateDependents(TableauAssets);
+}
+
+void FTableauEditorModule::OnRegenerationTaskFinished()
+{
+	// Retry the Tableaux deferred while the task was running.
+	if (PendingSavedTableaux.Num() > 0)
+	{
+		GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateRaw(this, &FTableauEditorModule::RegenerateSavedTableauDependents));
+	}
+}
+
+void FTableauEditorModule::RegenerateDependents(const TArray<UTableauAsset*>& TableauAssets)
+{
+	if (!DependencyIndex.IsValid())
+	{
+		return;
+	}
+
+	TArray<UTableauComponent*> Components;
+	for (const UTableauAsset* TableauAsset : TableauAssets)
+	{
+		DependencyIndex->FindDependentComponents(TableauAsset, Components);
+	}
+
+	TArray<ATableauActor*> TableauActors;
+	int32 EditedActors = 0;
+	for (UTableauComponent* Component : Components)
+	{
+		ATableauActor* TableauActor = Cast<ATableauActor>(Component->GetOwner());
+		if (TableauActor == nullptr || TableauActor->IsPendingKillPending())
+		{
+			continue;
+		}
+
+		// Instances arranged by hand would be lost, so those Tableaux are only regenerated on request.
+		if (Component->HasEditedInstances())
+		{
+			++EditedActors;
+			continue;
+		}
+
+		TableauActors.AddUnique(TableauActor);
+	}
+
+	if (EditedActors > 0)
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Skipped regenerating %d Tableau Actors following changes to their Tableau Assets, since their Instances were edited by hand."), EditedActors);
+	}
+
+	if (TableauActors.Num() > 0 && FTableauRegenerationTask::IsTaskRunning())
+	{
+		// The running task may be regenerating the same Actors, so the Tableau Assets are regenerated
+		// again once it finishes.
+		for (UTableauAsset* TableauAsset : TableauAssets)
+		{
+			PendingSavedTableaux.AddUnique(TableauAsset);
+		}
+		UE_LOG(LogTableau, Log, TEXT("Deferred regenerating %d Tableau Actors following changes to their Tableau Assets until the time sliced regeneration finishes."), TableauActors.Num());
+	}
+	else if (TableauActors.Num() > 0)
+	{
+		UE_LOG(LogTableau, Log, TEXT("Regenerating %d Tableau Actors following changes to their Tableau Assets."), TableauActors.Num());
+		FTableauActorManager::UpdateInstances(TableauActors);
+	}
+}
 
 #undef LOCTEXT_NAMESPACE
 	
@@ -55,3 +55,20 @@ FTableauEditorViewportClient::FTableauEditorViewportClient(TWeakPtr<ITableauEdit
 
 }
 
+void FTableauEditorViewportClient::ProcessClick(FSceneView& View, HHitProxy* HitProxy, FKey Key, EInputEvent Event, uint32 HitX, uint32 HitY)
+{
+	// A click in the seed grid applies the clicked cell's seed.
+	if (Key == EKeys::LeftMouseButton && Event == IE_Released)
+	{
+		if (TSharedPtr<STableauEditorViewport> TableauEditorViewport = TableauEditorViewportPtr.Pin())
+		{
+			const FViewportCursorLocation Cursor(&View, this, HitX, HitY);
+			if (TableauEditorViewport->SelectGridCell(Cursor.GetOrigin(), Cursor.GetDirection()))
+			{
+				return;
+			}
+		}
+	}
+
+	FEditorViewportClient::ProcessClick(View, HitProxy, Key, Event, HitX, HitY);
+}
@@ -0,0 +1,226 @@
+#include "TableauFloorSampler.h"
+
+// Engine Includes
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "Landscape.h"
+#include "LandscapeComponent.h"
+#include "LandscapeDataAccess.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+
+// Local Includes
+#include "TableauUtils.h"
+
+// constants
+// Size of the cells of the 2D grids indexing the cached heightfields and obstructing geometry.
+static const float FloorSamplerCellSize = 2500.0f;
+
+
+//////////////////////////////////////////////////
+// FTableauFloorSampler
+
+FTableauFloorSampler::FTableauFloorSampler(const UWorld* InWorld, const FBox& InRegion, AActor* InIgnoredActor)
+	: World(InWorld)
+	, IgnoredActor(InIgnoredActor)
+{
+	if (World == nullptr || !InRegion.IsValid)
+	{
+		return;
+	}
+
+	// Anything within the trace bracket of the region may be hit.
+	const FBox Region = InRegion.ExpandBy(FVector(0.0f, 0.0f, TableauSnapConstants::SnapToFloorBound));
+
+	// One overlap query gathers everything in the region, rather than walking every actor in the World.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TableauFloorSampler), false, IgnoredActor);
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByChannel(Overlaps, Region.GetCenter(), FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(Region.GetExtent()), QueryParams);
+
+	// Instanced components report one overlap per instance.
+	TSet<const UPrimitiveComponent*> VisitedComponents;
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		const UPrimitiveComponent* PrimitiveComponent = Overlap.GetComponent();
+		if (PrimitiveComponent == nullptr || PrimitiveComponent->IsPendingKill())
+		{
+			continue;
+		}
+
+		bool bAlreadyVisited = false;
+		VisitedComponents.Add(PrimitiveComponent, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			continue;
+		}
+
+		// Landscape collision is replaced by its heightfield, unless the landscape has holes painted in it, in
+		// which case it's traced like anything else. Other primitives of the landscape, eg. spline meshes, are
+		// always indexed below.
+		if (const ULandscapeHeightfieldCollisionComponent* CollisionComponent = Cast<ULandscapeHeightfieldCollisionComponent>(PrimitiveComponent))
+		{
+			ULandscapeComponent* LandscapeComponent = CollisionComponent->RenderComponent.Get();
+			if (LandscapeComponent && LandscapeComponent->IsRegistered() && !LandscapeComponent->ComponentHasVisibilityPainted())
+			{
+				CacheHeightfield(LandscapeComponent);
+				continue;
+			}
+		}
+
+		// Index everything else that would block a floor trace.
+		if (PrimitiveComponent->GetCollisionResponseToChannel(ECC_WorldStatic) != ECR_Block)
+		{
+			continue;
+		}
+
+		const FBox Bounds = PrimitiveComponent->Bounds.GetBox();
+		IndexBounds(Bounds, ObstructionGrid, ObstructionBounds.Add(Bounds));
+	}
+}
+
+void FTableauFloorSampler::CacheHeightfield(ULandscapeComponent* LandscapeComponent)
+{
+	FLandscapeComponentDataInterface DataInterface(LandscapeComponent);
+
+	FHeightfield& Heightfield = Heightfields.AddDefaulted_GetRef();
+	Heightfield.ComponentTransform = LandscapeComponent->GetComponentTransform();
+	Heightfield.ComponentSizeQuads = LandscapeComponent->ComponentSizeQuads;
+
+	const int32 ComponentSizeVerts = Heightfield.ComponentSizeQuads + 1;
+	Heightfield.WorldVertices.SetNumUninitialized(ComponentSizeVerts * ComponentSizeVerts);
+	for (int32 Y = 0; Y < ComponentSizeVerts; ++Y)
+	{
+		for (int32 X = 0; X < ComponentSizeVerts; ++X)
+		{
+			Heightfield.WorldVertices[Y * ComponentSizeVerts + X] = DataInterface.GetWorldVertex(X, Y);
+		}
+	}
+
+	IndexBounds(LandscapeComponent->Bounds.GetBox(), HeightfieldGrid, Heightfields.Num() - 1);
+}
+
+void FTableauFloorSampler::IndexBounds(const FBox& Bounds, TMap<FIntPoint, TArray<int32>>& Grid, int32 Index) const
+{
+	const int32 MinX = FMath::FloorToInt(Bounds.Min.X / FloorSamplerCellSize);
+	const int32 MinY = FMath::FloorToInt(Bounds.Min.Y / FloorSamplerCellSize);
+	const int32 MaxX = FMath::FloorToInt(Bounds.Max.X / FloorSamplerCellSize);
+	const int32 MaxY = FMath::FloorToInt(Bounds.Max.Y / FloorSamplerCellSize);
+
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			Grid.FindOrAdd(FIntPoint(CellX, CellY)).Add(Index);
+		}
+	}
+}
+
+bool FTableauFloorSampler::IsObstructed(const FVector& Location) const
+{
+	const FIntPoint Cell(FMath::FloorToInt(Location.X / FloorSamplerCellSize), FMath::FloorToInt(Location.Y / FloorSamplerCellSize));
+	if (const TArray<int32>* Indices = ObstructionGrid.Find(Cell))
+	{
+		const float TraceTop = Location.Z + TableauSnapConstants::SnapToFloorBound;
+		const float TraceBottom = Location.Z - TableauSnapConstants::SnapToFloorBound;
+
+		for (int32 Index : *Indices)
+		{
+			const FBox& Bounds = ObstructionBounds[Index];
+			if (Location.X >= Bounds.Min.X && Location.X <= Bounds.Max.X &&
+				Location.Y >= Bounds.Min.Y && Location.Y <= Bounds.Max.Y &&
+				TraceBottom <= Bounds.Max.Z && TraceTop >= Bounds.Min.Z)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool FTableauFloorSampler::SampleLandscape(const FVector& Location, FVector& OutFloorLocation, FVector& OutFloorNormal) const
+{
+	const FIntPoint Cell(FMath::FloorToInt(Location.X / FloorSamplerCellSize), FMath::FloorToInt(Location.Y / FloorSamplerCellSize));
+	const TArray<int32>* Indices = HeightfieldGrid.Find(Cell);
+	if (Indices == nullptr)
+	{
+		return false;
+	}
+
+	for (int32 Index : *Indices)
+	{
+		const FHeightfield& Heightfield = Heightfields[Index];
+
+		// Component space is measured in quads.
+		const FVector LocalLocation = Heightfield.ComponentTransform.InverseTransformPosition(Location);
+		const int32 SizeQuads = Heightfield.ComponentSizeQuads;
+		if (LocalLocation.X < 0.0f || LocalLocation.Y < 0.0f || LocalLocation.X > SizeQuads || LocalLocation.Y > SizeQuads)
+		{
+			continue;
+		}
+
+		const int32 X0 = FMath::Min(FMath::FloorToInt(LocalLocation.X), SizeQuads - 1);
+		const int32 Y0 = FMath::Min(FMath::FloorToInt(LocalLocation.Y), SizeQuads - 1);
+		const float FracX = LocalLocation.X - X0;
+		const float FracY = LocalLocation.Y - Y0;
+
+		const int32 SizeVerts = SizeQuads + 1;
+		const FVector& V00 = Heightfield.WorldVertices[Y0 * SizeVerts + X0];
+		const FVector& V10 = Heightfield.WorldVertices[Y0 * SizeVerts + X0 + 1];
+		const FVector& V01 = Heightfield.WorldVertices[(Y0 + 1) * SizeVerts + X0];
+		const FVector& V11 = Heightfield.WorldVertices[(Y0 + 1) * SizeVerts + X0 + 1];
+
+		// Bilinear interpolation of the height, and the normal from the interpolated tangents.
+		const float Height = FMath::BiLerp(V00.Z, V10.Z, V01.Z, V11.Z, FracX, FracY);
+		const FVector TangentX = FMath::Lerp(V10 - V00, V11 - V01, FracY);
+		const FVector TangentY = FMath::Lerp(V01 - V00, V11 - V10, FracX);
+
+		FVector Normal = (TangentX ^ TangentY).GetSafeNormal();
+		if (Normal.Z < 0.0f)
+		{
+			Normal = -Normal;
+		}
+
+		OutFloorLocation = FVector(Location.X, Location.Y, Height);
+		OutFloorNormal = Normal;
+		return true;
+	}
+
+	return false;
+}
+
+bool FTableauFloorSampler::SnapToFloor(FTransform& Xform, const FFloatInterval& GroundSlopeAngle, bool bAlignToNormal) const
+{
+	const FVector Location = Xform.GetTranslation();
+
+	FVector FloorLocation;
+	FVector FloorNormal;
+	if (IsObstructed(Location) || !SampleLandscape(Location, FloorLocation, FloorNormal))
+	{
+		return FTableauUtils::TraceToWorld(Xform, World, GroundSlopeAngle, IgnoredActor, bAlignToNormal);
+	}
+
+	// A trace would not have reached a floor outside of the bracket.
+	if (FMath::Abs(FloorLocation.Z - Location.Z) > TableauSnapConstants::SnapToFloorBound)
+	{
+		return false;
+	}
+
+	// Determine if the normal is within the allowed slope tolerance.
+	const float AngleFromHorizontal = FMath::RadiansToDegrees(FMath::Acos(FloorNormal.Z));
+	if (!GroundSlopeAngle.Contains(AngleFromHorizontal))
+	{
+		return false;
+	}
+
+	Xform.SetTranslation(FloorLocation);
+
+	if (bAlignToNormal)
+	{
+		FQuat CurrentRot = Xform.GetRotation();
+		FMatrix AlignedRotation = FRotationMatrix::MakeFromXZ(CurrentRot.GetAxisX(), FloorNormal);
+		Xform.SetRotation(AlignedRotation.ToQuat());
+	}
+
+	return true;
+}
@@ -0,0 +1,296 @@
+#include "TableauFoliageManager.h"
+
+// Engine Includes
+#include "EngineUtils.h"
+#include "FoliageType.h"
+#include "InstancedFoliageActor.h"
+#include "FoliageType_InstancedStaticMesh.h"
+#include "Async/ParallelFor.h"
+
+// Local Includes
+#include "TableauUtils.h"
+#include "TableauFloorSampler.h"
+#include "TableauFoliageSubsystem.h"
+
+// constants
+// Number of instances traced by each parallel snapping task.
+static const int32 SnapToFloorBatchSize = 512;
+
+FTableauFoliageManager::FTableauFoliageManager(ATableauActor* InActor) :
+	TableauActor(InActor)
+{
+	TableauActor->FoliageComponents.Empty();
+	
+	if (TableauActor.IsValid())
+	{
+		// Restore Actor's Foliage Component list.
+		TArray<UTableauHISMComponent*> Foliages;
+		TableauActor->GetComponents(Foliages, false);
+		for (UTableauHISMComponent* Foliage : Foliages)
+		{
+			TableauActor->FoliageComponents.Add(Foliage);
+		}
+	}
+
+}
+
+void FTableauFoliageManager::DestroyFoliageComponents()
+{
+	if (TableauActor.IsValid())
+	{
+		for (UTableauHISMComponent* Component : TableauActor->FoliageComponents)
+		{
+			TableauActor->RemoveInstanceComponent(Component);
+			Component->DestroyComponent(false);
+		}
+		TableauActor->FoliageComponents.Empty();
+
+		// Release any foliage held by the shared HISMs
+		if (TableauActor->SharedFoliage.Num() > 0)
+		{
+			TableauActor->Modify();
+			TableauActor->SharedFoliage.Empty();
+			TableauActor->UpdateSharedFoliage();
+		}
+
+		TableauActor->GetTableauComponent()->InvalidateBounds();
+	}
+}
+
+void FTableauFoliageManager::SnapToFloor(const UWorld* InWorld)
+{
+	if (TableauActor.IsValid())
+	{
+		FBox Region(ForceInit);
+		for (const UTableauHISMComponent* Component : TableauActor->FoliageComponents)
+		{
+			Region += Component->Bounds.GetBox();
+		}
+		Region += GetSharedFoliageBounds();
+
+		WithdrawSharedFoliage();
+
+		FTableauFloorSampler FloorSampler(InWorld, Region, TableauActor.Get());
+		SnapToFloor(FloorSampler);
+	}
+}
+
+void FTableauFoliageManager::WithdrawSharedFoliage()
+{
+	if (TableauActor.IsValid() && TableauActor->SharedFoliage.Num() > 0)
+	{
+		if (UWorld* World = TableauActor->GetWorld())
+		{
+			if (UTableauFoliageSubsystem* FoliageSubsystem = World->GetSubsystem<UTableauFoliageSubsystem>())
+			{
+				// The shared HISMs are otherwise only rebuilt on the next tick.
+				FoliageSubsystem->UnregisterActor(TableauActor.Get());
+				FoliageSubsystem->FlushDirtyCells();
+			}
+		}
+	}
+}
+
+FBox FTableauFoliageManager::GetSharedFoliageBounds() const
+{
+	FBox Bounds(ForceInit);
+
+	if (TableauActor.IsValid())
+	{
+		const FTransform ActorTransform = TableauActor->GetActorTransform();
+		for (const FTableauSharedFoliage& SharedFoliage : TableauActor->SharedFoliage)
+		{
+			for (const FTransform& Instance : SharedFoliage.Instances)
+			{
+				Bounds += ActorTransform.TransformPosition(Instance.GetLocation());
+			}
+		}
+	}
+
+	return Bounds;
+}
+
+void FTableauFoliageManager::SnapToFloor(const FTableauFloorSampler& FloorSampler)
+{
+	if (TableauActor.IsValid())
+	{
+		for (UTableauHISMComponent* Component : TableauActor->FoliageComponents)
+		{
+			if (Component->bSnappable)
+			{
+				SnapInstancesToFloor(Component, FloorSampler);
+			}
+		}
+
+		// Shared foliage is snapped in the Actor's own instance arrays, then handed back to the shared HISMs.
+		if (TableauActor->SharedFoliage.Num() > 0)
+		{
+			TableauActor->Modify();
+
+			const FTransform ActorTransform = TableauActor->GetActorTransform();
+			for (FTableauSharedFoliage& SharedFoliage : TableauActor->SharedFoliage)
+			{
+				if (!SharedFoliage.bSnappable)
+				{
+					continue;
+				}
+
+				TArray<FTransform> InstanceWorldTransforms;
+				InstanceWorldTransforms.Reserve(SharedFoliage.Instances.Num());
+				for (const FTransform& Instance : SharedFoliage.Instances)
+				{
+					InstanceWorldTransforms.Add(Instance * ActorTransform);
+				}
+
+				SnapTransformsToFloor(InstanceWorldTransforms, FloorSampler, SharedFoliage.GroundSlopeAngle, SharedFoliage.bAlignToNormal);
+
+				SharedFoliage.Instances.Reset(InstanceWorldTransforms.Num());
+				for (const FTransform& InstanceWorldTransform : InstanceWorldTransforms)
+				{
+					SharedFoliage.Instances.Add(InstanceWorldTransform.GetRelativeTransform(ActorTransform));
+				}
+			}
+
+			TableauActor->UpdateSharedFoliage();
+		}
+
+		TableauActor->GetTableauComponent()->InvalidateBounds();
+	}
+}
+
+void FTableauFoliageManager::SnapInstancesToFloor(UTableauHISMComponent* Component, const FTableauFloorSampler& FloorSampler)
+{
+	
+	const int32 InstanceCount = Component->GetInstanceCount();
+	TArray<FTransform> InstanceWorldTransforms;
+	InstanceWorldTransforms.SetNum(InstanceCount);
+
+	// Get the world space transform of each instance.
+	for (int32 i = 0; i < InstanceCount; ++i)
+	{
+		Component->GetInstanceTransform(i, InstanceWorldTransforms[i], true);
+	}
+
+	SnapTransformsToFloor(InstanceWorldTransforms, FloorSampler, Component->GroundSlopeAngle, Component->bAlignToNormal);
+
+	// Update the transforms in one pass and rebuild the cluster tree once.
+	Component->ClearInstances();
+	Component->AddInstancesInBulk(InstanceWorldTransforms, true);
+	Component->RebuildClusterTree();
+
+}
+
+void FTableauFoliageManager::SnapTransformsToFloor(TArray<FTransform>& WorldTransforms, const FTableauFloorSampler& FloorSampler, const FFloatInterval& GroundSlopeAngle, bool bAlignToNormal)
+{
+	const int32 InstanceCount = WorldTransforms.Num();
+
+	// Snap the instances in parallel batches. Landscape samples are memory reads; the fallback scene queries
+	// take the physics scene read lock, so they may run concurrently while the game thread waits on the batches.
+	TArray<bool> Snapped;
+	Snapped.SetNumZeroed(InstanceCount);
+
+	const int32 BatchCount = FMath::DivideAndRoundUp(InstanceCount, SnapToFloorBatchSize);
+
+	ParallelFor(BatchCount, [&](int32 BatchIndex)
+		{
+			const int32 FirstIndex = BatchIndex * SnapToFloorBatchSize;
+			const int32 LastIndex = FMath::Min(FirstIndex + SnapToFloorBatchSize, InstanceCount);
+			for (int32 i = FirstIndex; i < LastIndex; ++i)
+			{
+				Snapped[i] = FloorSampler.SnapToFloor(WorldTransforms[i], GroundSlopeAngle, bAlignToNormal);
+			}
+		});
+
+	// Compact the surviving instances, dropping the rejected ones.
+	int32 SnappedCount = 0;
+	for (int32 i = 0; i < InstanceCount; ++i)
+	{
+		if (Snapped[i])
+		{
+			WorldTransforms[SnappedCount++] = WorldTransforms[i];
+		}
+	}
+	WorldTransforms.SetNum(SnappedCount, false);
+}
+
+void FTableauFoliageManager::ExtractFoliage(UWorld* InWorld)
+{
+	if (TableauActor.IsValid())
+	{
+		AInstancedFoliageActor* FoliageActor = AInstancedFoliageActor::GetInstancedFoliageActorForLevel(TableauActor->GetLevel(), true);
+
+		for (const UTableauHISMComponent* Foliage : TableauActor->FoliageComponents)
+		{
+			// Resolve the HISM's FoliageType
+			FSoftObjectPtr SoftObjectPtr(Foliage->FoliageType);
+			if (UFoliageType* FoliageType = Cast<UFoliageType>(SoftObjectPtr.LoadSynchronous()))
+			{
+				// Gather locations from Tableau HISM Component
+				const int32 InstanceCount = Foliage->GetInstanceCount();
+				TArray<FTransform> InstanceWorldTransforms;
+				InstanceWorldTransforms.SetNum(InstanceCount);
+				for (int32 i = 0; i < InstanceCount; ++i)
+				{
+					Foliage->GetInstanceTransform(i, InstanceWorldTransforms[i], true);
+				}
+
+				AddInstancesToFoliageActor(FoliageActor, FoliageType, InstanceWorldTransforms);
+			}
+		}
+
+		// And from the foliage held by the shared HISMs
+		const FTransform ActorTransform = TableauActor->GetActorTransform();
+		for (const FTableauSharedFoliage& SharedFoliage : TableauActor->SharedFoliage)
+		{
+			FSoftObjectPtr SoftObjectPtr(SharedFoliage.FoliageType);
+			if (UFoliageType* FoliageType = Cast<UFoliageType>(SoftObjectPtr.LoadSynchronous()))
+			{
+				TArray<FTransform> InstanceWorldTransforms;
+				InstanceWorldTransforms.Reserve(SharedFoliage.Instances.Num());
+				for (const FTransform& Instance : SharedFoliage.Instances)
+				{
+					InstanceWorldTransforms.Add(Instance * ActorTransform);
+				}
+
+				AddInstancesToFoliageActor(FoliageActor, FoliageType, InstanceWorldTransforms);
+			}
+		}
+	}
+
+	DestroyFoliageComponents();
+}
+
+void FTableauFoliageManager::AddInstancesToFoliageActor(AInstancedFoliageActor* FoliageActor, UFoliageType* FoliageType, const TArray<FTransform>& WorldTransforms)
+{
+	if (!FoliageActor->FoliageInfos.Contains(FoliageType))
+	{
+		FoliageActor->AddFoliageType(FoliageType, nullptr);
+	}
+
+	FFoliageInfo* FoliageInfo = FoliageActor->FindInfo(FoliageType);
+
+	const int32 InstanceCount = WorldTransforms.Num();
+	TArray<FFoliageInstance> InstancePlacements;
+	InstancePlacements.SetNum(InstanceCount);
+	for (int32 i = 0; i < InstanceCount; ++i)
+	{
+		FFoliageInstance& InstancePlacement = InstancePlacements[i];
+		InstancePlacement.Location = WorldTransforms[i].GetLocation();
+		InstancePlacement.DrawScale3D = WorldTransforms[i].GetScale3D();
+		InstancePlacement.Rotation = WorldTransforms[i].Rotator();
+	}
+
+	TArray<const FFoliageInstance*> NewInstances;
+	NewInstances.Reserve(InstanceCount);
+	for (const FFoliageInstance& InstancePlacement : InstancePlacements)
+	{
+		NewInstances.Add(&InstancePlacement);
+	}
+
+	// Add them to the Foliage in a single batch.
+	FoliageInfo->ReserveAdditionalInstances(FoliageActor, FoliageType, InstanceCount);
+	FoliageInfo->AddInstances(FoliageActor, FoliageType, NewInstances);
+
+	// Rebuild the cluster tree once for everything transferred.
+	FoliageInfo->Refresh(FoliageActor, /*Async*/true, /*Force*/true);
+}
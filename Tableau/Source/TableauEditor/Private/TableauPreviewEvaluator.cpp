@@ -0,0 +1,203 @@
+#include "TableauPreviewEvaluator.h"
+
+// Engine Includes
+#include "Async/Async.h"
+#include "Engine/StaticMesh.h"
+#include "FoliageType.h"
+
+// Local Includes
+#include "TableauAsset.h"
+#include "TableauEvaluationContext.h"
+#include "TableauLatentTree.h"
+
+// constants
+static const int32 PreviewCacheSize = 64;
+static const int32 MaxEvaluationsInFlight = 16;
+
+
+//////////////////////////////////////////////////
+// FTableauPreviewEvaluator
+
+FTableauPreviewEvaluator::FTableauPreviewEvaluator(UWorld* InWorld)
+	: World(InWorld)
+	, Tableau(nullptr)
+{
+	UTableauAsset::OnTableauElementsChanging.AddRaw(this, &FTableauPreviewEvaluator::OnTableauElementsChanging);
+}
+
+FTableauPreviewEvaluator::~FTableauPreviewEvaluator()
+{
+	UTableauAsset::OnTableauElementsChanging.RemoveAll(this);
+
+	// Let the tasks in flight finish before releasing what they reference.
+	for (FEvaluation& Evaluation : Evaluations)
+	{
+		Evaluation.Future.Wait();
+	}
+	Evaluations.Empty();
+	Cache.Empty();
+	Context.Reset();
+}
+
+void FTableauPreviewEvaluator::SetTableau(UTableauAsset* InTableau)
+{
+	Tableau = InTableau;
+
+	for (FEvaluation& Evaluation : Evaluations)
+	{
+		Evaluation.bAbandoned = true;
+	}
+	Cache.Empty();
+
+	// The abandoned evaluations keep the previous context alive until they complete.
+	Context = MakeShareable(new FTableauEvaluationContext(World));
+	Context->AddTableau(Tableau);
+}
+
+bool FTableauPreviewEvaluator::DependsOn(const UTableauAsset* InTableau) const
+{
+	if (InTableau == nullptr)
+	{
+		return false;
+	}
+
+	return InTableau == Tableau || (Context.IsValid() && Context->FindCompiledAsset(InTableau) != nullptr);
+}
+
+TSharedPtr<const FTableauPreviewResult> FTableauPreviewEvaluator::FindResult(int32 Seed)
+{
+	const int32 CacheIndex = Cache.IndexOfByPredicate([Seed](const TPair<int32, TSharedPtr<const FTableauPreviewResult>>& Entry)
+		{
+			return Entry.Key == Seed;
+		});
+
+	if (CacheIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	TPair<int32, TSharedPtr<const FTableauPreviewResult>> Entry = Cache[CacheIndex];
+	Cache.RemoveAt(CacheIndex);
+	Cache.Add(Entry);
+
+	return Entry.Value;
+}
+
+bool FTableauPreviewEvaluator::RequestEvaluation(int32 Seed)
+{
+	if (Tableau == nullptr || !Context.IsValid())
+	{
+		return false;
+	}
+
+	for (const TPair<int32, TSharedPtr<const FTableauPreviewResult>>& Entry : Cache)
+	{
+		if (Entry.Key == Seed)
+		{
+			return true;
+		}
+	}
+
+	int32 EvaluationsInFlight = 0;
+	for (const FEvaluation& Evaluation : Evaluations)
+	{
+		if (!Evaluation.bAbandoned)
+		{
+			if (Evaluation.Seed == Seed)
+			{
+				return true;
+			}
+			++EvaluationsInFlight;
+		}
+	}
+
+	if (EvaluationsInFlight >= MaxEvaluationsInFlight)
+	{
+		return false;
+	}
+
+	// Express the latent tree -- disregarding captured config -- for display in the editor.
+	TSharedPtr<FTableauFilterSampler> Filter = MakeShareable(new FTableauFilterSampler(FTransform::Identity));
+
+	FEvaluation& Evaluation = Evaluations.AddDefaulted_GetRef();
+	Evaluation.Seed = Seed;
+	Evaluation.LatentTree = MakeShareable(new FTableauLatentTree(Tableau, Filter, true, Context));
+	Evaluation.Result = MakeShareable(new FTableauPreviewResult);
+
+	// The task only borrows the latent tree and result; both outlive it.
+	FTableauLatentTree* LatentTree = Evaluation.LatentTree.Get();
+	FTableauPreviewResult* Result = Evaluation.Result.Get();
+	Evaluation.Future = Async(EAsyncExecution::ThreadPool, [LatentTree, Result, Seed]()
+		{
+			LatentTree->EvaluateLatentTree(Seed);
+			GatherResult(*LatentTree, *Result);
+		});
+
+	return true;
+}
+
+void FTableauPreviewEvaluator::Tick()
+{
+	for (int32 Index = 0; Index < Evaluations.Num();)
+	{
+		FEvaluation& Evaluation = Evaluations[Index];
+		if (!Evaluation.Future.IsReady())
+		{
+			++Index;
+			continue;
+		}
+
+		if (!Evaluation.bAbandoned)
+		{
+			if (Cache.Num() >= PreviewCacheSize)
+			{
+				Cache.RemoveAt(0);
+			}
+			Cache.Add(TPair<int32, TSharedPtr<const FTableauPreviewResult>>(Evaluation.Seed, Evaluation.Result));
+		}
+
+		Evaluations.RemoveAt(Index);
+	}
+}
+
+void FTableauPreviewEvaluator::OnTableauElementsChanging(const UTableauAsset* ChangingTableau)
+{
+	// Abandoned evaluations may reach Tableaux the current context doesn't, so every evaluation in flight
+	// is completed, whichever Tableau is changing.
+	for (FEvaluation& Evaluation : Evaluations)
+	{
+		Evaluation.Future.Wait();
+	}
+
+	// Results read from the Tableau before the edit are stale.
+	if (DependsOn(ChangingTableau))
+	{
+		for (FEvaluation& Evaluation : Evaluations)
+		{
+			Evaluation.bAbandoned = true;
+		}
+		Cache.Empty();
+	}
+}
+
+void FTableauPreviewEvaluator::GatherResult(const FTableauLatentTree& LatentTree, FTableauPreviewResult& Result)
+{
+	for (const FTableauRecipeNode& RecipeNode : LatentTree.Recipe)
+	{
+		UObject* Asset = RecipeNode.AssetReference.Get();
+		if (Asset == nullptr)
+		{
+			continue;
+		}
+
+		if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
+		{
+			Result.InstanceTransforms.FindOrAdd(TPair<UStaticMesh*, UFoliageType*>(StaticMesh, RecipeNode.FoliageType.Get())).Add(RecipeNode.LocalTransform);
+			Result.Bounds += StaticMesh->GetBoundingBox().TransformBy(RecipeNode.LocalTransform);
+		}
+		else
+		{
+			Result.Assets.Add(TPair<UObject*, FTransform>(Asset, RecipeNode.LocalTransform));
+		}
+	}
+}
@@ -5,6 +5,9 @@
 #include "Editor.h"
 #include "Misc/FileHelper.h"
 #include "EditorFramework/AssetImportData.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFilemanager.h"
 
 // Local Includes
 #include "TableauEditorModule.h"
@@ -12,6 +15,71 @@
 // Local constants
 const static int32 CartesianCoordinateComponentCount = 3;
 const static int32 QuaternionComponentCount = 4;
+const static uint32 BinarySourceMagic = 0x42424154;
+const static uint32 BinarySourceVersion = 2;
+const static uint32 BinarySourceVersionWithoutIds = 1;
+const static uint32 BinarySourceNoString = MAX_uint32;
+
+namespace
+{
+	struct FBinarySourceHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 EvaluationMode;
+		uint32 StringCount;
+		uint32 ElementCount;
+	};
+
+	struct FBinarySourceElement
+	{
+		uint32 Name;
+		uint32 AssetReference;
+		float Translate[3];
+		float Orient[4];
+		float Scale[3];
+
+		// Added in version 2. Version 1 records end before it.
+		uint32 Id;
+	};
+
+	/*
+	* The bytes of a source file, memory mapped where the platform allows and read whole otherwise.
+	*/
+	class FSourceFileView
+	{
+	public:
+		FSourceFileView(const FString& Filename)
+		{
+			MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+			if (MappedHandle.IsValid())
+			{
+				MappedRegion.Reset(MappedHandle->MapRegion());
+			}
+
+			if (!MappedRegion.IsValid())
+			{
+				FFileHelper::LoadFileToArray(Contents, *Filename);
+			}
+		}
+
+		const uint8* GetData() const
+		{
+			return MappedRegion.IsValid() ? MappedRegion->GetMappedPtr() : Contents.GetData();
+		}
+
+		int64 GetSize() const
+		{
+			return MappedRegion.IsValid() ? MappedRegion->GetMappedSize() : Contents.Num();
+		}
+
+	private:
+		// The region must be released before the handle.
+		TUniquePtr<IMappedFileHandle> MappedHandle;
+		TUniquePtr<IMappedFileRegion> MappedRegion;
+		TArray<uint8> Contents;
+	};
+}
 
 UTableauProceduralFactory::UTableauProceduralFactory(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -23,11 +91,13 @@ UTableauProceduralFactory::UTableauProceduralFactory(const FObjectInitializer& O
 	bText = false;
 
 	Formats.Add(TEXT("tab;Tableau config file"));
+	Formats.Add(TEXT("tabb;Tableau binary config file"));
 }
 
 void UTableauProceduralFactory::GetSupportedFileExtensions(TArray< FString >& OutExtensions) const
 {
 	OutExtensions.Add(FString(TEXT("tab")));
+	OutExtensions.Add(FString(TEXT("tabb")));
 }
 
 UObject* UTableauProceduralFactory::FactoryCreateFile
@@ -44,19 +114,15 @@ UObject* UTableauProceduralFactory::FactoryCreateFile
 {
 	CurrentFilename = Filename;
 
-	FString FileContents;
-	FFileHelper::LoadFileToString(FileContents, *CurrentFilename);
-
-	TSharedPtr<FJsonObject> JsonObject;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
-	if (FJsonSerializer::Deserialize(Reader, JsonObject))
+	FTableauSourceContents SourceContents;
+	if (ReadSourceFile(SourceContents))
 	{
 		UTableauAsset* NewTableauAsset = NewObject<UTableauAsset>(InParent, InClass, InName, Flags);
 
 		// Set Source for reimport
 		NewTableauAsset->SourceFilePath = UAssetImportData::SanitizeImportFilename(CurrentFilename, NewTableauAsset->GetOutermost());
 
-		PopulateTableauAssetFromSource(NewTableauAsset, JsonObject);
+		PopulateTableauAssetFromSource(NewTableauAsset, MoveTemp(SourceContents));
 		
 		return NewTableauAsset;	
 	}
@@ -69,60 +135,401 @@ UObject* UTableauProceduralFactory::FactoryCreateFile
 
 void UTableauProceduralFactory::PopulateTableauAssetFromSource(UTableauAsset* TableauAsset, const TSharedPtr<FJsonObject>& JsonObject) const
 {
-	TableauAsset->EvaluationMode = ExtractEvaluationModeFromJsonObject(JsonObject);
+	FTableauSourceContents SourceContents;
+	SourceContents.EvaluationMode = ExtractEvaluationModeFromJsonObject(JsonObject);
 
 	if (JsonObjectHasField(JsonObject, TEXT("Elements")))
 	{
-		const TArray<TSharedPtr<FJsonValue>> JsonElements = JsonObject->GetArrayField(TEXT("Elements"));
+		const TArray<TSharedPtr<FJsonValue>>& JsonElements = JsonObject->GetArrayField(TEXT("Elements"));
+		SourceContents.Elements.Reserve(JsonElements.Num());
 		for (const TSharedPtr<FJsonValue>& JsonElement : JsonElements)
 		{
 			FTableauAssetElement ExtractedElement;
 			if (ExtractTableauElementFromJsonObject(JsonElement->AsObject(), ExtractedElement))
 			{
-				TableauAsset->AddElement(ExtractedElement);
+				SourceContents.Elements.Add(MoveTemp(ExtractedElement));
 			}
 		}
 	}
+
+	PopulateTableauAssetFromSource(TableauAsset, MoveTemp(SourceContents));
 }
 
-bool UTableauProceduralFactory::JsonObjectHasField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName) const
+void UTableauProceduralFactory::PopulateTableauAssetFromSource(UTableauAsset* TableauAsset, FTableauSourceContents&& SourceContents) const
 {
-	if (JsonObject->HasField(FieldName))
+	TableauAsset->EvaluationMode = SourceContents.EvaluationMode;
+	TableauAsset->AddElements(MoveTemp(SourceContents.Elements));
+}
+
+bool UTableauProceduralFactory::ReadSourceFile(FTableauSourceContents& OutContents) const
+{
+	const FSourceFileView SourceFile(CurrentFilename);
+	if (SourceFile.GetSize() == 0)
 	{
-		return true;
+		UE_LOG(LogTableau, Error, TEXT("Unable to import %s: the file is empty or can't be read."), *CurrentFilename);
+		return false;
 	}
 
-	UE_LOG(LogTableau, Warning, TEXT("Unexpected format in %s: no %s field found."), *CurrentFilename, *FieldName);
-	return false;
+	if (FPaths::GetExtension(CurrentFilename).Equals(TEXT("tabb")))
+	{
+		return ReadBinarySource(SourceFile.GetData(), SourceFile.GetSize(), OutContents);
+	}
+
+	// The scan expects UTF-8, so files saved with a UTF-16 byte order mark are converted first.
+	const uint8* Data = SourceFile.GetData();
+	const int64 Size = SourceFile.GetSize();
+	if (Size >= 2 && ((Data[0] == 0xFF && Data[1] == 0xFE) || (Data[0] == 0xFE && Data[1] == 0xFF)))
+	{
+		FString FileContents;
+		FFileHelper::BufferToString(FileContents, Data, Size);
+		FTCHARToUTF8 ConvertedContents(*FileContents);
+		return ReadJsonSource(reinterpret_cast<const uint8*>(ConvertedContents.Get()), ConvertedContents.Length(), OutContents);
+	}
+
+	return ReadJsonSource(Data, Size, OutContents);
 }
 
-ETableauEvaluationMode::Type UTableauProceduralFactory::ExtractEvaluationModeFromJsonObject(const TSharedPtr<FJsonObject>& JsonObject) const
+bool UTableauProceduralFactory::ReadJsonSource(const uint8* Data, int64 Size, FTableauSourceContents& OutContents) const
 {
-	// If no valid Evaluation Mode is found, we default to Composition.
-	if (JsonObjectHasField(JsonObject, TEXT("EvaluationMode")))
+	// Skip the UTF-8 byte order mark.
+	if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Data += 3;
+		Size -= 3;
+	}
+
+	const ANSICHAR* Text = reinterpret_cast<const ANSICHAR*>(Data);
+
+	FString Mode;
+	TArray<TPair<int64, int64>> ElementRanges;
+	if (!FindJsonElements(Text, Size, Mode, ElementRanges))
 	{
-		FString Mode(JsonObject->GetStringField(TEXT("EvaluationMode")));
-		if (Mode == TEXT("Composition"))
+		UE_LOG(LogTableau, Error, TEXT("Unable to import %s: unexpected format."), *CurrentFilename);
+		return false;
+	}
+
+	if (Mode.IsEmpty())
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Unexpected format in %s: no %s field found."), *CurrentFilename, TEXT("EvaluationMode"));
+	}
+	OutContents.EvaluationMode = Mode.IsEmpty() ? ETableauEvaluationMode::Type::Composition : EvaluationModeFromString(Mode);
+
+	// Each element is small, so parsing them one at a time into their own JSON object keeps the memory
+	// bounded, and lets them be parsed in parallel.
+	TArray<FTableauAssetElement> Elements;
+	TArray<bool> ValidElements;
+	Elements.SetNum(ElementRanges.Num());
+	ValidElements.SetNumZeroed(ElementRanges.Num());
+
+	ParallelFor(ElementRanges.Num(), [this, Text, &ElementRanges, &Elements, &ValidElements](int32 Index)
 		{
-			return ETableauEvaluationMode::Type::Composition;
+			const TPair<int64, int64>& ElementRange = ElementRanges[Index];
+			const FUTF8ToTCHAR ConvertedElement(Text + ElementRange.Key, (int32)(ElementRange.Value - ElementRange.Key));
+			const FString ElementText(ConvertedElement.Length(), ConvertedElement.Get());
+
+			TSharedPtr<FJsonObject> JsonObject;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ElementText);
+			if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+			{
+				ValidElements[Index] = ExtractTableauElementFromJsonObject(JsonObject, Elements[Index]);
+			}
+			else
+			{
+				UE_LOG(LogTableau, Warning, TEXT("Element skipped in %s: unexpected format."), *CurrentFilename);
+			}
+		});
+
+	OutContents.Elements.Reserve(OutContents.Elements.Num() + Elements.Num());
+	for (int32 Index = 0; Index < Elements.Num(); ++Index)
+	{
+		if (ValidElements[Index])
+		{
+			OutContents.Elements.Add(MoveTemp(Elements[Index]));
 		}
-		else if (Mode == TEXT("Superposition"))
+	}
+
+	return true;
+}
+
+bool UTableauProceduralFactory::FindJsonElements(const ANSICHAR* Data, int64 Size, FString& OutEvaluationMode, TArray<TPair<int64, int64>>& OutElementRanges) const
+{
+	// A single pass over the file tracking only nesting and strings. The root object's fields sit at depth 1,
+	// so the objects of its Elements array begin at depth 2.
+	int32 Depth = 0;
+	int64 StringStart = INDEX_NONE;
+	int64 ElementStart = INDEX_NONE;
+	bool bInElements = false;
+	bool bElementsFound = false;
+	bool bExpectingValue = false;
+	FString Field;
+
+	for (int64 Index = 0; Index < Size; ++Index)
+	{
+		const ANSICHAR Char = Data[Index];
+
+		if (StringStart != INDEX_NONE)
 		{
-			return ETableauEvaluationMode::Type::Superposition;
+			if (Char == '\\')
+			{
+				++Index;
+			}
+			else if (Char == '"')
+			{
+				// Only the root object's field names and string values are of interest.
+				if (Depth == 1)
+				{
+					const FUTF8ToTCHAR ConvertedString(Data + StringStart + 1, (int32)(Index - StringStart - 1));
+					const FString String(ConvertedString.Length(), ConvertedString.Get());
+					if (!bExpectingValue)
+					{
+						Field = String;
+					}
+					else if (Field == TEXT("EvaluationMode"))
+					{
+						OutEvaluationMode = String;
+					}
+				}
+				StringStart = INDEX_NONE;
+			}
+			continue;
 		}
-		else if (Mode == TEXT("HierarchicalComposition"))
+
+		switch (Char)
 		{
-			return ETableauEvaluationMode::Type::HierarchicalComposition;
+			case '"':
+				StringStart = Index;
+				break;
+
+			case ':':
+				if (Depth == 1)
+				{
+					bExpectingValue = true;
+				}
+				break;
+
+			case ',':
+				if (Depth == 1)
+				{
+					bExpectingValue = false;
+				}
+				break;
+
+			case '{':
+			case '[':
+				if (Depth == 1 && Char == '[' && bExpectingValue && Field == TEXT("Elements"))
+				{
+					bInElements = true;
+					bElementsFound = true;
+				}
+				else if (Depth == 2 && bInElements && Char == '{')
+				{
+					ElementStart = Index;
+				}
+				++Depth;
+				break;
+
+			case '}':
+			case ']':
+				--Depth;
+				if (Depth < 0)
+				{
+					return false;
+				}
+				if (Depth == 2 && ElementStart != INDEX_NONE)
+				{
+					OutElementRanges.Add(TPair<int64, int64>(ElementStart, Index + 1));
+					ElementStart = INDEX_NONE;
+				}
+				else if (Depth == 1)
+				{
+					bInElements = false;
+				}
+				break;
+
+			default:
+				break;
 		}
-		else
+	}
+
+	if (Depth != 0 || StringStart != INDEX_NONE)
+	{
+		return false;
+	}
+
+	if (!bElementsFound)
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Unexpected format in %s: no %s field found."), *CurrentFilename, TEXT("Elements"));
+	}
+
+	return true;
+}
+
+bool UTableauProceduralFactory::ReadBinarySource(const uint8* Data, int64 Size, FTableauSourceContents& OutContents) const
+{
+	FBinarySourceHeader Header;
+	if (Size < sizeof(FBinarySourceHeader))
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to import %s: unexpected format."), *CurrentFilename);
+		return false;
+	}
+	FMemory::Memcpy(&Header, Data, sizeof(FBinarySourceHeader));
+
+	const bool bSupportedVersion = (Header.Version == BinarySourceVersion || Header.Version == BinarySourceVersionWithoutIds);
+	if (Header.Magic != BinarySourceMagic || !bSupportedVersion || Header.ElementCount > (uint32)MAX_int32)
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to import %s: unexpected format or version."), *CurrentFilename);
+		return false;
+	}
+
+	if (Header.EvaluationMode > (uint32)ETableauEvaluationMode::Type::HierarchicalComposition)
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Invalid EvaluationMode found in %s: defaulting to Composition."), *CurrentFilename);
+		Header.EvaluationMode = ETableauEvaluationMode::Type::Composition;
+	}
+	OutContents.EvaluationMode = (ETableauEvaluationMode::Type)Header.EvaluationMode;
+
+	// Every string takes at least its length, so a larger count can't be honest. Checked before anything
+	// is reserved from it.
+	if ((uint64)Header.StringCount > (uint64)(Size - sizeof(FBinarySourceHeader)) / sizeof(uint32))
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to import %s: the string table is truncated."), *CurrentFilename);
+		return false;
+	}
+
+	// Walk the string table. Each string is converted once, as both a name and an asset path.
+	TArray<FName> Names;
+	TArray<FSoftObjectPath> AssetReferences;
+	Names.Reserve(Header.StringCount);
+	AssetReferences.Reserve(Header.StringCount);
+
+	int64 Offset = sizeof(FBinarySourceHeader);
+	for (uint32 StringIndex = 0; StringIndex < Header.StringCount; ++StringIndex)
+	{
+		uint32 Length = 0;
+		if (Offset + (int64)sizeof(uint32) > Size)
+		{
+			UE_LOG(LogTableau, Error, TEXT("Unable to import %s: the string table is truncated."), *CurrentFilename);
+			return false;
+		}
+		FMemory::Memcpy(&Length, Data + Offset, sizeof(uint32));
+		Offset += sizeof(uint32);
+
+		if (Offset + Length > Size)
+		{
+			UE_LOG(LogTableau, Error, TEXT("Unable to import %s: the string table is truncated."), *CurrentFilename);
+			return false;
+		}
+
+		const FUTF8ToTCHAR ConvertedString(reinterpret_cast<const ANSICHAR*>(Data + Offset), (int32)Length);
+		const FString String(ConvertedString.Length(), ConvertedString.Get());
+		Names.Add(FName(*String));
+		AssetReferences.Add(FSoftObjectPath(String));
+		Offset += Length;
+	}
+
+	const int64 RecordSize = (Header.Version == BinarySourceVersionWithoutIds) ? sizeof(FBinarySourceElement) - sizeof(uint32) : sizeof(FBinarySourceElement);
+	if (Offset + (int64)Header.ElementCount * RecordSize != Size)
+	{
+		UE_LOG(LogTableau, Error, TEXT("Unable to import %s: unexpected element count."), *CurrentFilename);
+		return false;
+	}
+
+	// The records are fixed size, so they're unpacked straight into a presized element array.
+	const uint8* Records = Data + Offset;
+	TArray<FTableauAssetElement> Elements;
+	TArray<bool> ValidElements;
+	Elements.SetNum(Header.ElementCount);
+	ValidElements.SetNumZeroed(Header.ElementCount);
+
+	ParallelFor((int32)Header.ElementCount, [this, Records, RecordSize, &Names, &AssetReferences, &Elements, &ValidElements](int32 Index)
+		{
+			// The string table leaves the records unaligned.
+			FBinarySourceElement Record;
+			Record.Id = BinarySourceNoString;
+			FMemory::Memcpy(&Record, Records + (int64)Index * RecordSize, RecordSize);
+
+			if (!Names.IsValidIndex(Record.Name) || !AssetReferences.IsValidIndex(Record.AssetReference))
+			{
+				UE_LOG(LogTableau, Warning, TEXT("Element skipped in %s: string index out of range."), *CurrentFilename);
+				return;
+			}
+
+			const FSoftObjectPath& AssetReference = AssetReferences[Record.AssetReference];
+			if (!AssetReference.IsValid())
+			{
+				UE_LOG(LogTableau, Warning, TEXT("Element skipped in %s: invalid asset %s."), *CurrentFilename, *AssetReference.ToString());
+				return;
+			}
+
+			const FTransform LocalTransform(
+				FQuat(Record.Orient[0], Record.Orient[1], Record.Orient[2], Record.Orient[3]),
+				FVector(Record.Translate[0], Record.Translate[1], Record.Translate[2]),
+				FVector(Record.Scale[0], Record.Scale[1], Record.Scale[2]));
+
+			FTableauAssetElement& Element = Elements[Index];
+			Element = FTableauAssetElement(Names[Record.Name], AssetReference, FString(), LocalTransform, 0);
+			Element.bUseConfig = false;
+			if (Record.Id != BinarySourceNoString && Names.IsValidIndex(Record.Id))
+			{
+				Element.SourceId = Names[Record.Id];
+			}
+			ValidElements[Index] = true;
+		});
+
+	OutContents.Elements.Reserve(OutContents.Elements.Num() + Elements.Num());
+	for (int32 Index = 0; Index < Elements.Num(); ++Index)
+	{
+		if (ValidElements[Index])
 		{
-			UE_LOG(LogTableau, Warning, TEXT("Invalid EvaluationMode found in %s: defaulting to Composition."), *CurrentFilename);
-			return ETableauEvaluationMode::Type::Composition;
+			OutContents.Elements.Add(MoveTemp(Elements[Index]));
 		}
 	}
+
+	return true;
+}
+
+bool UTableauProceduralFactory::JsonObjectHasField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName) const
+{
+	if (JsonObject->HasField(FieldName))
+	{
+		return true;
+	}
+
+	UE_LOG(LogTableau, Warning, TEXT("Unexpected format in %s: no %s field found."), *CurrentFilename, *FieldName);
+	return false;
+}
+
+ETableauEvaluationMode::Type UTableauProceduralFactory::ExtractEvaluationModeFromJsonObject(const TSharedPtr<FJsonObject>& JsonObject) const
+{
+	// If no valid Evaluation Mode is found, we default to Composition.
+	if (JsonObjectHasField(JsonObject, TEXT("EvaluationMode")))
+	{
+		return EvaluationModeFromString(JsonObject->GetStringField(TEXT("EvaluationMode")));
+	}
 	return ETableauEvaluationMode::Type::Composition;
 }
 
+ETableauEvaluationMode::Type UTableauProceduralFactory::EvaluationModeFromString(const FString& Mode) const
+{
+	if (Mode == TEXT("Composition"))
+	{
+		return ETableauEvaluationMode::Type::Composition;
+	}
+	else if (Mode == TEXT("Superposition"))
+	{
+		return ETableauEvaluationMode::Type::Superposition;
+	}
+	else if (Mode == TEXT("HierarchicalComposition"))
+	{
+		return ETableauEvaluationMode::Type::HierarchicalComposition;
+	}
+	else
+	{
+		UE_LOG(LogTableau, Warning, TEXT("Invalid EvaluationMode found in %s: defaulting to Composition."), *CurrentFilename);
+		return ETableauEvaluationMode::Type::Composition;
+	}
+}
+
 bool UTableauProceduralFactory::ExtractTableauElementFromJsonObject(const TSharedPtr<FJsonObject>& JsonObject, FTableauAssetElement& ExtractedElement) const
 {
 	FName Name;
@@ -146,6 +553,14 @@ bool UTableauProceduralFactory::ExtractTableauElementFromJsonObject(const TShare
 	FTableauAssetElement TableauAssetElement(Name, AssetReference, TEXT(""), LocalTransform, 0);
 	TableauAssetElement.bUseConfig = false;
 
+	// The Id is optional, and may be a string or a number.
+	FString SourceId;
+	const TSharedPtr<FJsonValue> SourceIdValue = JsonObject->TryGetField(TEXT("Id"));
+	if (SourceIdValue.IsValid() && SourceIdValue->TryGetString(SourceId))
+	{
+		TableauAssetElement.SourceId = *SourceId;
+	}
+
 	ExtractedElement = TableauAssetElement;
 
 	return true;
@@ -260,6 +675,8 @@ bool UTableauProceduralFactory::ExtractOrientFromJsonObject(const TSharedPtr<FJs
 
 
 
+UTableauReimportProceduralFactory::FOnTableauReimportedDelegate UTableauReimportProceduralFactory::OnTableauReimported;
+
 bool UTableauReimportProceduralFactory::CanReimport(UObject* Obj, TArray<FString>& OutFilenames)
 {
 	if (UTableauAsset* TableauAsset = Cast<UTableauAsset>(Obj))
@@ -290,29 +707,19 @@ EReimportResult::Type UTableauReimportProceduralFactory::Reimport(UObject* Obj)
 	if (UTableauAsset* TableauAsset = Cast<UTableauAsset>(Obj))
 	{
 		const FString Filename = UAssetImportData::ResolveImportFilename(TableauAsset->SourceFilePath, TableauAsset->GetOutermost());
-		if (!FPaths::GetExtension(Filename).Equals(TEXT("tab")))
+		const FString Extension = FPaths::GetExtension(Filename);
+		if (!Extension.Equals(TEXT("tab")) && !Extension.Equals(TEXT("tabb")))
 		{
 			return EReimportResult::Failed;
 		}
 
-		// Clear the current Elements for the asset
-		TableauAsset->ClearElements();
-
 		// Rebuild the asset from the source file
 		CurrentFilename = Filename;
 
-		FString FileContents;
-		FFileHelper::LoadFileToString(FileContents, *CurrentFilename);
-
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
-		if (FJsonSerializer::Deserialize(Reader, JsonObject))
+		FTableauSourceContents SourceContents;
+		if (ReadSourceFile(SourceContents))
 		{
-			// Set Source for reimport
-			TableauAsset->SourceFilePath = UAssetImportData::SanitizeImportFilename(CurrentFilename, TableauAsset->GetOutermost());
-
-			PopulateTableauAssetFromSource(TableauAsset, JsonObject);
-
+			ApplyReimport(TableauAsset, MoveTemp(SourceContents));
 			return EReimportResult::Succeeded;
 		}
 		
@@ -326,3 +733,194 @@ EReimportResult::Type UTableauReimportProceduralFactory::Reimport(UObject* Obj)
 	}
 
 }
+
+FTableauReimportDiff UTableauReimportProceduralFactory::ApplyReimport(UTableauAsset* TableauAsset, FTableauSourceContents&& SourceContents)
+{
+	// Set Source for reimport
+	const FString SourceFilePath = UAssetImportData::SanitizeImportFilename(CurrentFilename, TableauAsset->GetOutermost());
+	if (TableauAsset->SourceFilePath != SourceFilePath)
+	{
+		TableauAsset->Modify();
+		TableauAsset->SourceFilePath = SourceFilePath;
+	}
+
+	const FTableauReimportDiff Diff = ApplySourceDiff(TableauAsset, MoveTemp(SourceContents));
+
+	UE_LOG(LogTableau, Log, TEXT("Reimported %s from %s: %d elements added, %d modified and %d removed."),
+		*TableauAsset->GetName(), *CurrentFilename, Diff.AddedElements.Num(), Diff.ModifiedElements.Num(), Diff.RemovedElements.Num());
+
+	// Let open editors and previews pick up the changes.
+	if (Diff.HasChanges())
+	{
+		TableauAsset->PostEditChange();
+	}
+
+	OnTableauReimported.Broadcast(TableauAsset, Diff);
+
+	return Diff;
+}
+
+FTableauReimportDiff UTableauReimportProceduralFactory::ApplySourceDiff(UTableauAsset* TableauAsset, FTableauSourceContents&& SourceContents) const
+{
+	FTableauReimportDiff Diff;
+	Diff.bEvaluationModeChanged = (TableauAsset->EvaluationMode != SourceContents.EvaluationMode);
+
+	TArray<FTableauAssetElement>& IncomingElements = SourceContents.Elements;
+	const TArray<FTableauAssetElement>& ExistingElements = TableauAsset->TableauElement;
+
+	// Incoming elements by Id where they have one, and every incoming element by Name. Where keys repeat,
+	// they're matched in order.
+	TMap<FName, TArray<int32>> IncomingById;
+	TMap<FName, TArray<int32>> IncomingByName;
+	IncomingByName.Reserve(IncomingElements.Num());
+	for (int32 Index = 0; Index < IncomingElements.Num(); ++Index)
+	{
+		if (!IncomingElements[Index].SourceId.IsNone())
+		{
+			IncomingById.FindOrAdd(IncomingElements[Index].SourceId).Add(Index);
+		}
+		IncomingByName.FindOrAdd(IncomingElements[Index].Name).Add(Index);
+	}
+
+	// Match the existing elements, without touching the asset so that it isn't dirtied by an unchanged source.
+	TArray<int32> ExistingMatches;
+	TArray<bool> IncomingMatched;
+	TArray<bool> ExistingModified;
+	ExistingMatches.Init(INDEX_NONE, ExistingElements.Num());
+	ExistingModified.Init(false, ExistingElements.Num());
+	IncomingMatched.Init(false, IncomingElements.Num());
+
+	int32 MatchCount = 0;
+	bool bModified = false;
+	bool bSourceIdsChanged = false;
+
+	// Take the next incoming candidate under the key not matched yet. Candidates are only ever matched in
+	// order, so each cursor only moves forward.
+	auto TakeNextMatch = [&IncomingMatched](const TMap<FName, TArray<int32>>& IncomingByKey, TMap<FName, int32>& NextMatches, const FName Key)
+	{
+		const TArray<int32>* Candidates = IncomingByKey.Find(Key);
+		if (Candidates == nullptr)
+		{
+			return (int32)INDEX_NONE;
+		}
+
+		int32& NextMatch = NextMatches.FindOrAdd(Key);
+		while (NextMatch < Candidates->Num() && IncomingMatched[(*Candidates)[NextMatch]])
+		{
+			++NextMatch;
+		}
+		return NextMatch < Candidates->Num() ? (*Candidates)[NextMatch++] : (int32)INDEX_NONE;
+	};
+
+	auto MatchElement = [&](int32 Index, int32 IncomingIndex)
+	{
+		const FTableauAssetElement& ExistingElement = ExistingElements[Index];
+		const FTableauAssetElement& IncomingElement = IncomingElements[IncomingIndex];
+		ExistingMatches[Index] = IncomingIndex;
+		IncomingMatched[IncomingIndex] = true;
+		++MatchCount;
+
+		ExistingModified[Index] = ExistingElement.Name != IncomingElement.Name
+			|| ExistingElement.AssetReference != IncomingElement.AssetReference
+			|| !ExistingElement.LocalTransform.Equals(IncomingElement.LocalTransform, KINDA_SMALL_NUMBER);
+		bModified |= ExistingModified[Index];
+		bSourceIdsChanged |= (ExistingElement.SourceId != IncomingElement.SourceId);
+	};
+
+	// Elements imported with an Id are only ever matched by Id, so Ids and Names can't collide.
+	TMap<FName, int32> NextIdMatches;
+	for (int32 Index = 0; Index < ExistingElements.Num(); ++Index)
+	{
+		if (!ExistingElements[Index].SourceId.IsNone())
+		{
+			const int32 IncomingIndex = TakeNextMatch(IncomingById, NextIdMatches, ExistingElements[Index].SourceId);
+			if (IncomingIndex != INDEX_NONE)
+			{
+				MatchElement(Index, IncomingIndex);
+			}
+		}
+	}
+
+	// Elements imported without an Id are matched by Name with whatever incoming element is left, so that
+	// they adopt the Id once the source starts to provide one.
+	TMap<FName, int32> NextNameMatches;
+	for (int32 Index = 0; Index < ExistingElements.Num(); ++Index)
+	{
+		if (ExistingElements[Index].SourceId.IsNone())
+		{
+			const int32 IncomingIndex = TakeNextMatch(IncomingByName, NextNameMatches, ExistingElements[Index].Name);
+			if (IncomingIndex != INDEX_NONE)
+			{
+				MatchElement(Index, IncomingIndex);
+			}
+		}
+	}
+
+	const bool bElementsChanged = bModified || bSourceIdsChanged || MatchCount != ExistingElements.Num() || MatchCount != IncomingElements.Num();
+	if (!bElementsChanged && !Diff.bEvaluationModeChanged)
+	{
+		return Diff;
+	}
+
+	// Evaluations of the Tableau in flight must complete before anything changes, even just the mode.
+	TableauAsset->PreEditChange(nullptr);
+	TableauAsset->Modify();
+	TableauAsset->EvaluationMode = SourceContents.EvaluationMode;
+
+	if (!bElementsChanged)
+	{
+		return Diff;
+	}
+
+	// Matched elements keep their place and any properties set in the editor. New elements follow them.
+	TArray<FTableauAssetElement> Elements;
+	Elements.Reserve(IncomingElements.Num());
+
+	for (int32 Index = 0; Index < ExistingElements.Num(); ++Index)
+	{
+		if (ExistingMatches[Index] == INDEX_NONE)
+		{
+			Diff.RemovedElements.Add(GetElementKey(ExistingElements[Index]));
+			continue;
+		}
+
+		FTableauAssetElement& Element = Elements.Add_GetRef(ExistingElements[Index]);
+		const FTableauAssetElement& IncomingElement = IncomingElements[ExistingMatches[Index]];
+		Element.SourceId = IncomingElement.SourceId;
+		if (ExistingModified[Index])
+		{
+			// A config captured from the previous asset doesn't apply to another.
+			if (Element.AssetReference != IncomingElement.AssetReference)
+			{
+				Element.bUseConfig = false;
+				Element.ConfigIndex = INDEX_NONE;
+				Element.AssetConfig.Empty();
+				Element.AssetConfigData.Empty();
+			}
+
+			Element.Name = IncomingElement.Name;
+			Element.AssetReference = IncomingElement.AssetReference;
+			Element.LocalTransform = IncomingElement.LocalTransform;
+			Diff.ModifiedElements.Add(Elements.Num() - 1);
+		}
+	}
+
+	for (int32 Index = 0; Index < IncomingElements.Num(); ++Index)
+	{
+		if (!IncomingMatched[Index])
+		{
+			Diff.AddedElements.Add(Elements.Num());
+			Elements.Add(MoveTemp(IncomingElements[Index]));
+		}
+	}
+
+	// Matched elements keep their ConfigIndex, unless their asset changed, so the ConfigTable is kept with them.
+	TableauAsset->SetElements(MoveTemp(Elements));
+
+	return Diff;
+}
+
+FName UTableauReimportProceduralFactory::GetElementKey(const FTableauAssetElement& Element)
+{
+	return Element.SourceId.IsNone() ? Element.Name : Element.SourceId;
+}
@@ -0,0 +1,365 @@
+#include "TableauRegenerationTask.h"
+
+// Engine Includes
+#include "Async/Async.h"
+#include "Editor.h"
+#include "Editor/Transactor.h"
+#include "HAL/IConsoleManager.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+// Local Includes
+#include "TableauEditorModule.h"
+#include "TableauActorManager.h"
+#include "TableauEvaluationContext.h"
+#include "TableauUtils.h"
+
+#define LOCTEXT_NAMESPACE "TableauRegenerationTask"
+
+static TAutoConsoleVariable<int32> CVarTableauRegenerationNodesPerFrame(
+	TEXT("Tableau.RegenerationNodesPerFrame"),
+	250,
+	TEXT("Number of Recipe nodes spawned per frame by a time sliced Tableau regeneration."),
+	ECVF_Default);
+
+TSharedPtr<FTableauRegenerationTask> FTableauRegenerationTask::ActiveTask;
+FTableauRegenerationTask::FOnTaskFinishedDelegate FTableauRegenerationTask::OnTaskFinished;
+
+
+//////////////////////////////////////////////////
+// FTableauRegenerationTask
+
+FTableauRegenerationTask::FTableauRegenerationTask(const TArray<ATableauActor*>& InTableauActors, int32 InNodesPerFrame)
+	: CurrentActorIndex(INDEX_NONE)
+	, CurrentNodeIndex(0)
+	, NodesPerFrame(FMath::Max(InNodesPerFrame, 1))
+	, NodesSpawned(0)
+	, NodesTotal(0)
+	, TransactionIndex(INDEX_NONE)
+{
+	for (ATableauActor* TableauActor : InTableauActors)
+	{
+		TableauActors.Add(TableauActor);
+	}
+}
+
+FTableauRegenerationTask::~FTableauRegenerationTask()
+{
+	if (CurrentEvaluation.IsValid())
+	{
+		CurrentEvaluation.Wait();
+	}
+	CurrentLatentTree.Reset();
+	CurrentContext.Reset();
+}
+
+TSharedPtr<FTableauRegenerationTask> FTableauRegenerationTask::Launch(const TArray<ATableauActor*>& InTableauActors)
+{
+	if (IsTaskRunning())
+	{
+		UE_LOG(LogTableau, Warning, TEXT("A Tableau regeneration is already in progress. Cancel it or wait for it to complete."));
+		return nullptr;
+	}
+
+	TSharedPtr<FTableauRegenerationTask> Task = MakeShareable(new FTableauRegenerationTask(InTableauActors, CVarTableauRegenerationNodesPerFrame.GetValueOnGameThread()));
+	ActiveTask = Task;
+
+	if (!Task->Start())
+	{
+		ActiveTask.Reset();
+		return nullptr;
+	}
+
+	return Task;
+}
+
+bool FTableauRegenerationTask::IsTaskRunning()
+{
+	return ActiveTask.IsValid();
+}
+
+bool FTableauRegenerationTask::Start()
+{
+	BeginSlice();
+
+	if (!BeginNextActor())
+	{
+		// Nothing to regenerate.
+		GEditor->CancelTransaction(TransactionIndex);
+		TransactionIndex = INDEX_NONE;
+		return false;
+	}
+
+	EndSlice();
+
+	FNotificationInfo Info(FText::GetEmpty());
+	Info.bFireAndForget = false;
+	Info.bUseThrobber = true;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("CancelRegeneration", "Cancel"),
+		LOCTEXT("CancelRegenerationTooltip", "Stop regenerating and restore the Tableau Actors to their prior state."),
+		FSimpleDelegate::CreateSP(this, &FTableauRegenerationTask::Cancel),
+		SNotificationItem::CS_Pending));
+
+	Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (TSharedPtr<SNotificationItem> NotificationItem = Notification.Pin())
+	{
+		NotificationItem->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+	UpdateNotification();
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FTableauRegenerationTask::Tick));
+	UTableauAsset::OnTableauElementsChanging.AddSP(this, &FTableauRegenerationTask::OnTableauElementsChanging);
+
+	return true;
+}
+
+void FTableauRegenerationTask::Cancel()
+{
+	Finish(true);
+}
+
+bool FTableauRegenerationTask::Tick(float DeltaTime)
+{
+	// Nothing is spawned, nor any transaction recorded, until the current Actor has been evaluated.
+	if (IsEvaluating())
+	{
+		UpdateNotification();
+		return true;
+	}
+
+	BeginSlice();
+	const bool bMoreToSpawn = SpawnSlice();
+	EndSlice();
+
+	if (!bMoreToSpawn)
+	{
+		Finish(false);
+		return false;
+	}
+
+	UpdateNotification();
+	return true;
+}
+
+bool FTableauRegenerationTask::SpawnSlice()
+{
+	ATableauActor* TableauActor = TableauActors[CurrentActorIndex].Get();
+
+	// The Actor may have been destroyed while we were working on it. Skip to the next one.
+	if (TableauActor == nullptr || TableauActor->IsPendingKillPending())
+	{
+		return BeginNextActor();
+	}
+
+	// The evaluation has just completed.
+	if (CurrentEvaluation.IsValid())
+	{
+		CurrentEvaluation = TFuture<void>();
+		for (const FTableauRecipeNode& RecipeNode : CurrentLatentTree->GetRecipe())
+		{
+			NodesTotal += FTableauUtils::CountRecipeNodes(RecipeNode);
+		}
+	}
+
+	// Gather whole top level nodes until the budget is spent. A node is never split across frames,
+	// so a single deep node may exceed the budget on its own.
+	const TArray<FTableauRecipeNode>& Recipe = CurrentLatentTree->GetRecipe();
+	const int32 FirstNode = CurrentNodeIndex;
+	int32 Budget = NodesPerFrame;
+	while (CurrentNodeIndex < Recipe.Num() && Budget > 0)
+	{
+		const int32 NodeCount = FTableauUtils::CountRecipeNodes(Recipe[CurrentNodeIndex]);
+		Budget -= NodeCount;
+		NodesSpawned += NodeCount;
+		++CurrentNodeIndex;
+	}
+
+	FTableauActorManager Manager(TableauActor);
+	Manager.SpawnInstances(Recipe, FirstNode, CurrentNodeIndex - FirstNode, false);
+
+	if (CurrentNodeIndex >= Recipe.Num())
+	{
+		FinishCurrentActor();
+		return BeginNextActor();
+	}
+
+	return true;
+}
+
+void FTableauRegenerationTask::BeginSlice()
+{
+	TransactionIndex = GEditor->BeginTransaction(LOCTEXT("RegenerateTableauTimeSliced", "Regenerate Tableau"));
+}
+
+void FTableauRegenerationTask::EndSlice()
+{
+	GEditor->EndTransaction();
+	TransactionIndex = INDEX_NONE;
+
+	SliceTransactions.Add(GEditor->Trans->GetUndoContext(false).TransactionId);
+}
+
+bool FTableauRegenerationTask::BeginNextActor()
+{
+	CurrentEvaluation = TFuture<void>();
+	CurrentLatentTree.Reset();
+	CurrentContext.Reset();
+
+	while (++CurrentActorIndex < TableauActors.Num())
+	{
+		ATableauActor* TableauActor = TableauActors[CurrentActorIndex].Get();
+		if (TableauActor == nullptr || TableauActor->IsPendingKillPending())
+		{
+			continue;
+		}
+
+		UTableauComponent* TableauComponent = TableauActor->GetTableauComponent();
+		const UTableauAsset* TableauAsset = TableauComponent->GetTableau();
+
+		// If the Tableau Asset is not set, there is no point proceeding.
+		if (TableauAsset == nullptr)
+		{
+			continue;
+		}
+
+		TableauComponent->Modify(true);
+
+		// Everything the evaluation reads is loaded here, on the game thread.
+		CurrentContext = MakeShareable(new FTableauEvaluationContext(TableauActor->GetWorld()));
+		CurrentContext->AddTableau(TableauAsset);
+
+		FTableauActorManager Manager(TableauActor);
+		TSharedPtr<FTableauFilterSampler> Filter = Manager.GatherFilters(TableauComponent, CurrentContext.Get());
+		Manager.PrepareForRegeneration();
+
+		CurrentLatentTree = Manager.CreateLatentTree(Filter, CurrentContext);
+		CurrentNodeIndex = 0;
+		NodesSpawned = 0;
+		NodesTotal = 0;
+
+		// The task only borrows the latent tree, which is kept until the evaluation has completed.
+		FTableauLatentTree* LatentTree = CurrentLatentTree.Get();
+		const int32 Seed = TableauComponent->Seed;
+		TUniqueFunction<void()> Evaluate = [LatentTree, Seed]()
+			{
+				LatentTree->EvaluateLatentTree(Seed);
+			};
+
+		// Filters that trace the scene or read the landscape are only safe on the game thread.
+		if (!Filter.IsValid() || Filter->IsThreadSafe())
+		{
+			CurrentEvaluation = Async(EAsyncExecution::ThreadPool, MoveTemp(Evaluate));
+		}
+		else
+		{
+			Evaluate();
+
+			TPromise<void> Completed;
+			Completed.SetValue();
+			CurrentEvaluation = Completed.GetFuture();
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void FTableauRegenerationTask::FinishCurrentActor()
+{
+	if (ATableauActor* TableauActor = TableauActors[CurrentActorIndex].Get())
+	{
+		FTableauActorManager Manager(TableauActor);
+		Manager.SpawnFoliage(CurrentLatentTree->GetFoliages());
+		Manager.FinalizeRegeneration();
+
+		// Everything was spawned inside the task's transactions.
+		TableauActor->GetTableauComponent()->RecordRegeneration(true);
+	}
+}
+
+bool FTableauRegenerationTask::IsEvaluating() const
+{
+	return CurrentEvaluation.IsValid() && !CurrentEvaluation.IsReady();
+}
+
+void FTableauRegenerationTask::OnTableauElementsChanging(const UTableauAsset* ChangingTableau)
+{
+	if (CurrentEvaluation.IsValid())
+	{
+		CurrentEvaluation.Wait();
+	}
+}
+
+void FTableauRegenerationTask::Finish(bool bCancelled)
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	UTableauAsset::OnTableauElementsChanging.RemoveAll(this);
+
+	// Let the evaluation in flight finish before releasing what it references.
+	if (CurrentEvaluation.IsValid())
+	{
+		CurrentEvaluation.Wait();
+		CurrentEvaluation = TFuture<void>();
+	}
+	CurrentLatentTree.Reset();
+	CurrentContext.Reset();
+
+	if (bCancelled)
+	{
+		// Roll back the partial regeneration, stopping at any edit made by the user in the meantime.
+		// The rolled back transactions may not be redone.
+		while (SliceTransactions.Num() > 0 && GEditor->Trans->GetUndoContext().TransactionId == SliceTransactions.Last())
+		{
+			GEditor->UndoTransaction(false);
+			SliceTransactions.Pop();
+		}
+
+		if (SliceTransactions.Num() > 0)
+		{
+			UE_LOG(LogTableau, Warning, TEXT("The scene was edited during the Tableau regeneration. %d step(s) of the regeneration remain in the undo history."), SliceTransactions.Num());
+		}
+	}
+	SliceTransactions.Empty();
+
+	GEngine->ForceGarbageCollection(true);
+
+	if (TSharedPtr<SNotificationItem> NotificationItem = Notification.Pin())
+	{
+		NotificationItem->SetText(bCancelled ? LOCTEXT("RegenerationCancelled", "Tableau regeneration cancelled") : LOCTEXT("RegenerationComplete", "Tableau regeneration complete"));
+		NotificationItem->SetCompletionState(bCancelled ? SNotificationItem::CS_Fail : SNotificationItem::CS_Success);
+		NotificationItem->ExpireAndFadeout();
+	}
+	Notification.Reset();
+
+	// Releasing the active task may destroy this one, so nothing of it is touched afterwards.
+	ActiveTask.Reset();
+	OnTaskFinished.Broadcast();
+}
+
+void FTableauRegenerationTask::UpdateNotification()
+{
+	if (TSharedPtr<SNotificationItem> NotificationItem = Notification.Pin())
+	{
+		if (IsEvaluating())
+		{
+			NotificationItem->SetText(FText::Format(LOCTEXT("RegenerationEvaluating", "Evaluating Tableau {0} of {1}"),
+				FText::AsNumber(CurrentActorIndex + 1),
+				FText::AsNumber(TableauActors.Num())));
+			return;
+		}
+
+		NotificationItem->SetText(FText::Format(LOCTEXT("RegenerationProgress", "Regenerating Tableau {0} of {1}: {2} / {3} elements"),
+			FText::AsNumber(CurrentActorIndex + 1),
+			FText::AsNumber(TableauActors.Num()),
+			FText::AsNumber(NodesSpawned),
+			FText::AsNumber(NodesTotal)));
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
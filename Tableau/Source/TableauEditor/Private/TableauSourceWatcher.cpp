@@ -0,0 +1,262 @@
+#include "TableauSourceWatcher.h"
+
+// Engine Includes
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "DirectoryWatcherModule.h"
+#include "EditorFramework/AssetImportData.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+// Local Includes
+#include "TableauAsset.h"
+#include "TableauEditorModule.h"
+
+static TAutoConsoleVariable<int32> CVarTableauAutoReimport(
+	TEXT("Tableau.AutoReimport"),
+	0,
+	TEXT("Reimport Tableau Assets automatically when their TAB or TABB source files are written."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTableauAutoReimportDelay(
+	TEXT("Tableau.AutoReimportDelay"),
+	0.5f,
+	TEXT("Seconds a Tableau source file must go unwritten before it is automatically reimported."),
+	ECVF_Default);
+
+// constants
+static const float WatchRefreshInterval = 2.0f;
+
+
+//////////////////////////////////////////////////
+// FTableauSourceWatcher
+
+FTableauSourceWatcher::FTableauSourceWatcher(const FOnSourcesReimported& InOnSourcesReimported)
+	: OnSourcesReimported(InOnSourcesReimported)
+	, TimeSinceRefresh(TNumericLimits<float>::Max())
+{
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FTableauSourceWatcher::Tick));
+}
+
+FTableauSourceWatcher::~FTableauSourceWatcher()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	// The reads in flight reference their factories and contents.
+	for (FSourceRead& SourceRead : SourceReads)
+	{
+		SourceRead.Future.Wait();
+	}
+	SourceReads.Empty();
+
+	StopWatching();
+}
+
+bool FTableauSourceWatcher::Tick(float DeltaTime)
+{
+	if (CVarTableauAutoReimport.GetValueOnGameThread() == 0)
+	{
+		if (WatchedDirectories.Num() > 0)
+		{
+			StopWatching();
+		}
+
+		// Refresh straight away when re-enabled.
+		TimeSinceRefresh = TNumericLimits<float>::Max();
+		return true;
+	}
+
+	TimeSinceRefresh += DeltaTime;
+	if (TimeSinceRefresh >= WatchRefreshInterval)
+	{
+		TimeSinceRefresh = 0.0f;
+		RefreshWatches();
+	}
+
+	StartSourceReads();
+	FinishSourceReads();
+
+	return true;
+}
+
+void FTableauSourceWatcher::RefreshWatches()
+{
+	WatchedSources.Reset();
+
+	for (TObjectIterator<UTableauAsset> It; It; ++It)
+	{
+		UTableauAsset* TableauAsset = *It;
+		if (TableauAsset->IsTemplate() || TableauAsset->SourceFilePath.IsEmpty())
+		{
+			continue;
+		}
+
+		const FString Filename = NormalizeSourceFilename(UAssetImportData::ResolveImportFilename(TableauAsset->SourceFilePath, TableauAsset->GetOutermost()));
+		WatchedSources.FindOrAdd(Filename).Add(TableauAsset);
+	}
+
+	TSet<FString> Directories;
+	for (const TPair<FString, TArray<TWeakObjectPtr<UTableauAsset>>>& WatchedSource : WatchedSources)
+	{
+		Directories.Add(FPaths::GetPath(WatchedSource.Key));
+	}
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (DirectoryWatcher == nullptr)
+	{
+		return;
+	}
+
+	for (auto It = WatchedDirectories.CreateIterator(); It; ++It)
+	{
+		if (!Directories.Contains(It.Key()))
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(It.Key(), It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const FString& Directory : Directories)
+	{
+		if (!WatchedDirectories.Contains(Directory))
+		{
+			FDelegateHandle Handle;
+			if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Directory, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FTableauSourceWatcher::OnDirectoryChanged), Handle))
+			{
+				WatchedDirectories.Add(Directory, Handle);
+			}
+			else
+			{
+				UE_LOG(LogTableau, Warning, TEXT("Unable to watch %s for changes to Tableau sources."), *Directory);
+			}
+		}
+	}
+}
+
+void FTableauSourceWatcher::StopWatching()
+{
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			for (const TPair<FString, FDelegateHandle>& WatchedDirectory : WatchedDirectories)
+			{
+				DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory.Key, WatchedDirectory.Value);
+			}
+		}
+	}
+
+	WatchedDirectories.Empty();
+	WatchedSources.Empty();
+	PendingSources.Empty();
+}
+
+void FTableauSourceWatcher::OnDirectoryChanged(const TArray<FFileChangeData>& FileChanges)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (const FFileChangeData& FileChange : FileChanges)
+	{
+		if (FileChange.Action == FFileChangeData::FCA_Removed)
+		{
+			continue;
+		}
+
+		// Each write postpones the read, so a burst of writes is read once.
+		const FString Filename = NormalizeSourceFilename(FileChange.Filename);
+		if (WatchedSources.Contains(Filename))
+		{
+			PendingSources.Add(Filename, Now);
+		}
+	}
+}
+
+void FTableauSourceWatcher::StartSourceReads()
+{
+	const double SettledTime = FPlatformTime::Seconds() - FMath::Max(CVarTableauAutoReimportDelay.GetValueOnGameThread(), 0.0f);
+
+	for (auto It = PendingSources.CreateIterator(); It; ++It)
+	{
+		const FString& Filename = It.Key();
+		if (It.Value() > SettledTime)
+		{
+			continue;
+		}
+
+		// A source written while it was being read is read again once that read completes.
+		const bool bReading = SourceReads.ContainsByPredicate([&Filename](const FSourceRead& SourceRead)
+			{
+				return SourceRead.Filename == Filename;
+			});
+		if (bReading)
+		{
+			continue;
+		}
+
+		FSourceRead& SourceRead = SourceReads.AddDefaulted_GetRef();
+		SourceRead.Filename = Filename;
+		SourceRead.Factory.Reset(NewObject<UTableauReimportProceduralFactory>());
+		SourceRead.Factory->SetCurrentFilename(Filename);
+		SourceRead.Contents = MakeShareable(new FTableauSourceContents);
+
+		// Reading the source touches no UObjects.
+		const UTableauReimportProceduralFactory* Factory = SourceRead.Factory.Get();
+		FTableauSourceContents* Contents = SourceRead.Contents.Get();
+		SourceRead.Future = Async(EAsyncExecution::ThreadPool, [Factory, Contents]()
+			{
+				return Factory->ReadSourceFile(*Contents);
+			});
+
+		It.RemoveCurrent();
+	}
+}
+
+void FTableauSourceWatcher::FinishSourceReads()
+{
+	TArray<UTableauAsset*> ReimportedAssets;
+
+	for (int32 Index = 0; Index < SourceReads.Num();)
+	{
+		FSourceRead& SourceRead = SourceReads[Index];
+		if (!SourceRead.Future.IsReady())
+		{
+			++Index;
+			continue;
+		}
+
+		const TArray<TWeakObjectPtr<UTableauAsset>>* TableauAssets = WatchedSources.Find(SourceRead.Filename);
+		if (SourceRead.Future.Get() && TableauAssets)
+		{
+			for (int32 AssetIndex = 0; AssetIndex < TableauAssets->Num(); ++AssetIndex)
+			{
+				UTableauAsset* TableauAsset = (*TableauAssets)[AssetIndex].Get();
+				if (TableauAsset == nullptr)
+				{
+					continue;
+				}
+
+				// Several assets may share a source. The last one may take the contents.
+				FTableauSourceContents Contents = (AssetIndex == TableauAssets->Num() - 1) ? MoveTemp(*SourceRead.Contents) : *SourceRead.Contents;
+				if (SourceRead.Factory->ApplyReimport(TableauAsset, MoveTemp(Contents)).HasChanges())
+				{
+					ReimportedAssets.AddUnique(TableauAsset);
+				}
+			}
+		}
+
+		SourceReads.RemoveAt(Index);
+	}
+
+	if (ReimportedAssets.Num() > 0)
+	{
+		OnSourcesReimported.ExecuteIfBound(ReimportedAssets);
+	}
+}
+
+FString FTableauSourceWatcher::NormalizeSourceFilename(const FString& Filename)
+{
+	FString NormalizedFilename = FPaths::ConvertRelativePathToFull(Filename);
+	FPaths::NormalizeFilename(NormalizedFilename);
+	return NormalizedFilename;
+}
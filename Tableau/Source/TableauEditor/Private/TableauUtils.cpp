@@ -9,11 +9,13 @@
 #include "AssetSelection.h"
 #include "ScopedTransaction.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "FoliageType_InstancedStaticMesh.h"
 
 // Local Includes
 #include "TableauEditorModule.h"
 #include "TableauActorManager.h"
 #include "TableauActorFactory.h"
+#include "TableauActorConfig.h"
 
 ATableauActor* FTableauUtils::GetFirstTableauParentActor(AActor* InActor)
 {
@@ -33,62 +35,101 @@ ATableauActor* FTableauUtils::GetFirstTableauParentActor(AActor* InActor)
 	return FirstTableauParentActor;
 }
 
-TArray<TWeakObjectPtr<AActor>> FTableauUtils::SpawnInstances(ATableauActor* OwningActor, const FTransform& TableauSpace, const TArray<FTableauRecipeNode>& Recipe, UTableauComponent* TableauComponent, FTableauInstanceTracker* CurrTracker, bool bIsPreview)
+TArray<TWeakObjectPtr<AActor>> FTableauUtils::SpawnInstances(ATableauActor* OwningActor, const FTransform& TableauSpace, const TArray<FTableauRecipeNode>& Recipe, UTableauComponent* TableauComponent, int32 ParentInstance, bool bIsPreview)
 {
 
 	TArray<TWeakObjectPtr<AActor>> SpawnedPreviewActors;
 	
 	for (const FTableauRecipeNode& RecipeNode : Recipe)
 	{
-	
-		AActor* SpawnedActor = nullptr;
+		SpawnedPreviewActors.Append(SpawnInstance(OwningActor, TableauSpace, RecipeNode, TableauComponent, ParentInstance, bIsPreview));
+	}
+
+	return SpawnedPreviewActors;
+
+}
+
+TArray<TWeakObjectPtr<AActor>> FTableauUtils::SpawnInstance(ATableauActor* OwningActor, const FTransform& TableauSpace, const FTableauRecipeNode& RecipeNode, UTableauComponent* TableauComponent, int32 ParentInstance, bool bIsPreview)
+{
+
+	TArray<TWeakObjectPtr<AActor>> SpawnedPreviewActors;
 
-		if (RecipeNode.bUseConfig)
+	AActor* SpawnedActor = nullptr;
+
+	if (RecipeNode.bUseConfig)
+	{
+		const UTableauAsset* ConfigOwner = RecipeNode.ConfigOwner.Get();
+		const int32 ConfigIndex = ConfigOwner ? ConfigOwner->FindConfigIndex(RecipeNode.ConfigHash) : INDEX_NONE;
+		SpawnedActor = SpawnConfiguredActor(OwningActor->GetWorld(), ConfigOwner, ConfigIndex, RecipeNode.LocalTransform * TableauSpace, RecipeNode.Name);
+	}
+	else
+	{
+		if (RecipeNode.AssetReference.IsValid())
 		{
-			SpawnedActor = PasteActor(OwningActor->GetWorld(), RecipeNode.AssetConfig, RecipeNode.LocalTransform * TableauSpace, RecipeNode.Name);
+			SpawnComponent(OwningActor, RecipeNode.AssetReference.Get(), RecipeNode.LocalTransform, RecipeNode.Name);
 		}
-		else
+	}
+	
+	if (SpawnedActor)
+	{
+
+		// Add a tag informing the editor that this actor is a Tableau element.
+		SpawnedActor->Tags.Add(TableauActorConstants::TABLEAU_ELEMENT_TAG);
+		
+		// Add a tag to signify the actors inclusion in snap operations.
+		if (RecipeNode.bSnapToFloor)
 		{
-			if (RecipeNode.AssetReference.IsValid())
-			{
-				SpawnComponent(OwningActor, RecipeNode.AssetReference.Get(), RecipeNode.LocalTransform, RecipeNode.Name);
-			}
+			SpawnedActor->Tags.Add(TableauActorConstants::TABLEAU_SNAPTOFLOOR_TAG);
 		}
-		
-		if (SpawnedActor)
+
+		if (bIsPreview)
 		{
+			SpawnedActor->Tags.Add(TableauActorConstants::TABLEAU_PREVIEW_TAG);
+			SpawnedActor->SetActorEnableCollision(false);
+		}
 
-			// Add a tag informing the editor that this actor is a Tableau element.
-			SpawnedActor->Tags.Add(TableauActorConstants::TABLEAU_ELEMENT_TAG);
-			
-			// Add a tag to signify the actors inclusion in snap operations.
-			if (RecipeNode.bSnapToFloor)
-			{
-				SpawnedActor->Tags.Add(TableauActorConstants::TABLEAU_SNAPTOFLOOR_TAG);
-			}
+		TWeakObjectPtr<AActor> SpawnedActorWeakPtr(SpawnedActor);
+		SpawnedPreviewActors.Add(SpawnedActorWeakPtr);
+		const int32 SpawnedInstance = TableauComponent->RegisterInstance(SpawnedActor, ParentInstance);
 
-			if (bIsPreview)
-			{
-				SpawnedActor->Tags.Add(TableauActorConstants::TABLEAU_PREVIEW_TAG);
-				SpawnedActor->SetActorEnableCollision(false);
-			}
+		// Spawn subordinate actors
+		if (RecipeNode.SubRecipe.Num() > 0)
+		{
+			SpawnedPreviewActors.Append(SpawnInstances(OwningActor, TableauSpace, RecipeNode.SubRecipe, TableauComponent, SpawnedInstance, bIsPreview));
+		}
 
-			TWeakObjectPtr<AActor> SpawnedActorWeakPtr(SpawnedActor);
-			SpawnedPreviewActors.Add(SpawnedActorWeakPtr);
-			TableauComponent->RegisterInstance(SpawnedActor, CurrTracker);
+	}
 
-			// Spawn subordinate actors
-			if (RecipeNode.SubRecipe.Num() > 0)
-			{
-				SpawnedPreviewActors.Append(SpawnInstances(OwningActor, TableauSpace, RecipeNode.SubRecipe, TableauComponent, TableauComponent->GetLastInstanceTracker(), bIsPreview));
-			}
+	return SpawnedPreviewActors;
 
-		}
+}
 
+int32 FTableauUtils::CountRecipeNodes(const FTableauRecipeNode& RecipeNode)
+{
+	int32 NodeCount = 1;
+	for (const FTableauRecipeNode& SubRecipeNode : RecipeNode.SubRecipe)
+	{
+		NodeCount += CountRecipeNodes(SubRecipeNode);
 	}
+	return NodeCount;
+}
 
-	return SpawnedPreviewActors;
+AActor* FTableauUtils::SpawnConfiguredActor(UWorld* InWorld, const UTableauAsset* TableauAsset, int32 ConfigIndex, const FTransform& Xform, const FName& Name)
+{
+	ETableauConfigFormat::Type Format;
+	const TArray<uint8>* Config = TableauAsset ? TableauAsset->FindConfig(ConfigIndex, Format) : nullptr;
+	if (Config == nullptr)
+	{
+		return nullptr;
+	}
 
+	if (Format == ETableauConfigFormat::Text)
+	{
+		FUTF8ToTCHAR TextConfig((const ANSICHAR*)Config->GetData(), Config->Num());
+		return PasteActor(InWorld, FString(TextConfig.Length(), TextConfig.Get()), Xform, Name);
+	}
+
+	return FTableauActorConfig::SpawnActor(InWorld, *Config, Xform, Name);
 }
 
 AActor* FTableauUtils::PasteActor(UWorld* InWorld, const FString& Config, const FTransform& Xform, const FName& Name)
@@ -310,7 +351,12 @@ void FTableauUtils::FillTableauAssetElements(UTableauAsset* InAsset, const TArra
 
 		const FTransform WorldToLocal = LocalToWorld.Inverse();
 
-		UWorld* World = SelectedActors[0]->GetWorld();
+		TArray<FTableauAssetElement> Elements;
+		Elements.Reserve(SelectedActors.Num());
+
+		// Actors whose config is captured, and the element each fills.
+		TArray<AActor*> CapturedActors;
+		TArray<int32> CapturedElements;
 
 		for (int32 index = 0; index < SelectedActors.Num(); ++index)
 		{
@@ -320,50 +366,46 @@ void FTableauUtils::FillTableauAssetElements(UTableauAsset* InAsset, const TArra
 			TArray<UObject*> RefObjects;
 			if (Sel->GetReferencedContentObjects(RefObjects))
 			{
-				if (RefObjects.Num() > 0)
+				const FName Name = FName(*Sel->GetActorLabel());
+				const FTransform LocalTransform = Sel->GetActorTransform() * WorldToLocal;
+
+				// This is possibly a Tableau actor
+				ATableauActor* TableauActor = Cast<ATableauActor>(Sel);
+				if (TableauActor && RefObjects.Num() > 0)
 				{
-					// This is possibly a Tableau actor
-					if (ATableauActor* TableauActor = Cast<ATableauActor>(Sel))
-					{
-						const UTableauComponent* TableauComp = TableauActor->GetTableauComponent();
-						const FSoftObjectPath AssetReference(TableauComp->GetTableau());
-						const FString AssetConfig; // We don't require config for a Tableau Asset
-						const FName Name = FName(*Sel->GetActorLabel());
-						const FTransform LocalTransform = Sel->GetActorTransform() * WorldToLocal;
-						const uint32 Seed = TableauComp->Seed;
-
-						InAsset->AddElement(Name, AssetReference, AssetConfig, LocalTransform, Seed);
-					}
-					else
-					{
-						const FSoftObjectPath AssetReference = RefObjects[0];
-						const FName Name = FName(*Sel->GetActorLabel());
-						const FTransform LocalTransform = Sel->GetActorTransform();
-
-						Sel->SetActorTransform(FTransform::Identity);
-						FString AssetConfig;
-						StoreActorAsString(World, Sel, &AssetConfig);
-						Sel->SetActorTransform(LocalTransform);
-
-						InAsset->AddElement(Name, AssetReference, AssetConfig, LocalTransform * WorldToLocal);
-					}	
+					const UTableauComponent* TableauComp = TableauActor->GetTableauComponent();
+					const FSoftObjectPath AssetReference(TableauComp->GetTableau());
+					const FString AssetConfig; // We don't require config for a Tableau Asset
+					const uint32 Seed = TableauComp->Seed;
+
+					Elements.Emplace(Name, AssetReference, AssetConfig, LocalTransform, Seed);
 				}
 				else
 				{
-					// No referenced content, which means it's a primitive, like a light.
-					const FSoftObjectPath AssetReference(Sel->GetClass());
-					const FName Name = FName(*Sel->GetActorLabel());
-					const FTransform LocalTransform = Sel->GetActorTransform();
-
-					Sel->SetActorTransform(FTransform::Identity);
-					FString AssetConfig;
-					StoreActorAsString(World, Sel, &AssetConfig);
-					Sel->SetActorTransform(LocalTransform);
+					// No referenced content means it's a primitive, like a light.
+					const FSoftObjectPath AssetReference = (RefObjects.Num() > 0) ? FSoftObjectPath(RefObjects[0]) : FSoftObjectPath(Sel->GetClass());
 
-					InAsset->AddElement(Name, AssetReference, AssetConfig, LocalTransform * WorldToLocal);
+					CapturedActors.Add(Sel);
+					CapturedElements.Add(Elements.Emplace(Name, AssetReference, FString(), LocalTransform, 0));
 				}
 			}
 		}
+
+		// Capture every config in one pass. The root transform is replaced when the element is spawned, so
+		// the actors needn't be moved to the origin, nor selected, first.
+		TArray<TArray<uint8>> Configs;
+		FTableauActorConfig::CaptureActors(CapturedActors, Configs);
+
+		for (int32 index = 0; index < CapturedActors.Num(); ++index)
+		{
+			if (Configs[index].Num() == 0)
+			{
+				UE_LOG(LogTableau, Warning, TEXT("Unable to capture the config of %s."), *CapturedActors[index]->GetActorLabel());
+			}
+			Elements[CapturedElements[index]].ConfigIndex = InAsset->AddConfig(Configs[index], ETableauConfigFormat::Binary);
+		}
+
+		InAsset->AddElements(MoveTemp(Elements));
 	}
 
 }
@@ -381,48 +423,15 @@ void FTableauUtils::StoreActorAsString(UWorld* InWorld, AActor* InActor, FString
 
 void FTableauUtils::JitterTransform(uint32 Seed, float MinScale, float MaxScale, bool bSpinZAxis, FTransform& Transform)
 {
-	
-	// Set the transform to origin for application of jitter.
-	const FVector Location = Transform.GetLocation();
-	Transform.SetLocation(FVector::ZeroVector);
-
-	// Apply scale jitter
-	if (FMath::IsNearlyZero(abs(MinScale-MaxScale)))
-	{
-		Transform.MultiplyScale3D(FVector(MinScale,MinScale,MinScale));
-	}
-	else
-	{
-		static const int32 SeedOffsetForScale = FTableauUtils::NextSeed(Seed);
-		FRandomStream Stream(Seed+ SeedOffsetForScale);
-
-		const float Scale = Stream.FRand()*(MaxScale-MinScale) + MinScale;
-		Transform.MultiplyScale3D(FVector(Scale, Scale, Scale));
-	}
-
-	// Rotation may be assigned a random spin about Z axis
-	if (bSpinZAxis)
-	{
-		static const int32 SeedOffsetForRotation = FTableauUtils::NextSeed(FTableauUtils::NextSeed(Seed));
-		FRandomStream Stream(Seed + SeedOffsetForRotation);
-
-		const FQuat Rotate(FVector::UpVector, Stream.FRand() * 2.0 * PI);
-		Transform *= Rotate;
-	}
-
-	// Bring transform back to position.
-	Transform.AddToTranslation(Location);
+	FTableauEvaluationUtils::JitterTransform(Seed, MinScale, MaxScale, bSpinZAxis, Transform);
 }
 
 bool FTableauUtils::TraceToWorld(FTransform& Xform, const UWorld* InWorld, const FFloatInterval& GroundSlopeAngle, AActor* IgnoredActor=nullptr, bool bAlignToNormal = false)
 {
-	// We bracket our floor traces by +- 10m.
-	const float SnapToFloorBound = 1000.0;
-
 	// Establish vertical ray along which the trace will be conducted.
 	FVector InitialLocation = Xform.GetTranslation();
-	FVector TraceStart = InitialLocation + FVector(0.0, 0.0, SnapToFloorBound);
-	FVector TraceEnd = InitialLocation - FVector(0.0, 0.0, SnapToFloorBound);
+	FVector TraceStart = InitialLocation + FVector(0.0, 0.0, TableauSnapConstants::SnapToFloorBound);
+	FVector TraceEnd = InitialLocation - FVector(0.0, 0.0, TableauSnapConstants::SnapToFloorBound);
 
 	FHitResult HitResult;
 
@@ -467,12 +476,7 @@ bool FTableauUtils::TraceToWorld(FTransform& Xform, const UWorld* InWorld, const
 
 int32 FTableauUtils::NextSeed(int32 Seed)
 {
-	FRandomStream Stream(Seed);
-
-	// Advance the seed
-	Stream.GetUnsignedInt();
-
-	return Stream.GetCurrentSeed();
+	return FTableauEvaluationUtils::NextSeed(Seed);
 }
 
 
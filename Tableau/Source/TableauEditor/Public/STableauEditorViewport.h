@@ -16,6 +16,11 @@ class ITableauEditor;
 class SVerticalBox;
 class UTableauAsset;
 class UTableauComponent;
+class UTableauHISMComponent;
+class FTableauPreviewEvaluator;
+struct FTableauPreviewResult;
+class UStaticMesh;
+class UFoliageType;
 
 
 
@@ -48,18 +53,60 @@ public:
 	class FTableauEditorViewportClient& GetViewportClient();
 	TSharedRef<FAdvancedPreviewScene> GetPreviewScene() { return PreviewScene.ToSharedRef(); }
 	
+	// Evaluate the Tableau again, eg. following an edit. The preview is swapped once the evaluation completes.
 	void UpdatePreviewTableau(UTableauAsset* InTableau, bool bResetCamera = true);
 
+	// Does the preview express the Tableau, either as the previewed Tableau or nested within it?
+	bool IsPreviewingTableau(const UTableauAsset* InTableau) const;
+
+	// Preview another seed. Nearby seeds are evaluated speculatively in the background, so that scrubbing
+	// the seed swaps between cached results.
+	int32 GetPreviewSeed() const;
+	void SetPreviewSeed(int32 InSeed);
+
+	// In grid mode, the seeds following the current seed are laid out in a grid of cells and evaluated in
+	// parallel. Selecting a cell applies its seed and returns to previewing that seed alone.
+	ECheckBoxState IsGridPreview() const;
+	void SetGridPreview(ECheckBoxState InState);
+	int32 GetGridColumns() const;
+	void SetGridColumns(int32 InColumns);
+	int32 GetGridRows() const;
+	void SetGridRows(int32 InRows);
+
+	// Select the grid cell under a click, given the ray through the clicked pixel. Returns false if no
+	// cell was hit.
+	bool SelectGridCell(const FVector& RayOrigin, const FVector& RayDirection);
+
+	// SWidget interface
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+	// End of SWidget interface
+
 protected:
 	// SEditorViewport interface 
 	virtual TSharedRef<FEditorViewportClient> MakeEditorViewportClient() override;
 	virtual EVisibility OnGetViewportContentVisibility() const override;
+	virtual void PopulateViewportOverlays(TSharedRef<SOverlay> Overlay) override;
 	// End SEditorViewport interface 
 
 private:
 	//Determines the visibility of the viewport.
 	bool IsVisible() const override;
 
+	// Apply the result for the current seed if it's cached, otherwise request it.
+	void RequestPreview();
+	void ApplyPreviewResult(const FTableauPreviewResult& Result);
+
+	void UpdateGridPreview();
+	void ApplyGridPreview(const TArray<TSharedPtr<const FTableauPreviewResult>>& Results);
+	FVector GetGridCellOrigin(int32 Cell) const;
+
+	void ClearPreviewComponents();
+	FBox AddPreviewComponent(UObject* Asset, const FTransform& Transform);
+
+	// Update the instanced components to express the given instances, creating and destroying
+	// components only for sources that were added or removed.
+	void UpdateInstancedComponents(const TMap<TPair<UStaticMesh*, UFoliageType*>, TArray<FTransform>>& InstanceTransforms);
+
 private:
 	// The parent tab where this viewport resides
 	TWeakPtr<SDockTab> ParentTab;
@@ -79,7 +126,32 @@ private:
 	// Seed value used to evaluate current Tableau
 	int32 Seed;
 
-	// Components owned by viewport
+	// Direction the seed was last scrubbed in, +1 or -1.
+	int32 ScrubDirection;
+
+	// Is the preview showing the current seed of the current Tableau?
+	bool bPreviewCurrent;
+
+	// Focus the camera on the next preview applied.
+	bool bResetCameraOnPreview;
+
+	bool bGridPreview;
+	int32 GridColumns;
+	int32 GridRows;
+
+	// Number of grid cells expressed by the current preview, or INDEX_NONE if the grid has changed.
+	int32 GridCellsApplied;
+
+	// Distance between the cell origins.
+	float GridSpacing;
+
+	TUniquePtr<FTableauPreviewEvaluator> PreviewEvaluator;
+
+	// Instanced components previewing Static Meshes and Foliage, one per source. These are updated in place
+	// when the preview changes.
+	TArray<UTableauHISMComponent*> InstancedComponents;
+
+	// Components owned by viewport previewing any other assets
 	TArray<USceneComponent*> TableauComponents;
 
 	// The currently selected view mode.
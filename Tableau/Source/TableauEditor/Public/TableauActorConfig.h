@@ -0,0 +1,35 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class AActor;
+class UWorld;
+
+
+/*
+* FTableauActorConfig captures the configuration of placed actors in a compact binary form, and spawns actors
+* from it, as an alternative to copying them to the clipboard as T3D text.
+*
+* A capture records the actor's class and, for the actor and each of its components, only the properties that
+* differ from their archetype. References to the actor and its own components are stored relative to the actor,
+* so that they resolve to the spawned actor's components; references to other actors in the level are dropped,
+* and references to assets are stored by path. Components added to the actor instance are recreated on spawn.
+* Data serialized outside the reflected properties, such as painted vertex colors, is kept in the CustomProperties
+* text form T3D uses.
+*
+* Capturing touches neither the editor selection nor the captured actors, so many actors may be captured in one
+* pass.
+*/
+struct TABLEAUEDITOR_API FTableauActorConfig
+{
+	// Capture each actor. OutConfigs is parallel to Actors; a config is empty if its actor couldn't be captured.
+	static void CaptureActors(const TArray<AActor*>& Actors, TArray<TArray<uint8>>& OutConfigs);
+
+	static bool CaptureActor(AActor* Actor, TArray<uint8>& OutConfig);
+
+	// Spawn an actor into the World's current level from a captured config. Returns nullptr if the config is
+	// malformed or its class can't be found.
+	static AActor* SpawnActor(UWorld* World, const TArray<uint8>& Config, const FTransform& Xform, const FName& Name);
+};
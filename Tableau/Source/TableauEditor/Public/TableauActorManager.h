@@ -9,6 +9,10 @@
 #include "TableauUtils.h"
 #include "TableauFilter.h"
 
+// Forward Declares
+class FTableauEvaluationContext;
+class UTableauBakedRecipe;
+
 /*
 * FTableauActorManager contains most of the Tableau logic. It is responsible for evaluating Tableau and 
 * spawning actors for it. It is responsible for maintaining current state in the Tableau Component.
@@ -27,6 +31,22 @@ public:
 	// and update the Component registry.
 	void UpdateInstances(bool bIsPreview);
 
+	// Regenerate several Tableau Actors as a batch. Assets, exclusion volumes and landscape weightmaps are loaded
+	// once into a shared evaluation context, the latent trees are evaluated in parallel, and the spawned results
+	// are recorded in a single transaction followed by a single garbage collection.
+	static void UpdateInstances(const TArray<ATableauActor*>& TableauActors);
+
+	// The phases of UpdateInstances, exposed for callers that spread regeneration across several frames.
+	// EvaluateLatentTree expands the Tableau into a Recipe, PrepareForRegeneration validates tracking and
+	// destroys the current Instances, SpawnInstances spawns a slice of the top level Recipe, and
+	// FinalizeRegeneration snaps, reselects and refreshes bounds.
+	TUniquePtr<FTableauLatentTree> EvaluateLatentTree(TSharedPtr<FTableauFilterSampler> Filter) const;
+	TUniquePtr<FTableauLatentTree> CreateLatentTree(TSharedPtr<FTableauFilterSampler> Filter, TSharedPtr<const FTableauEvaluationContext> Context=nullptr) const;
+	void PrepareForRegeneration();
+	void SpawnInstances(const TArray<FTableauRecipeNode>& Recipe, int32 FirstNode, int32 NodeCount, bool bIsPreview);
+	void SpawnFoliage(TMap<UFoliageType*, TUniquePtr<FTableauFoliage>>& Foliages);
+	void FinalizeRegeneration();
+
 	// If a Tableau element actor is selected, deselect and select the parent Tableau Actor instead.
 	void MoveSelectionToTableauParent();
 
@@ -39,6 +59,10 @@ public:
 	// Change the Component's seed value and re-evaluate the latent tree.
 	void Reseed();
 
+	// Rebuild the Instances from the Component's recorded recipe without touching the transaction buffer.
+	// Used when undo or redo restores a recipe whose Instances were never recorded.
+	void RegenerateFromRecipe();
+
 	// Reset the Component's instances registry. This does not destroy the actors pointed to!
 	void ClearInstances();
 
@@ -60,17 +84,27 @@ public:
 	// Attach selected non-Tableau actors to the actor filter array.
 	void FilterBySelectedActors();
 
+	// Store the Static Meshes and Foliage currently expressed by the Tableau Actor in the Baked Recipe. Static
+	// Mesh Components of Instanced Actors are included, parented as the Instances are. Returns false if the
+	// Tableau Actor couldn't be baked.
+	bool BakeRecipe(UTableauBakedRecipe* BakedRecipe) const;
+
 	// Check that the Tableau is tracking its owned actors correctly and fix any errors.
 	void ValidateTracking();
 
-	// Assemble filters from Tableau Component configuration.
-	TSharedPtr<FTableauFilterSampler> GatherFilters(const UTableauComponent* TableauComponent) const;
+	// Assemble filters from Tableau Component configuration. If an evaluation context is provided, its
+	// exclusion volume filter and landscape weightmap caches are shared rather than built anew.
+	TSharedPtr<FTableauFilterSampler> GatherFilters(const UTableauComponent* TableauComponent, FTableauEvaluationContext* Context=nullptr) const;
 
 private:
+	// Record the arrays a regeneration adds Instances to and removes them from -- the Level's Actors and the
+	// Tableau Actor's components and attachments -- so that a regeneration whose Instances aren't recorded
+	// leaves the transaction buffer consistent with the Level.
+	void ModifyInstanceContainers();
+
 	void SpawnInstances(TArray<FTableauRecipeNode> &Recipe, bool bIsPreview);
-	void SpawnFoliage(TMap<UFoliageType*, TUniquePtr<FTableauFoliage>>& Foliages);
-	AActor* SpawnElement(ULevel* Level, const FTableauAssetElement& Element, int32 Seed, const FTransform& Space);
-	void SnapToFloor(const TArray<FTableauInstanceTracker>& Instances, const FVector& ParentTranslate);
+	AActor* SpawnElement(ULevel* Level, const UTableauAsset* TableauAsset, const FTableauAssetElement& Element, int32 Seed, const FTransform& Space);
+	void SnapToFloor(const TArray<FTableauInstanceTracker>& Instances);
 	
 	
 private:
@@ -0,0 +1,56 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class AActor;
+class ULevel;
+class UTableauAsset;
+class UTableauComponent;
+class UWorld;
+
+
+/*
+* FTableauDependencyIndex maps each Tableau Asset to the Tableau Components in editor Worlds whose expansion
+* depends on it, either directly or through the Tableaux nested within their own.
+*
+* The index is built lazily from the loaded Components, walking each Tableau's nested Tableaux once, and is kept
+* until something that may change the dependencies happens: Tableau Actors being added, levels being loaded,
+* a Component or Tableau Asset being edited, or undo and redo. Lookups following such a change rebuild it. Deleted
+* Tableau Actors are simply dropped from the index, and other Actors, such as the Instances spawned by a
+* regeneration, are ignored.
+*/
+class FTableauDependencyIndex
+{
+public:
+	FTableauDependencyIndex();
+	~FTableauDependencyIndex();
+
+	// Find the Components that must be regenerated when the Tableau changes.
+	void FindDependentComponents(const UTableauAsset* TableauAsset, TArray<UTableauComponent*>& OutComponents);
+
+	// Discard the index. It will be rebuilt by the next lookup.
+	void Invalidate();
+
+private:
+	void Rebuild();
+
+	// The Tableau and every Tableau nested within it, loading them as the evaluation would. Elements are checked
+	// against the asset registry, so that leaf assets are never loaded.
+	const TArray<FSoftObjectPath>& GatherNestedTableaux(const UTableauAsset* TableauAsset, TMap<FSoftObjectPath, TArray<FSoftObjectPath>>& NestedTableaux) const;
+
+	// delegate functions
+	void OnLevelActorAdded(AActor* Actor);
+	void OnLevelActorDeleted(AActor* Actor);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnMapChange(uint32 MapChangeFlags);
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	void OnPostUndoRedo();
+
+private:
+	bool bDirty;
+
+	// Components keyed by the path of each Tableau their expansion depends on.
+	TMap<FSoftObjectPath, TArray<TWeakObjectPtr<UTableauComponent>>> Dependents;
+};
@@ -63,6 +63,8 @@ private:
 	//Sets the editor's current tableau and refreshes various settings to correspond with the new data.
 	void SetEditorTableau(UTableauAsset* InTableau, bool bResetCamera = true);
 
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
 public:
 	static const FName ToolkitFName;
 
@@ -26,6 +26,10 @@ public:
 	// we made to Tableaux that contribute. Not that snapping will be reset.
 	static void RegenerateSelectedTableauActors();
 
+	// Regenerate the Instances over several frames, with progress reporting and the option to cancel.
+	// Intended for very large Tableaux that would otherwise block the editor.
+	static void RegenerateSelectedTableauActorsTimeSliced();
+
 	// Remove the Tableau Actor from the scene and place all Instances in the scene as ordinary
 	// actors.
 	static void UnpackSelectedTableauActors();
@@ -41,6 +45,10 @@ public:
 	// Attach all non-Tableau selected actors to Tableau as an Actor Filter.
 	static void FilterBySelectedActors();
 
+	// Bake the current output of each selected Tableau Actor into a new Baked Recipe asset, created
+	// alongside the Tableau Asset.
+	static void BakeSelectedTableauActors();
+
 private:
 	// Apply function to each selected Tableau Actor.
 	static void ApplyToAllSelectedTableau(void (*ApplyFunc)(ATableauActor*))
@@ -24,10 +24,12 @@ public:
 	TSharedPtr<FUICommandInfo> ReseedSelectedTableauActors;
 	TSharedPtr<FUICommandInfo> SnapTableauActorsToFloor;
 	TSharedPtr<FUICommandInfo> RegenerateSelectedTableauActors;
+	TSharedPtr<FUICommandInfo> RegenerateSelectedTableauActorsTimeSliced;
 	TSharedPtr<FUICommandInfo> UnpackSelectedTableauActors;
 	TSharedPtr<FUICommandInfo> UnpackOneLayer;
 	TSharedPtr<FUICommandInfo> UnpackForEditing;
 	TSharedPtr<FUICommandInfo> FilterBySelectedActors;
+	TSharedPtr<FUICommandInfo> BakeSelectedTableauActors;
 
 };
 
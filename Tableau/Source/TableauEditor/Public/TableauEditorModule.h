@@ -42,12 +42,16 @@
 #include "GameFramework/Actor.h"
 #include "AssetTypeCategories.h"
 #include "AssetTypeActions_Base.h"
+#include "EditorUndoClient.h"
 
 // Local Includes
 #include "TableauAsset.h"
 
 // Forward Declarations
 class ITableauEditor;
+class UTableauComponent;
+class FTableauDependencyIndex;
+class FTableauSourceWatcher;
 
 extern const FName TableauEditorAppIdentifier;
 
@@ -61,7 +65,7 @@ public:
 	virtual TSharedRef<ITableauEditor> CreateTableauEditor(const EToolkitMode::Type Mode, const TSharedPtr< IToolkitHost >& InitToolkitHost, UTableauAsset* TableauAsset) = 0;
 };
 
-class FTableauEditorModule : public ITableauEditorModule
+class FTableauEditorModule : public ITableauEditorModule, public FEditorUndoClient
 {
 public:
 
@@ -74,6 +78,11 @@ public:
 	virtual TSharedPtr<FExtensibilityManager> GetMenuExtensibilityManager() override;
 	//~ End IHasMenuExtensibility interface
 
+	//~ Begin FEditorUndoClient interface
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override;
+	//~ End FEditorUndoClient interface
+
 	// Creates a new tableau editor.
 	TSharedRef<ITableauEditor> CreateTableauEditor(const EToolkitMode::Type Mode, const TSharedPtr< IToolkitHost >& InitToolkitHost, UTableauAsset* TableauAsset);
 
@@ -98,6 +107,17 @@ protected:
 	void OnLevelSelectionChanged(UObject* Obj);
 	void OnLevelActorAdded(AActor* Actor);
 	void OnTableauActorDuplicate(AActor* Actor);
+	void OnTableauRecipeRestored(UTableauComponent* Component);
+	void OnActorMoved(AActor* Actor);
+	void OnLevelActorDeleted(AActor* Actor);
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+	void OnPackageSaved(const FString& PackageFileName, UObject* PackageObject);
+	void RegenerateSavedTableauDependents();
+	void OnRegenerationTaskFinished();
+
+	// Regenerate, as one batch, the placed Tableaux depending on any of the Tableau Assets.
+	void RegenerateDependents(const TArray<UTableauAsset*>& TableauAssets);
 
 private:
 	TSharedPtr<FExtensibilityManager> MenuExtensibilityManager;
@@ -106,5 +126,16 @@ private:
 	FDelegateHandle LevelViewportContextMenuTableauExtenderDelegateHandle;
 	TSharedPtr<FUICommandList> TableauCommands;
 
+	// Components awaiting regeneration following undo or redo.
+	TArray<TWeakObjectPtr<UTableauComponent>> PendingRecipeRestorations;
+
+	// Placed Tableaux keyed by the Tableau Assets their expansion depends on.
+	TUniquePtr<FTableauDependencyIndex> DependencyIndex;
+
+	// Tableau Assets saved since their dependents were last regenerated.
+	TArray<TWeakObjectPtr<UTableauAsset>> PendingSavedTableaux;
+
+	// Reimports Tableau Assets whose sources are written, when enabled.
+	TUniquePtr<FTableauSourceWatcher> SourceWatcher;
 	
 };
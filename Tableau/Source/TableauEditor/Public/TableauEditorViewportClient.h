@@ -17,6 +17,10 @@ class FTableauEditorViewportClient : public FEditorViewportClient, public TShare
 public:
 	FTableauEditorViewportClient(TWeakPtr<ITableauEditor> InTableauEditor, const TSharedRef<STableauEditorViewport>& InTableauEditorViewport, const TSharedRef<FAdvancedPreviewScene>& InPreviewScene);
 
+	// FEditorViewportClient interface
+	virtual void ProcessClick(FSceneView& View, HHitProxy* HitProxy, FKey Key, EInputEvent Event, uint32 HitX, uint32 HitY) override;
+	// End of FEditorViewportClient interface
+
 private:
 
 	// Pointer back to the Tableau editor tool that owns us */
@@ -0,0 +1,59 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UWorld;
+class AActor;
+class ULandscapeComponent;
+
+
+/*
+* FTableauFloorSampler snaps transforms to the floor for bulk snapping operations. It produces the same
+* result as FTableauUtils::TraceToWorld but, where the only thing beneath a point is a landscape, reads the
+* landscape heightfield directly instead of tracing.
+*
+* On construction the sampler gathers the geometry in the snapping region with a single overlap query. It caches the
+* world space vertices of the landscape components found there, and indexes the bounds of all other geometry that
+* would block a floor trace, including the landscape's own spline meshes. Landscape components with holes painted
+* are treated as other geometry. Points overlapped by indexed geometry, or lying outside the cached landscape, fall
+* back to a physics trace.
+*
+* The sampler is read only once constructed, so it may be used from parallel tasks.
+*/
+class TABLEAUEDITOR_API FTableauFloorSampler
+{
+public:
+	FTableauFloorSampler(const UWorld* InWorld, const FBox& InRegion, AActor* InIgnoredActor = nullptr);
+
+	// Snap the transform to the floor. Returns false if no acceptable floor was found.
+	bool SnapToFloor(FTransform& Xform, const FFloatInterval& GroundSlopeAngle, bool bAlignToNormal) const;
+
+private:
+	struct FHeightfield
+	{
+		FTransform ComponentTransform;
+		int32 ComponentSizeQuads;
+		TArray<FVector> WorldVertices;
+	};
+
+	void CacheHeightfield(ULandscapeComponent* LandscapeComponent);
+	void IndexBounds(const FBox& Bounds, TMap<FIntPoint, TArray<int32>>& Grid, int32 Index) const;
+
+	// Is there geometry other than landscape that a trace through the location might hit?
+	bool IsObstructed(const FVector& Location) const;
+
+	// Sample the cached landscape height and normal beneath the location.
+	bool SampleLandscape(const FVector& Location, FVector& OutFloorLocation, FVector& OutFloorNormal) const;
+
+private:
+	const UWorld* World;
+	AActor* IgnoredActor;
+
+	TArray<FHeightfield> Heightfields;
+	TMap<FIntPoint, TArray<int32>> HeightfieldGrid;
+
+	TArray<FBox> ObstructionBounds;
+	TMap<FIntPoint, TArray<int32>> ObstructionGrid;
+};
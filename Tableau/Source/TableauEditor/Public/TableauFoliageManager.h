@@ -0,0 +1,53 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Editor.h"
+
+// Local Includes
+#include "TableauEditorModule.h"
+#include "TableauActor.h"
+#include "TableauHISMComponent.h"
+#include "TableauFoliage.h"
+
+// Forward Declares
+class UFoliageType;
+class AInstancedFoliageActor;
+class FTableauFloorSampler;
+
+class FTableauFoliageManager
+{
+public:
+	FTableauFoliageManager(ATableauActor* InActor);
+
+	// Destroy Foliage Components attached to the actor, and release any shared foliage.
+	void DestroyFoliageComponents();
+
+	// Trace all Foliage instances to floor
+	void SnapToFloor(const UWorld* InWorld);
+
+	// The sampler must be constructed after WithdrawSharedFoliage, so that it can't find the instances being snapped.
+	void SnapToFloor(const FTableauFloorSampler& FloorSampler);
+
+	// Remove the Actor's shared foliage from the shared HISMs until it's next updated, so that snapping doesn't hit
+	// the very instances it's snapping.
+	void WithdrawSharedFoliage();
+
+	// World space bounds of the locations of the Actor's shared foliage instances.
+	FBox GetSharedFoliageBounds() const;
+
+	// How do we extract foliage? I don't know yet.
+	void ExtractFoliage(UWorld* InWorld);
+
+private:
+	void SnapInstancesToFloor(UTableauHISMComponent* Component, const FTableauFloorSampler& FloorSampler);
+
+	// Snap world space transforms in parallel batches, removing those that found no acceptable floor.
+	static void SnapTransformsToFloor(TArray<FTransform>& WorldTransforms, const FTableauFloorSampler& FloorSampler, const FFloatInterval& GroundSlopeAngle, bool bAlignToNormal);
+
+	// Add world space transforms to the Instanced Foliage Actor as instances of the Foliage Type in a single batch.
+	static void AddInstancesToFoliageActor(AInstancedFoliageActor* FoliageActor, UFoliageType* FoliageType, const TArray<FTransform>& WorldTransforms);
+
+private:
+	TWeakObjectPtr<ATableauActor> TableauActor;
+};
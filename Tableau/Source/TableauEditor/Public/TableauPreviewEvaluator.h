@@ -0,0 +1,93 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+// Forward Declares
+class UStaticMesh;
+class UFoliageType;
+class UTableauAsset;
+class UWorld;
+class FTableauEvaluationContext;
+class FTableauLatentTree;
+
+
+/*
+* The instances expressing one evaluation of a Tableau Asset in the asset editor, relative to the Tableau.
+*/
+struct FTableauPreviewResult
+{
+	// Static Mesh instances, keyed also by the Foliage Type the mesh was taken from.
+	TMap<TPair<UStaticMesh*, UFoliageType*>, TArray<FTransform>> InstanceTransforms;
+
+	// Assets that can't be instanced, previewed with a component each.
+	TArray<TPair<UObject*, FTransform>> Assets;
+
+	// Bounds of the Static Mesh instances.
+	FBox Bounds = FBox(ForceInit);
+};
+
+/*
+* FTableauPreviewEvaluator evaluates a Tableau Asset for the asset editor preview on worker threads, so that
+* seeds may be scrubbed without hitches.
+*
+* The assets reachable from the Tableau are loaded once into an Evaluation Context when the Tableau is set.
+* Each requested seed is then evaluated on the thread pool and its instances gathered there. Completed results
+* are kept in a least recently used cache, so that returning to a seed is immediate.
+*
+* Evaluations read the elements of the Tableaux in place, so any Tableau about to be edited waits for the
+* evaluations in flight to complete. Editing the Tableau, or one nested within it, discards the cache.
+*/
+class FTableauPreviewEvaluator
+{
+public:
+	FTableauPreviewEvaluator(UWorld* InWorld);
+	~FTableauPreviewEvaluator();
+
+	// Evaluate a new Tableau, or the same Tableau following an edit.
+	void SetTableau(UTableauAsset* InTableau);
+
+	// Does the evaluation reach the Tableau, either as the evaluated Tableau or nested within it?
+	bool DependsOn(const UTableauAsset* InTableau) const;
+
+	// Find the result for the Seed if its evaluation has completed, marking it most recently used.
+	TSharedPtr<const FTableauPreviewResult> FindResult(int32 Seed);
+
+	// Evaluate the Seed on a worker thread unless it's cached or in flight. Requests beyond the number of
+	// evaluations allowed in flight are dropped; returns false if this one was.
+	bool RequestEvaluation(int32 Seed);
+
+	// Move completed evaluations into the cache. Must be called on the game thread.
+	void Tick();
+
+private:
+	struct FEvaluation
+	{
+		int32 Seed = 0;
+		TSharedPtr<FTableauLatentTree> LatentTree;
+		TSharedPtr<FTableauPreviewResult> Result;
+		TFuture<void> Future;
+
+		// Set when the Tableau was edited while the evaluation was in flight. Its result is discarded.
+		bool bAbandoned = false;
+	};
+
+	static void GatherResult(const FTableauLatentTree& LatentTree, FTableauPreviewResult& Result);
+
+	void OnTableauElementsChanging(const UTableauAsset* ChangingTableau);
+
+private:
+	UWorld* World;
+
+	UTableauAsset* Tableau;
+
+	TSharedPtr<FTableauEvaluationContext> Context;
+
+	// The latent trees are owned here until their task completes, so that the Evaluation Context is always
+	// destroyed on the game thread.
+	TArray<FEvaluation> Evaluations;
+
+	// Completed results, most recently used last.
+	TArray<TPair<int32, TSharedPtr<const FTableauPreviewResult>>> Cache;
+};
@@ -49,10 +49,62 @@
 }
 
 *	containing as many elements as required. Valid EvaluationModes are "Composition", "Superposition", or "HierarchicalComposition". AssetReference should
-*   provide a path to an existing content browser asset. Orient is a quaternion.
+*   provide a path to an existing content browser asset. Orient is a quaternion. An element may also provide an "Id" that
+*   stays the same across exports, allowing reimport to match elements whose Name changed.
+*
+*   Reimport is incremental: existing elements imported with an Id are matched with the incoming elements by Id, and those
+*   imported without one are matched by Name, adopting the incoming element's Id if it has one.
+*   Matched elements only have their Name, AssetReference and transform updated, keeping any properties set in the editor;
+*   unmatched existing elements are removed and unmatched incoming elements are appended. The differences are reported
+*   through UTableauReimportProceduralFactory::OnTableauReimported, and an unchanged source leaves the asset untouched.
+*
+*   TAB files may be very large, so they are never held as a string or a single JSON document. The file is memory mapped and
+*   scanned once for the extent of each object in the Elements array; the elements are then parsed in parallel and added to
+*   the asset in bulk.
+*
+*   The TABB file (extension is '.tabb') is a compact little endian binary equivalent, also memory mapped:
+*
+*		uint32 Magic ('TABB'), uint32 Version (2), uint32 EvaluationMode, uint32 StringCount, uint32 ElementCount
+*		StringCount strings, each a uint32 byte length followed by that many bytes of UTF-8
+*		ElementCount records, each uint32 Name and uint32 AssetReference string indices followed by
+*		float Translate[3], float Orient[4], float Scale[3] and a uint32 Id string index (0xFFFFFFFF for none)
+*
+*   Version 1 records end before the Id, so their elements are matched by Name on reimport.
+*
+*   Names and asset paths are shared through the string table, so each is only converted once however many elements use it.
 **/
 
 
+/*
+* The contents of a TAB or TABB file, read before the Tableau Asset is touched so that a failed reimport
+* leaves the asset as it was.
+*/
+struct FTableauSourceContents
+{
+	ETableauEvaluationMode::Type EvaluationMode = ETableauEvaluationMode::Type::Composition;
+	TArray<FTableauAssetElement> Elements;
+};
+/*
+* The changes a reimport made to a Tableau Asset. Element indices refer to the reimported asset.
+*/
+struct FTableauReimportDiff
+{
+	TArray<int32> AddedElements;
+
+	// Elements whose Name, AssetReference or transform changed.
+	TArray<int32> ModifiedElements;
+
+	// Keys (Id, or Name) of the elements removed.
+	TArray<FName> RemovedElements;
+
+	bool bEvaluationModeChanged = false;
+
+	bool HasChanges() const
+	{
+		return AddedElements.Num() > 0 || ModifiedElements.Num() > 0 || RemovedElements.Num() > 0 || bEvaluationModeChanged;
+	}
+};
+
 UCLASS()
 class TABLEAUEDITOR_API UTableauProceduralFactory : public UFactory
 {
@@ -78,8 +130,22 @@ public:
 	//~ End UFactory interface
 
 	void PopulateTableauAssetFromSource(UTableauAsset* TableauAsset, const TSharedPtr<FJsonObject>& JsonObject) const;
+	void PopulateTableauAssetFromSource(UTableauAsset* TableauAsset, FTableauSourceContents&& SourceContents) const;
+
+	// Read the TAB or TABB file named by CurrentFilename. Returns false if it can't be read or is malformed.
+	// Touches no UObjects, so it may be called from a worker thread.
+	bool ReadSourceFile(FTableauSourceContents& OutContents) const;
+
+	void SetCurrentFilename(const FString& InFilename)
+	{
+		CurrentFilename = InFilename;
+	}
 
 private:
+	bool ReadJsonSource(const uint8* Data, int64 Size, FTableauSourceContents& OutContents) const;
+	bool ReadBinarySource(const uint8* Data, int64 Size, FTableauSourceContents& OutContents) const;
+	bool FindJsonElements(const ANSICHAR* Data, int64 Size, FString& OutEvaluationMode, TArray<TPair<int64, int64>>& OutElementRanges) const;
+	ETableauEvaluationMode::Type EvaluationModeFromString(const FString& Mode) const;
 	ETableauEvaluationMode::Type ExtractEvaluationModeFromJsonObject(const TSharedPtr<FJsonObject>& JsonObject) const;
 	bool ExtractTableauElementFromJsonObject(const TSharedPtr<FJsonObject>& JsonObject, FTableauAssetElement& ExtractedElement) const;
 	bool JsonObjectHasField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName) const;
@@ -108,4 +174,17 @@ public:
 	virtual EReimportResult::Type Reimport(UObject* Obj) override;
 	//~ End FReimportHandler interface
 
+	// Fired after a reimport with the changes it made, which may be none.
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnTableauReimportedDelegate, UTableauAsset*, const FTableauReimportDiff&);
+	static FOnTableauReimportedDelegate OnTableauReimported;
+
+	// Apply source contents read from CurrentFilename to the asset, broadcasting the changes made.
+	FTableauReimportDiff ApplyReimport(UTableauAsset* TableauAsset, FTableauSourceContents&& SourceContents);
+
+private:
+	// Apply only the differences between the source and the asset. Returns the changes made.
+	FTableauReimportDiff ApplySourceDiff(UTableauAsset* TableauAsset, FTableauSourceContents&& SourceContents) const;
+
+	static FName GetElementKey(const FTableauAssetElement& Element);
+
 };
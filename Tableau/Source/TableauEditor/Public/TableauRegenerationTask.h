@@ -0,0 +1,96 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+
+// Local Includes
+#include "TableauActor.h"
+#include "TableauLatentTree.h"
+
+// Forward Declares
+class SNotificationItem;
+class FTableauEvaluationContext;
+class UTableauAsset;
+
+/*
+* FTableauRegenerationTask regenerates a set of Tableau Actors across several editor frames. Each Actor's latent tree
+* is evaluated on the thread pool while the editor keeps ticking, then a budgeted number of Recipe nodes is spawned on
+* each tick of the core ticker. Tableaux filtered by the scene are evaluated on the game thread, since their filters
+* may not run elsewhere. Progress is reported through a pending notification that carries a Cancel button.
+*
+* Each tick's work is recorded as a transaction of its own, opened and closed within the tick, so that edits the
+* user makes while the task runs are never gathered into it. Cancelling rolls back the task's transactions, most
+* recent first, for as long as they're the latest in the undo history; if the user has made an edit since, the
+* earlier slices are left in place to be undone by hand rather than undoing the user's edit with them.
+*
+* Only one task may run at a time.
+*/
+class TABLEAUEDITOR_API FTableauRegenerationTask : public TSharedFromThis<FTableauRegenerationTask>
+{
+public:
+	FTableauRegenerationTask(const TArray<ATableauActor*>& InTableauActors, int32 InNodesPerFrame);
+	~FTableauRegenerationTask();
+
+	// Start a time sliced regeneration of the provided Actors. Returns nullptr if a task is already running.
+	static TSharedPtr<FTableauRegenerationTask> Launch(const TArray<ATableauActor*>& InTableauActors);
+
+	// Is a time sliced regeneration currently in progress?
+	static bool IsTaskRunning();
+
+	// Stop spawning and roll back everything done so far.
+	void Cancel();
+
+	// Fired once the running task has finished or been cancelled.
+	DECLARE_MULTICAST_DELEGATE(FOnTaskFinishedDelegate);
+	static FOnTaskFinishedDelegate OnTaskFinished;
+
+private:
+	bool Start();
+	bool Tick(float DeltaTime);
+
+	// Spawn the next budget of nodes. Returns false when every Actor has been regenerated.
+	bool SpawnSlice();
+
+	void BeginSlice();
+	void EndSlice();
+
+	// Start evaluating the latent tree of the next Actor in the queue. Returns false when the queue is exhausted.
+	bool BeginNextActor();
+	void FinishCurrentActor();
+
+	// Is the current Actor's latent tree still being evaluated?
+	bool IsEvaluating() const;
+
+	// Let the evaluation in flight finish before a Tableau it may be reading is edited.
+	void OnTableauElementsChanging(const UTableauAsset* ChangingTableau);
+
+	void Finish(bool bCancelled);
+	void UpdateNotification();
+
+private:
+	TArray<TWeakObjectPtr<ATableauActor>> TableauActors;
+
+	// Actor currently being spawned and its evaluated Recipe. The context keeps the assets the evaluation reads
+	// loaded until it completes.
+	int32 CurrentActorIndex;
+	TSharedPtr<FTableauEvaluationContext> CurrentContext;
+	TUniquePtr<FTableauLatentTree> CurrentLatentTree;
+	TFuture<void> CurrentEvaluation;
+	int32 CurrentNodeIndex;
+
+	int32 NodesPerFrame;
+	int32 NodesSpawned;
+	int32 NodesTotal;
+
+	int32 TransactionIndex;
+
+	// Transactions recorded by the task, oldest first.
+	TArray<FGuid> SliceTransactions;
+	FDelegateHandle TickerHandle;
+	TWeakPtr<SNotificationItem> Notification;
+
+	// The running task keeps itself alive until it finishes or is cancelled.
+	static TSharedPtr<FTableauRegenerationTask> ActiveTask;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "IDirectoryWatcher.h"
+#include "UObject/StrongObjectPtr.h"
+
+// Local Includes
+#include "TableauProceduralFactory.h"
+
+// Forward Declares
+class UTableauAsset;
+
+
+/*
+* FTableauSourceWatcher reimports Tableau Assets automatically when the TAB or TABB files they were imported from
+* are written. It is opt-in, enabled with Tableau.AutoReimport.
+*
+* The directories holding the sources of the loaded Tableau Assets are watched, and the list is refreshed
+* periodically as assets are loaded and imported. Writes to a source are coalesced until it has been left alone
+* for Tableau.AutoReimportDelay seconds, since a source is typically written in bursts. The file is then read and
+* parsed on a worker thread; only applying the contents to the assets happens on the game thread. The assets
+* reimported on the same tick that changed are reported together, so that their placed Tableaux may be
+* regenerated as one batch.
+*/
+class FTableauSourceWatcher
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnSourcesReimported, const TArray<UTableauAsset*>&);
+
+	FTableauSourceWatcher(const FOnSourcesReimported& InOnSourcesReimported);
+	~FTableauSourceWatcher();
+
+private:
+	bool Tick(float DeltaTime);
+
+	// Watch the directories of the loaded Tableau Assets' sources, and stop watching those no longer needed.
+	void RefreshWatches();
+	void StopWatching();
+
+	void OnDirectoryChanged(const TArray<FFileChangeData>& FileChanges);
+
+	// Read the sources that have settled on worker threads.
+	void StartSourceReads();
+
+	// Apply the sources that have been read to their assets.
+	void FinishSourceReads();
+
+	static FString NormalizeSourceFilename(const FString& Filename);
+
+private:
+	struct FSourceRead
+	{
+		FString Filename;
+		TStrongObjectPtr<UTableauReimportProceduralFactory> Factory;
+		TSharedPtr<FTableauSourceContents> Contents;
+		TFuture<bool> Future;
+	};
+
+	FOnSourcesReimported OnSourcesReimported;
+
+	FDelegateHandle TickerHandle;
+
+	float TimeSinceRefresh;
+
+	TMap<FString, FDelegateHandle> WatchedDirectories;
+
+	// Loaded Tableau Assets keyed by their normalized source filename.
+	TMap<FString, TArray<TWeakObjectPtr<UTableauAsset>>> WatchedSources;
+
+	// Sources written since they were last read, with the time of the most recent write.
+	TMap<FString, double> PendingSources;
+
+	TArray<FSourceRead> SourceReads;
+};
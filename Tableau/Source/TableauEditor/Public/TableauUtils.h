@@ -15,6 +15,12 @@
 * Helper classes for Tableau in the Unreal Editor
 */
 
+namespace TableauSnapConstants
+{
+	// We bracket our floor traces by +- 10m.
+	const float SnapToFloorBound = 1000.0f;
+}
+
 
 /*
 * Static utility functions 
@@ -27,8 +33,17 @@ struct TABLEAUEDITOR_API FTableauUtils
 	static ATableauActor* GetFirstTableauParentActor(AActor* InActor);
 
 	// Spawn Actors into the current map using Recipe instructions.
-	static TArray<TWeakObjectPtr<AActor>> SpawnInstances(ATableauActor* OwningActor, const FTransform& TableauSpace, const TArray<FTableauRecipeNode>& Recipe, UTableauComponent* TableauComponent, FTableauInstanceTracker* CurrTracker, bool bIsPreview = false);
+	static TArray<TWeakObjectPtr<AActor>> SpawnInstances(ATableauActor* OwningActor, const FTransform& TableauSpace, const TArray<FTableauRecipeNode>& Recipe, UTableauComponent* TableauComponent, int32 ParentInstance = INDEX_NONE, bool bIsPreview = false);
+
+	// Spawn the Actor (and any subordinate Actors) described by a single Recipe node.
+	static TArray<TWeakObjectPtr<AActor>> SpawnInstance(ATableauActor* OwningActor, const FTransform& TableauSpace, const FTableauRecipeNode& RecipeNode, UTableauComponent* TableauComponent, int32 ParentInstance = INDEX_NONE, bool bIsPreview = false);
+
+	// Count the nodes in a Recipe subtree, including the node itself.
+	static int32 CountRecipeNodes(const FTableauRecipeNode& RecipeNode);
 	
+	// Spawn a single actor from a config captured in the Tableau Asset, in whichever format it was stored.
+	static AActor* SpawnConfiguredActor(UWorld* InWorld, const UTableauAsset* TableauAsset, int32 ConfigIndex, const FTransform& Xform, const FName& Name);
+
 	// Spawn a single actor using captured clipboard data.
 	static AActor* PasteActor(UWorld* InWorld, const FString& Config, const FTransform& Xform, const FName& Name);
 
@@ -50,8 +65,10 @@ struct TABLEAUEDITOR_API FTableauUtils
 	static AActor* ReplaceActorsWithTableau(UTableauAsset* TableauAsset, const TArray<AActor*>& SelectedActors);
 
 	// Fill Tablea Asset's element list using selected actors.
+	// The actors' configs are captured in one batch, without changing the selection.
 	static void FillTableauAssetElements(UTableauAsset* InAsset, const TArray<AActor*>& SelectedActors);
 
+	// Capture an actor as clipboard text. Selects the actor to do so.
 	static void StoreActorAsString(UWorld* InWorld, AActor* InActor, FString* DestinationData);
 
 	// Modify transform to reflect random rotation and scaling around origin.
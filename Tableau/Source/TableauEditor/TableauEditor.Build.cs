@@ -68,6 +68,7 @@ public class TableauEditor : ModuleRules
 					"Json",
 					"Landscape",
 					"AdvancedPreviewScene",
+					"DirectoryWatcher",
 					"RHI"
                 }
             );